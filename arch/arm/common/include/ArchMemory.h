@@ -31,8 +31,9 @@ public:
  * Privilege Mechanism
  * @param page_size Optional, defaults to 4k pages, but you ned to set it to
  * 1024*4096 if you want to map a 4m page
+ * @param writeable Optional, defaults to a writeable page, 0 maps the page read-only
  */
-  void mapPage(uint32 virtual_page, uint32 physical_page, uint32 user_access, uint32 page_size=PAGE_SIZE);
+  void mapPage(uint32 virtual_page, uint32 physical_page, uint32 user_access, uint32 page_size=PAGE_SIZE, uint32 writeable=1);
 
 /**
  * removes the mapping to a virtual_page by marking its PTE Entry as non valid
@@ -69,6 +70,14 @@ public:
  */
   pointer checkAddressValid(uint32 vaddress_to_check);
 
+/**
+ * Reads and clears the dirty bit of a 4k page, the bit is set by the cpu on a write to the page
+ * @param virtual_page Virtual Page to check
+ * @return true if the page was written to since the bit was cleared last,
+ * always true for a mapped page as the page tables have no dirty bit
+ */
+  bool testAndClearDirty(uint32 virtual_page);
+
 /**
  * Takes a virtual_page and search through the pageTable and pageDirectory for the
  * physical_page it refers to
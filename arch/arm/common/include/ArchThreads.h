@@ -77,6 +77,12 @@ public:
  */
   static void createUserRegisters(ArchThreadRegisters *&info, void* start_function, void* user_stack, void* kernel_stack);
 
+/**
+ * frees the ArchThreadRegisters created by createKernelRegisters or createUserRegisters
+ * @param info the ArchThreadRegisters, set to 0 afterwards
+ */
+  static void deleteThreadRegisters(ArchThreadRegisters *&info);
+
 /**
  *
  * on x86: invokes int65, whose handler facilitates a task switch
@@ -12,6 +12,7 @@
 #include "FrameBufferConsole.h"
 #include "backtrace.h"
 #include "Stabs2DebugInfo.h"
+#include "Scheduler.h"
 
 #define PHYSICAL_MEMORY_AVAILABLE 8*1024*1024
 
@@ -120,6 +121,11 @@ void ArchCommon::idle()
   halt();
 }
 
+uint64 ArchCommon::getTimestamp()
+{
+  return Scheduler::instance()->getTicks();
+}
+
 
 extern "C" void __aeabi_atexit()
 {
@@ -73,6 +73,7 @@ void ArchMemory::unmapPage(uint32 virtual_page)
       pte_base[pte_vpn].size = 0;
       PageManager::instance()->freePPN(pte_base[pte_vpn].page_ppn - PHYS_OFFSET_4K);
       ((uint32*)pte_base)[pte_vpn] = 0; // for easier debugging
+      asm volatile ("mcr p15, 0, %[v], c8, c7, 1\n" : : [v]"r"(virtual_page * PAGE_SIZE)); // tlb flush of the page
     }
     checkAndRemovePT(pde_vpn);
   }
@@ -102,7 +103,8 @@ void ArchMemory::insertPT(uint32 pde_vpn)
   page_directory[pde_vpn].pt.size = PDE_SIZE_PT;
 }
 
-void ArchMemory::mapPage(uint32 virtual_page, uint32 physical_page, uint32 user_access, uint32 page_size)
+void ArchMemory::mapPage(uint32 virtual_page, uint32 physical_page, uint32 user_access, uint32 page_size,
+                         uint32 writeable)
 {
 //  kprintfd("ArchMemory::mapPage: v: %x to p: %x\n",virtual_page,physical_page);
   PageDirEntry *page_directory = (PageDirEntry *) getIdentAddressOfPPN(page_dir_page_);
@@ -117,7 +119,7 @@ void ArchMemory::mapPage(uint32 virtual_page, uint32 physical_page, uint32 user_
     PageTableEntry *pte_base = ((PageTableEntry *) getIdentAddressOfPPN(page_directory[pde_vpn].pt.pt_ppn - PHYS_OFFSET_4K)) + page_directory[pde_vpn].pt.offset * PAGE_TABLE_ENTRIES;
     pte_base[pte_vpn].bufferable = 0;
     pte_base[pte_vpn].cachable = 0;
-    pte_base[pte_vpn].permissions = user_access ? 3 : 1;
+    pte_base[pte_vpn].permissions = user_access ? (writeable ? 3 : 2) : 1;
     pte_base[pte_vpn].reserved = 0;
     pte_base[pte_vpn].page_ppn = physical_page + PHYS_OFFSET_4K;
     pte_base[pte_vpn].size = 2;
@@ -178,6 +180,11 @@ pointer ArchMemory::checkAddressValid(uint32 vaddress_to_check)
   return 0;
 }
 
+bool ArchMemory::testAndClearDirty(uint32 virtual_page)
+{
+  return checkAddressValid(virtual_page * PAGE_SIZE) != 0;
+}
+
 uint32 ArchMemory::get_PPN_Of_VPN_In_KernelMapping(uint32 virtual_page, uint32 *physical_page,
                                                    uint32 *physical_pte_page)
 {
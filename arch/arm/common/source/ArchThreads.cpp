@@ -76,6 +76,12 @@ void ArchThreads::createUserRegisters(ArchThreadRegisters *&info, void* start_fu
   assert(((pageDirectory) & 0x3FFF) == 0);
 }
 
+void ArchThreads::deleteThreadRegisters(ArchThreadRegisters *&info)
+{
+  delete[] (uint8*)info;
+  info = 0;
+}
+
 void ArchThreads::yield()
 {
   asm("swi #0xffff");
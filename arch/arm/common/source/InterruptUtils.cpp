@@ -66,6 +66,8 @@ void pageFaultHandler(uint32 address, uint32 type)
 
   ArchThreads::printThreadRegisters(currentThread,false);
 
+  ++currentThread->usage_.page_faults;
+
   //save previous state on stack of currentThread
   uint32 saved_switch_to_userspace = currentThread->switch_to_userspace_;
   currentThread->switch_to_userspace_ = 0;
@@ -123,6 +123,9 @@ uint32 MMCDriver::addRequest( BDRequest * br)
     case BDRequest::BD_WRITE:
       res = writeSector( br->getStartBlock(), br->getNumBlocks(), br->getBuffer() );
       break;
+    case BDRequest::BD_FLUSH:
+      res = 0; // writes are not cached
+      break;
     default:
       res = -1;
       break;
@@ -90,5 +90,12 @@ class ArchCommon
      * draw a heartbeat character
      */
     static void drawHeartBeat();
+
+    /**
+     * a monotonic timestamp for tracing and profiling,
+     * the time stamp counter on x86, the timer ticks elsewhere
+     * @return the timestamp
+     */
+    static uint64 getTimestamp();
 };
 
@@ -43,6 +43,7 @@ class BDRequest
     {
       BD_READ            = 0x00,
       BD_WRITE           = 0x10,
+      BD_FLUSH           = 0x11,
       BD_GET_NUM_DEVICES = 0x20,
       BD_GET_BLK_SIZE    = 0x21,
       BD_GET_NUM_BLOCKS  = 0x22,
@@ -31,7 +31,7 @@ struct ArchThreadRegisters
   uint32  esp0;      // 68
   uint32  ss0;       // 72
   uint32  cr3;       // 76
-  uint32  fpu[27];   // 80
+  uint8*  fpu;       // 80 lazily switched fpu/sse state, see ArchFpu
 };
 
 class Thread;
@@ -85,6 +85,12 @@ public:
  */
   static void createUserRegisters(ArchThreadRegisters *&info, void* start_function, void* user_stack, void* kernel_stack);
 
+/**
+ * frees the ArchThreadRegisters created by createKernelRegisters or createUserRegisters
+ * @param info the ArchThreadRegisters, set to 0 afterwards
+ */
+  static void deleteThreadRegisters(ArchThreadRegisters *&info);
+
 /**
  *
  * on x86: invokes int65, whose handler facilitates a task switch
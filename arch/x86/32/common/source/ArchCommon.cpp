@@ -225,6 +225,13 @@ void ArchCommon::idle()
   asm volatile("hlt");
 }
 
+uint64 ArchCommon::getTimestamp()
+{
+  uint32 low, high;
+  asm volatile("rdtsc" : "=a"(low), "=d"(high));
+  return ((uint64) high << 32) | low;
+}
+
 void ArchCommon::drawHeartBeat()
 {
   const char* clock = "/-\\|";
@@ -9,6 +9,7 @@
 #include "InterruptUtils.h"
 #include "SegmentUtils.h"
 #include "ArchThreads.h"
+#include "ArchFpu.h"
 #include "assert.h"
 #include "Thread.h"
 
@@ -123,10 +124,6 @@ extern "C" void arch_saveThreadRegisters(uint32 error)
   register struct interrupt_registers* iregisters;
   iregisters = (struct interrupt_registers*) (&error + 2 + sizeof(struct context_switch_registers)/sizeof(uint32) + (error));
   register ArchThreadRegisters* info = currentThreadRegisters;
-  asm("fnsave (%[fpu])\n"
-      "frstor (%[fpu])\n"
-      :
-      : [fpu]"r"(&info->fpu));
   if ((iregisters->cs & 0x3) == 0x3)
   {
     info->ss = iregisters->ss3;
@@ -157,6 +154,7 @@ extern "C" void arch_contextSwitch()
 {
   assert(currentThread->isStackCanaryOK() && "Kernel stack corruption detected.");
   ArchThreadRegisters info = *currentThreadRegisters; // optimization: local copy produces more efficient code in this case
+  ArchFpu::contextSwitch(currentThread->kernel_registers_->fpu);
   if (currentThread->switch_to_userspace_)
   {
     assert(currentThread->holding_lock_list_ == 0 && "Never switch to userspace when holding a lock! Never!");
@@ -169,7 +167,6 @@ extern "C" void arch_contextSwitch()
     asm("mov %[esp], %%esp\n" : : [esp]"m"(info.esp));
   }
   g_tss->esp0 = info.esp0;
-  asm("frstor (%[fpu])\n" : : [fpu]"r"(&info.fpu));
   asm("mov %[cr3], %%cr3\n" : : [cr3]"r"(info.cr3));
   asm("push %[eflags]\n" : : [eflags]"m"(info.eflags));
   asm("push %[cs]\n" : : [cs]"m"(info.cs));
@@ -1,5 +1,6 @@
 #include "ArchThreads.h"
 #include "ArchMemory.h"
+#include "ArchFpu.h"
 #include "Loader.h"
 #include "kprintf.h"
 #include "paging-definitions.h"
@@ -12,6 +13,7 @@
 void ArchThreads::initialise()
 {
   currentThreadRegisters = (ArchThreadRegisters*) new uint8[sizeof(ArchThreadRegisters)];
+  ArchFpu::initialise();
 }
 
 void ArchThreads::setAddressSpace(Thread *thread, ArchMemory& arch_memory)
@@ -32,15 +34,6 @@ void ArchThreads::createBaseThreadRegisters(ArchThreadRegisters *&info, void* st
   info->eflags  = 0x200;
   info->eip     = (size_t)start_function;
   info->cr3     = root_of_kernel_paging_structure;
-
-  /* fpu (=fninit) */
-  info->fpu[0] = 0xFFFF037F;
-  info->fpu[1] = 0xFFFF0000;
-  info->fpu[2] = 0xFFFFFFFF;
-  info->fpu[3] = 0x00000000;
-  info->fpu[4] = 0x00000000;
-  info->fpu[5] = 0x00000000;
-  info->fpu[6] = 0xFFFF0000;
 }
 
 void ArchThreads::createKernelRegisters(ArchThreadRegisters *&info, void* start_function, void* stack)
@@ -52,6 +45,7 @@ void ArchThreads::createKernelRegisters(ArchThreadRegisters *&info, void* start_
   info->es      = KERNEL_DS;
   info->ss      = KERNEL_SS;
   info->dpl     = DPL_KERNEL;
+  info->fpu     = ArchFpu::createState();
 }
 
 void ArchThreads::createUserRegisters(ArchThreadRegisters *&info, void* start_function, void* user_stack, void* kernel_stack)
@@ -67,6 +61,14 @@ void ArchThreads::createUserRegisters(ArchThreadRegisters *&info, void* start_fu
   info->esp0    = (size_t)kernel_stack;
 }
 
+void ArchThreads::deleteThreadRegisters(ArchThreadRegisters *&info)
+{
+  if (info)
+    ArchFpu::deleteState(info->fpu);
+  delete[] (uint8*)info;
+  info = 0;
+}
+
 void ArchThreads::changeInstructionPointer(ArchThreadRegisters *info, void* function)
 {
   info->eip = (size_t)function;
@@ -4,6 +4,8 @@
 #include "BDManager.h"
 #include "ArchMemory.h"
 #include "ArchThreads.h"
+#include "ArchFpu.h"
+#include "Profiler.h"
 #include "ArchCommon.h"
 #include "kprintf.h"
 #include "Scheduler.h"
@@ -143,6 +145,8 @@ extern "C" void irqHandler_0()
 
   Scheduler::instance()->incTicks();
 
+  Profiler::timerTick(currentThreadRegisters->eip);
+
   Scheduler::instance()->schedule();
   // kprintfd("irq0: Going to leave irq Handler 0\n");
   ArchInterrupts::EndOfInterrupt(0);
@@ -257,6 +261,7 @@ extern "C" void pageFaultHandler(uint32 address, uint32 error)
 {
 
   printPageFaultInfo(address, error);
+  ++currentThread->usage_.page_faults;
 
   //save previous state on stack of currentThread
   uint32 saved_switch_to_userspace = currentThread->switch_to_userspace_;
@@ -64,6 +64,7 @@ void ArchMemory::unmapPage(uint32 virtual_page)
       checkAndRemovePT(page_dir_pointer_table_[pdpte_vpn].page_directory_ppn, pde_vpn);
     }
   }
+  asm volatile ("invlpg (%0)" : : "r"(virtual_page * PAGE_SIZE) : "memory");
 }
 
 void ArchMemory::insertPD(uint32 pdpt_vpn, uint32 physical_page_directory_page)
@@ -88,7 +89,7 @@ void ArchMemory::insertPT(PageDirEntry* page_directory, uint32 pde_vpn, uint32 p
 }
 
 void ArchMemory::mapPage(uint32 virtual_page,
-    uint32 physical_page, uint32 user_access, uint32 page_size)
+    uint32 physical_page, uint32 user_access, uint32 page_size, uint32 writeable)
 {
   RESOLVEMAPPING(page_dir_pointer_table_,virtual_page);
 
@@ -105,14 +106,14 @@ void ArchMemory::mapPage(uint32 virtual_page,
       insertPT(page_directory,pde_vpn,PageManager::instance()->allocPPN());
 
     PageTableEntry *pte_base = (PageTableEntry *) getIdentAddressOfPPN(page_directory[pde_vpn].pt.page_table_ppn);
-    pte_base[pte_vpn].writeable = 1;
+    pte_base[pte_vpn].writeable = writeable;
     pte_base[pte_vpn].user_access = user_access;
     pte_base[pte_vpn].page_ppn = physical_page;
     pte_base[pte_vpn].present = 1;
   }
   else if ((page_size==PAGE_SIZE*PAGE_TABLE_ENTRIES) && (page_directory[pde_vpn].page.present == 0))
   {
-    page_directory[pde_vpn].page.writeable = 1;
+    page_directory[pde_vpn].page.writeable = writeable;
     page_directory[pde_vpn].page.size = 1;
     page_directory[pde_vpn].page.page_ppn = physical_page;
     page_directory[pde_vpn].page.user_access = user_access;
@@ -181,6 +182,21 @@ pointer ArchMemory::checkAddressValid(uint32 vaddress_to_check)
   return 0;
 }
 
+bool ArchMemory::testAndClearDirty(uint32 virtual_page)
+{
+  RESOLVEMAPPING(page_dir_pointer_table_, virtual_page);
+  if (!page_dir_pointer_table_[pdpte_vpn].present || !page_directory[pde_vpn].pt.present ||
+      page_directory[pde_vpn].page.size)
+    return false;
+  PageTableEntry *pte_base = (PageTableEntry *) getIdentAddressOfPPN(page_directory[pde_vpn].pt.page_table_ppn);
+  bool dirty = pte_base[pte_vpn].present && pte_base[pte_vpn].dirty;
+  pte_base[pte_vpn].dirty = 0;
+  // a cached translation still marked dirty would keep the cpu from setting the bit again
+  if (dirty)
+    asm volatile ("invlpg (%0)" : : "r"(virtual_page * PAGE_SIZE) : "memory");
+  return dirty;
+}
+
 uint32 ArchMemory::get_PPN_Of_VPN_In_KernelMapping(uint32 virtual_page, size_t *physical_page, uint32 *physical_pte_page)
 {
   PageDirPointerTableEntry *pdpt = kernel_page_directory_pointer_table;
@@ -71,6 +71,7 @@ void ArchMemory::unmapPage(uint32 virtual_page)
   pte_base[pte_vpn].present = 0;
   PageManager::instance()->freePPN(pte_base[pte_vpn].page_ppn);
   ((uint32*)pte_base)[pte_vpn] = 0; // for easier debugging
+  asm volatile ("invlpg (%0)" : : "r"(virtual_page * PAGE_SIZE) : "memory");
   checkAndRemovePT(pde_vpn);
 }
 
@@ -86,7 +87,8 @@ void ArchMemory::insertPT(uint32 pde_vpn, uint32 physical_page_table_page)
   page_directory[pde_vpn].pt.present = 1;
 }
 
-void ArchMemory::mapPage(uint32 virtual_page, uint32 physical_page, uint32 user_access, uint32 page_size)
+void ArchMemory::mapPage(uint32 virtual_page, uint32 physical_page, uint32 user_access, uint32 page_size,
+                         uint32 writeable)
 {
   RESOLVEMAPPING(page_dir_page_, virtual_page);
 
@@ -97,7 +99,7 @@ void ArchMemory::mapPage(uint32 virtual_page, uint32 physical_page, uint32 user_
 
   PageTableEntry *pte_base = (PageTableEntry *) getIdentAddressOfPPN(page_directory[pde_vpn].pt.page_table_ppn);
   assert(!pte_base[pte_vpn].present);
-  pte_base[pte_vpn].writeable = 1;
+  pte_base[pte_vpn].writeable = writeable;
   pte_base[pte_vpn].user_access = user_access;
   pte_base[pte_vpn].page_ppn = physical_page;
   pte_base[pte_vpn].present = 1;
@@ -119,6 +121,20 @@ pointer ArchMemory::checkAddressValid(uint32 vaddress_to_check)
   return 0;
 }
 
+bool ArchMemory::testAndClearDirty(uint32 virtual_page)
+{
+  RESOLVEMAPPING(page_dir_page_, virtual_page);
+  if (!page_directory[pde_vpn].pt.present || page_directory[pde_vpn].page.size)
+    return false;
+  PageTableEntry *pte_base = (PageTableEntry *) getIdentAddressOfPPN(page_directory[pde_vpn].pt.page_table_ppn);
+  bool dirty = pte_base[pte_vpn].present && pte_base[pte_vpn].dirty;
+  pte_base[pte_vpn].dirty = 0;
+  // a cached translation still marked dirty would keep the cpu from setting the bit again
+  if (dirty)
+    asm volatile ("invlpg (%0)" : : "r"(virtual_page * PAGE_SIZE) : "memory");
+  return dirty;
+}
+
 uint32 ArchMemory::get_PPN_Of_VPN_In_KernelMapping(uint32 virtual_page, uint32 *physical_page,
                                                    uint32 *physical_pte_page)
 {
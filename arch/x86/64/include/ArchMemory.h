@@ -59,8 +59,9 @@ public:
  * Privilege Mechanism
  * @param page_size Optional, defaults to 4k pages, but you ned to set it to
  * 1024*4096 if you want to map a 4m page
+ * @param writeable Optional, defaults to a writeable page, 0 maps the page read-only
  */
-  bool mapPage(uint64 virtual_page, uint64 physical_page, uint64 user_access, uint64 page_size=PAGE_SIZE);
+  bool mapPage(uint64 virtual_page, uint64 physical_page, uint64 user_access, uint64 page_size=PAGE_SIZE, uint64 writeable=1);
 
 /**
  * removes the mapping to a virtual_page by marking its PTE Entry as non valid
@@ -102,6 +103,14 @@ public:
  */
   pointer checkAddressValid(uint64 vaddress_to_check);
 
+/**
+ * Reads and clears the dirty bit of a 4k page, the bit is set by the cpu on a write to the page.
+ * The cached translation of a dirty page is invalidated, so the next write sets the bit again.
+ * @param virtual_page Virtual Page to check
+ * @return true if the page was written to since the bit was cleared last
+ */
+  bool testAndClearDirty(uint64 virtual_page);
+
 /**
  * Takes a virtual_page and search through the pageTable and pageDirectory for the
  * physical_page it refers to
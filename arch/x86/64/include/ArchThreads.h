@@ -39,7 +39,7 @@ struct ArchThreadRegisters
   uint64  rsp0;      // 200
   uint64  ss0;       // 208
   uint64  cr3;       // 216
-  uint32  fpu[28];   // 224
+  uint8*  fpu;       // 224 lazily switched fpu/sse state, see ArchFpu
 };
 
 class Thread;
@@ -94,6 +94,12 @@ public:
  */
   static void createUserRegisters(ArchThreadRegisters *&info, void* start_function, void* user_stack, void* kernel_stack);
 
+/**
+ * frees the ArchThreadRegisters created by createKernelRegisters or createUserRegisters
+ * @param info the ArchThreadRegisters, set to 0 afterwards
+ */
+  static void deleteThreadRegisters(ArchThreadRegisters *&info);
+
 /**
  *
  * on x86: invokes int65, whose handler facilitates a task switch
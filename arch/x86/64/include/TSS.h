@@ -0,0 +1,18 @@
+/**
+ * @file TSS.h
+ *
+ */
+
+#pragma once
+
+#include "types.h"
+
+/**
+ * the start of the task state segment set up in boot.32.C
+ */
+typedef struct {
+    uint32 padding;
+    uint64 rsp0; // actually the TSS has more fields, but we don't need them
+} __attribute__((__packed__))TSS;
+
+extern TSS g_tss;
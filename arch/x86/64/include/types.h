@@ -39,6 +39,10 @@ typedef int64 ssize_t;
 #define USER_CS (0x30|DPL_USER)
 #define USER_DS ((0x40)|DPL_USER)
 #define USER_SS ((0x40)|DPL_USER)
+// SYSCALL/SYSRET derive their stack segments from KERNEL_CS and KERNEL_DS,
+// the descriptors live in the unused upper halves of those two gdt entries
+#define SYSCALL_SS (KERNEL_CS + 8)
+#define SYSRET_SS ((KERNEL_DS + 8)|DPL_USER)
 
 #define likely(x)       __builtin_expect((x),1)
 #define unlikely(x)     __builtin_expect((x),0)
@@ -229,6 +229,11 @@ extern "C" void entry64()
       "mov %[stack], %%rbp\n" : : [stack]"i"(boot_stack + 0x4000));
   PRINT("Loading Long Mode Segments...\n");
 
+  // long mode ignores the upper 8 bytes of code and data descriptors, put the flat
+  // data descriptors for SYSCALL_SS and SYSRET_SS there (present, writable, 4kb, 32bit)
+  gdt[KERNEL_CS / sizeof(SegmentDescriptor)].reserved = 0x00C09200 | (DPL_KERNEL << 13);
+  gdt[KERNEL_DS / sizeof(SegmentDescriptor)].reserved = 0x00C09200 | (DPL_USER << 13);
+
   gdt_ptr.limit = sizeof(gdt) - 1;
   gdt_ptr.addr = (uint64)gdt;
   asm("lgdt (%%rax)" : : "a"(&gdt_ptr));
@@ -256,6 +261,13 @@ void ArchCommon::idle()
   asm volatile("hlt");
 }
 
+uint64 ArchCommon::getTimestamp()
+{
+  uint32 low, high;
+  asm volatile("rdtsc" : "=a"(low), "=d"(high));
+  return ((uint64) high << 32) | low;
+}
+
 void ArchCommon::drawHeartBeat()
 {
   const char* clock = "/-\\|";
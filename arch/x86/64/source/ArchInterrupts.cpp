@@ -8,6 +8,8 @@
 #include "ports.h"
 #include "InterruptUtils.h"
 #include "ArchThreads.h"
+#include "ArchFpu.h"
+#include "TSS.h"
 #include "assert.h"
 #include "Thread.h"
 
@@ -123,11 +125,6 @@ extern "C" void arch_saveThreadRegisters(uint64* base, uint64 error)
   register struct interrupt_registers* iregisters;
   iregisters = (struct interrupt_registers*) (base + sizeof(struct context_switch_registers)/sizeof(uint64) + error);
   register ArchThreadRegisters* info = currentThreadRegisters;
-  asm("fnsave %[fpu]\n"
-      "frstor %[fpu]\n"
-      :
-      : [fpu]"m"((info->fpu))
-      :);
   info->rsp = iregisters->rsp;
   info->rip = iregisters->rip;
   info->cs = iregisters->cs;
@@ -152,13 +149,6 @@ extern "C" void arch_saveThreadRegisters(uint64* base, uint64 error)
   assert(!currentThread || currentThread->isStackCanaryOK());
 }
 
-typedef struct {
-    uint32 padding;
-    uint64 rsp0; // actually the TSS has more fields, but we don't need them
-} __attribute__((__packed__))TSS;
-
-extern TSS g_tss;
-
 extern "C" void arch_contextSwitch()
 {
   if (currentThread->switch_to_userspace_)
@@ -168,8 +158,8 @@ extern "C" void arch_contextSwitch()
   }
   assert(currentThread->isStackCanaryOK() && "Kernel stack corruption detected.");
   ArchThreadRegisters info = *currentThreadRegisters; // optimization: local copy produces more efficient code in this case
+  ArchFpu::contextSwitch(currentThread->kernel_registers_->fpu);
   g_tss.rsp0 = info.rsp0;
-  asm("frstor %[fpu]\n" : : [fpu]"m"(info.fpu));
   asm("mov %[cr3], %%cr3\n" : : [cr3]"r"(info.cr3));
   asm("push %[ss]" : : [ss]"m"(info.ss));
   asm("push %[rsp]" : : [rsp]"m"(info.rsp));
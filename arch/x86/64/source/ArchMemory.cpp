@@ -38,7 +38,7 @@ bool ArchMemory::unmapPage(uint64 virtual_page)
   ArchMemoryMapping m = resolveMapping(page_map_level_4_, virtual_page);
 
   assert(m.page_ppn != 0 && m.page_size == PAGE_SIZE);
-  PageManager::instance()->freePPN(m.pt_ppn, PAGE_SIZE);
+  PageManager::instance()->freePPN(m.page_ppn, PAGE_SIZE);
   bool empty = checkAndRemove<PageTableEntry>(getIdentAddressOfPPN(m.pt_ppn), m.pti);
   if (empty) 
   {
@@ -55,6 +55,7 @@ bool ArchMemory::unmapPage(uint64 virtual_page)
     PageManager::instance()->freePPN(m.pdpt_ppn, PAGE_SIZE);
     empty = checkAndRemove<PageMapLevel4Entry>(getIdentAddressOfPPN(m.pml4_ppn), m.pml4i);
   }
+  asm volatile ("invlpg (%0)" : : "r"(virtual_page * PAGE_SIZE) : "memory");
   return true;
 }
 
@@ -79,7 +80,8 @@ bool ArchMemory::insert(pointer map_ptr, uint64 index, uint64 ppn, uint64 bzero,
   return true;
 }
 
-bool ArchMemory::mapPage(uint64 virtual_page, uint64 physical_page, uint64 user_access, uint64 page_size)
+bool ArchMemory::mapPage(uint64 virtual_page, uint64 physical_page, uint64 user_access, uint64 page_size,
+                         uint64 writeable)
 {
   debug(A_MEMORY, "%zx %zx %zx %zx %zx\n", page_map_level_4_, virtual_page, physical_page, user_access, page_size);
   ArchMemoryMapping m = resolveMapping(page_map_level_4_, virtual_page);
@@ -95,7 +97,7 @@ bool ArchMemory::mapPage(uint64 virtual_page, uint64 physical_page, uint64 user_
     if (page_size == PAGE_SIZE * PAGE_TABLE_ENTRIES * PAGE_DIR_ENTRIES)
     {
       return insert<PageDirPointerTablePageEntry>(getIdentAddressOfPPN(m.pdpt_ppn), m.pdi, physical_page, 0, 1,
-                                                  user_access, 1);
+                                                  user_access, writeable);
     }
     else
     {
@@ -108,7 +110,8 @@ bool ArchMemory::mapPage(uint64 virtual_page, uint64 physical_page, uint64 user_
   {
     if (page_size == PAGE_SIZE * PAGE_TABLE_ENTRIES)
     {
-      return insert<PageDirPageEntry>(getIdentAddressOfPPN(m.pd_ppn), m.pdi, physical_page, 0, 1, user_access, 1);
+      return insert<PageDirPageEntry>(getIdentAddressOfPPN(m.pd_ppn), m.pdi, physical_page, 0, 1, user_access,
+                                      writeable);
     }
     else // if (m.pd == 0)
     {
@@ -119,7 +122,8 @@ bool ArchMemory::mapPage(uint64 virtual_page, uint64 physical_page, uint64 user_
 
   if (m.page_ppn == 0 && page_size == PAGE_SIZE)
   {
-    return insert<PageTableEntry>(getIdentAddressOfPPN(m.pt_ppn), m.pti, physical_page, 0, 0, user_access, 1);
+    return insert<PageTableEntry>(getIdentAddressOfPPN(m.pt_ppn), m.pti, physical_page, 0, 0, user_access,
+                                  writeable);
   }
   assert(false); // you should never get here
   return false;
@@ -180,6 +184,19 @@ pointer ArchMemory::checkAddressValid(uint64 vaddress_to_check)
   }
 }
 
+bool ArchMemory::testAndClearDirty(uint64 virtual_page)
+{
+  ArchMemoryMapping m = resolveMapping(page_map_level_4_, virtual_page);
+  if (m.page_size != PAGE_SIZE)
+    return false;
+  bool dirty = m.pt[m.pti].dirty;
+  m.pt[m.pti].dirty = 0;
+  // a cached translation still marked dirty would keep the cpu from setting the bit again
+  if (dirty)
+    asm volatile ("invlpg (%0)" : : "r"(virtual_page * PAGE_SIZE) : "memory");
+  return dirty;
+}
+
 ArchMemoryMapping ArchMemory::resolveMapping(uint64 pml4, uint64 vpage)
 {
   ArchMemoryMapping m;
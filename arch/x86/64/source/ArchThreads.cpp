@@ -1,5 +1,6 @@
 #include "ArchThreads.h"
 #include "ArchMemory.h"
+#include "ArchFpu.h"
 #include "kprintf.h"
 #include "paging-definitions.h"
 #include "offsets.h"
@@ -12,7 +13,7 @@ extern PageMapLevel4Entry kernel_page_map_level_4[];
 void ArchThreads::initialise()
 {
   currentThreadRegisters = (ArchThreadRegisters*) new uint8[sizeof(ArchThreadRegisters)];
-
+  ArchFpu::initialise();
 }
 void ArchThreads::setAddressSpace(Thread *thread, ArchMemory& arch_memory)
 {
@@ -40,14 +41,7 @@ void ArchThreads::createKernelRegisters(ArchThreadRegisters *&info, void* start_
   info->cr3     = pml4;
   assert(info->cr3);
 
- /* fpu (=fninit) */
-  info->fpu[0] = 0xFFFF037F;
-  info->fpu[1] = 0xFFFF0000;
-  info->fpu[2] = 0xFFFFFFFF;
-  info->fpu[3] = 0x00000000;
-  info->fpu[4] = 0x00000000;
-  info->fpu[5] = 0x00000000;
-  info->fpu[6] = 0xFFFF0000;
+  info->fpu     = ArchFpu::createState();
 }
 
 void ArchThreads::changeInstructionPointer(ArchThreadRegisters *info, void* function)
@@ -74,17 +68,14 @@ void ArchThreads::createUserRegisters(ArchThreadRegisters *&info, void* start_fu
   info->rip     = (size_t)start_function;
   info->cr3     = pml4;
   assert(info->cr3);
+}
 
- /* fpu (=fninit) */
-  info->fpu[0] = 0xFFFF037F;
-  info->fpu[1] = 0xFFFF0000;
-  info->fpu[2] = 0xFFFFFFFF;
-  info->fpu[3] = 0x00000000;
-  info->fpu[4] = 0x00000000;
-  info->fpu[5] = 0x00000000;
-  info->fpu[6] = 0xFFFF0000;
-  //kprintfd("ArchThreads::create: values done\n");
-
+void ArchThreads::deleteThreadRegisters(ArchThreadRegisters *&info)
+{
+  if (info)
+    ArchFpu::deleteState(info->fpu);
+  delete[] (uint8*)info;
+  info = 0;
 }
 
 void ArchThreads::yield()
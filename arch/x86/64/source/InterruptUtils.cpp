@@ -6,6 +6,8 @@
 #include "ports.h"
 #include "ArchMemory.h"
 #include "ArchThreads.h"
+#include "ArchFpu.h"
+#include "Profiler.h"
 #include "ArchCommon.h"
 #include "Console.h"
 #include "Terminal.h"
@@ -28,6 +30,7 @@
 #include "Loader.h"
 #include "Syscall.h"
 #include "paging-definitions.h"
+#include "TSS.h"
 
 #define LO_WORD(x) (((uint32)(x)) & 0x0000FFFFULL)
 #define HI_WORD(x) ((((uint32)(x)) >> 16) & 0x0000FFFFULL)
@@ -42,6 +45,12 @@
 
 #define SYSCALL_INTERRUPT 0x80 // number of syscall interrupt
 
+#define MSR_EFER   0xC0000080
+#define MSR_STAR   0xC0000081
+#define MSR_LSTAR  0xC0000082
+#define MSR_SFMASK 0xC0000084
+#define EFER_SCE   0x1 // syscall enable
+
 
 // --- Pagefault error flags.
 //     PF because/in/caused by/...
@@ -78,6 +87,19 @@ struct GateDesc
 
 
 extern "C" void arch_dummyHandler();
+extern "C" void arch_syscallEntry();
+
+static uint64 rdmsr(uint32 msr)
+{
+  uint32 low, high;
+  asm volatile("rdmsr" : "=a"(low), "=d"(high) : "c"(msr));
+  return ((uint64) high << 32) | low;
+}
+
+static void wrmsr(uint32 msr, uint64 value)
+{
+  asm volatile("wrmsr" : : "c"(msr), "a"(LO_DWORD(value)), "d"(HI_DWORD(value)));
+}
 
 uint64 InterruptUtils::pf_address;
 uint64 InterruptUtils::pf_address_counter;
@@ -119,6 +141,14 @@ void InterruptUtils::initialise()
   idtr.base = (pointer) interrupt_gates;
   idtr.limit = sizeof(GateDesc) * num_handlers - 1;
   lidt(&idtr);
+
+  // SYSCALL enters at arch_syscallEntry with KERNEL_CS/SYSCALL_SS and IF, TF and DF cleared,
+  // SYSRET returns with USER_CS/SYSRET_SS (STAR[63:48] + 16 and + 8)
+  wrmsr(MSR_STAR, ((uint64) KERNEL_DS << 48) | ((uint64) KERNEL_CS << 32));
+  wrmsr(MSR_LSTAR, (uint64) arch_syscallEntry);
+  wrmsr(MSR_SFMASK, 0x200 | 0x100 | 0x400);
+  wrmsr(MSR_EFER, rdmsr(MSR_EFER) | EFER_SCE);
+
   pf_address = 0xdeadbeef;
   pf_address_counter = 0;
 }
@@ -185,6 +215,8 @@ extern "C" void irqHandler_0()
 
   Scheduler::instance()->incTicks();
 
+  Profiler::timerTick(currentThreadRegisters->rip);
+
   Scheduler::instance()->schedule();
 
   //kprintfd("irq0: Going to leave irq Handler 0\n");
@@ -274,6 +306,8 @@ extern "C" void pageFaultHandler(uint64 address, uint64 error)
   //--------End "just for Debugging"-----------
 
 
+  ++currentThread->usage_.page_faults;
+
   //save previous state on stack of currentThread
   uint32 saved_switch_to_userspace = currentThread->switch_to_userspace_;
   currentThread->switch_to_userspace_ = 0;
@@ -393,5 +427,37 @@ extern "C" void syscallHandler()
   arch_contextSwitch();
 }
 
+/**
+ * C part of the SYSCALL entry, arguments as for syscallHandler. The user rsp, rip,
+ * rflags and rbp were pushed to the (16 byte aligned) top of the kernel stack by arch_syscallEntry,
+ * they are copied to user_registers_ for backtraces; everything else stays live
+ * and is saved by the interrupt handlers only if a context switch happens meanwhile.
+ * @return the return value for rax
+ */
+extern "C" size_t syscallFastHandler(size_t syscall_number, size_t arg1, size_t arg2, size_t arg3, size_t arg4,
+                                     size_t arg5)
+{
+  ArchThreadRegisters* user_registers = currentThread->user_registers_;
+  uint64* frame = (uint64*) (user_registers->rsp0 & ~0xFULL);
+  user_registers->rsp = frame[-1];
+  user_registers->rip = frame[-2];
+  user_registers->rflags = frame[-3];
+  user_registers->rbp = frame[-4];
+
+  currentThread->switch_to_userspace_ = 0;
+  currentThreadRegisters = currentThread->kernel_registers_;
+  ArchInterrupts::enableInterrupts();
+
+  size_t return_value = Syscall::syscallException(syscall_number, arg1, arg2, arg3, arg4, arg5);
+
+  ArchInterrupts::disableInterrupts();
+  currentThread->switch_to_userspace_ = 1;
+  currentThreadRegisters = user_registers;
+  // a context switch back into the syscall went through the kernel registers and left rsp0 at 0
+  g_tss.rsp0 = user_registers->rsp0;
+  user_registers->rax = return_value;
+  return return_value;
+}
+
 #include "ErrorHandlers.h" // error handler definitions and irq forwarding definitions
 
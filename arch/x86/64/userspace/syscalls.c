@@ -1,4 +1,7 @@
 void __syscall()
 {
-  asm("int $0x80");
+  // arguments are already in rdi, rsi, rdx, rcx, r8, r9;
+  // syscall overwrites rcx (and r11), so the 4th argument moves to r10
+  asm("mov %rcx, %r10\n"
+      "syscall");
 }
@@ -55,6 +55,13 @@ class ATADriver : public BDDriver
      */
     int32 writeSector(uint32, uint32, void *);
 
+    /**
+     * writes the write cache of the drive to the disk (FLUSH CACHE),
+     * writeSector leaves the data in the cache
+     * @return 0 on success
+     */
+    int32 flushCache();
+
     uint32 getNumSectors()
     {
       return numsec;
@@ -0,0 +1,95 @@
+/**
+ * @file ArchFpu.h
+ *
+ * lazy switching of the x87/SSE/AVX register state
+ *
+ * The state of a thread is only saved and restored when another thread
+ * actually uses the FPU: on a context switch CR0.TS is set unless the thread
+ * being switched to already owns the FPU, the first FPU/SSE instruction then
+ * raises #NM, whose handler saves the state of the current owner and loads
+ * the state of the faulting thread.
+ */
+
+#pragma once
+
+#include "types.h"
+
+class ArchFpu
+{
+  public:
+
+    /**
+     * detects XSAVE/XSAVEOPT/FXSAVE, enables them in CR0/CR4/XCR0 and
+     * captures the initial register state every new thread starts with,
+     * does nothing if already initialised
+     */
+    static void initialise();
+
+    /**
+     * allocates a register state holding the initial state
+     * @return the register state, aligned to 64 bytes
+     */
+    static uint8* createState();
+
+    /**
+     * frees a register state, the FPU is released if the state owns it
+     * @param state the register state, may be 0
+     */
+    static void deleteState(uint8* state);
+
+    /**
+     * #NM handler, makes state the owner of the FPU
+     * @pre IF==0
+     * @param state the register state of the current thread
+     */
+    static void deviceNotAvailable(uint8* state);
+
+    /**
+     * sets or clears CR0.TS for the thread about to be switched to
+     * @pre IF==0
+     * @param state the register state of the next thread
+     */
+    static void contextSwitch(uint8* state);
+
+    /**
+     * begins a region in which kernel code may use FPU/SSE instructions,
+     * the state of the owner is saved and interrupts are disabled until kernelEnd
+     * @return whether interrupts were enabled, to be passed to kernelEnd
+     */
+    static bool kernelBegin();
+
+    /**
+     * ends a region begun with kernelBegin
+     * @param interrupts_enabled the return value of kernelBegin
+     */
+    static void kernelEnd(bool interrupts_enabled);
+
+    /**
+     * @return whether kernel code may use SSE instructions between kernelBegin and kernelEnd,
+     *         false until initialise enabled them
+     */
+    static bool kernelSSEAvailable();
+
+    /**
+     * @return the size of a register state in bytes
+     */
+    static size_t getStateSize();
+
+  private:
+
+    enum SaveMode
+    {
+      FNSAVE, FXSAVE, XSAVE, XSAVEOPT
+    };
+
+    static uint8* allocateState();
+    static void save(uint8* state);
+    static void restore(uint8* state);
+
+    static uint8* owner_;
+    static uint8* initial_state_;
+    static size_t state_size_;
+    static SaveMode mode_;
+    static uint64 xcr0_;
+};
+
@@ -12,7 +12,6 @@ ERROR_HANDLER(0,#DE: Divide by Zero)
 ERROR_HANDLER(4,#OF: Overflow (INTO Instruction))
 ERROR_HANDLER(5,#BR: Bound Range Exceeded)
 ERROR_HANDLER(6,#OP: Invalid OP Code)
-ERROR_HANDLER(7,#NM: FPU Not Avaiable or Ready)
 ERROR_HANDLER(8,#DF: Double Fault)
 ERROR_HANDLER(9,#MF: FPU Segment Overrun)
 ERROR_HANDLER(10,#TS: Invalid Task State Segment (TSS))
@@ -24,6 +23,13 @@ ERROR_HANDLER(17,#AC: Alignment Error (Unaligned Memory Reference))
 ERROR_HANDLER(18,#MC: Machine Check Error)
 ERROR_HANDLER(19,#XF: SIMD Floting Point Error)
 
+// #NM is not an error, CR0.TS is set whenever the current thread does not own the fpu
+extern "C" void arch_errorHandler_7();
+extern "C" void errorHandler_7()
+{
+  ArchFpu::deviceNotAvailable(currentThread->kernel_registers_->fpu);
+}
+
 extern ArchThreadRegisters *currentThreadRegisters;
 extern Thread *currentThread;
 
@@ -0,0 +1,18 @@
+/**
+ * @file cpuid.h
+ *
+ */
+
+#pragma once
+
+#include "types.h"
+
+/**
+ * executes cpuid
+ * @param leaf the leaf, loaded into eax
+ * @param subleaf the subleaf, loaded into ecx
+ */
+static inline void cpuid(uint32 leaf, uint32 subleaf, uint32& eax, uint32& ebx, uint32& ecx, uint32& edx)
+{
+  asm volatile("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(leaf), "c"(subleaf));
+}
@@ -201,9 +201,22 @@ int32 ATADriver::writeSector ( uint32 start_sector, uint32 num_sectors, void * b
   /* Wait for drive to clear BUSY */
   TIMEOUT_CHECK(inportbp(port + 7) & 0x80,TIMEOUT_WARNING(); return -1;);
 
+  return 0;
+}
+
+int32 ATADriver::flushCache()
+{
+  /* Wait for drive to clear BUSY */
+  TIMEOUT_CHECK(inportbp(port + 7) & 0x80,TIMEOUT_WARNING(); return -1;);
+
+  outportbp(port + 6, drive);
+
   /* Write flush code to the command register */
-  outportbp (port + 7, 0xE7);
-    
+  outportbp(port + 7, 0xE7);
+
+  if (mode != BD_PIO_NO_IRQ)
+    return 0;
+
   /* Wait for drive to clear BUSY */
   TIMEOUT_CHECK(inportbp(port + 7) & 0x80,TIMEOUT_WARNING(); return -1;);
 
@@ -239,6 +252,9 @@ uint32 ATADriver::addRequest( BDRequest *br )
     case BDRequest::BD_WRITE:
       res = writeSector( br->getStartBlock(), br->getNumBlocks(), br->getBuffer() );
       break;
+    case BDRequest::BD_FLUSH:
+      res = flushCache();
+      break;
     default:
       res = -1;
       break;
@@ -372,6 +388,13 @@ void ATADriver::serviceIRQ()
       br->setBlocksDone( blocks_done );
     }
   }
+  else if( br->getCmd() == BDRequest::BD_FLUSH )
+  {
+    br->setStatus( BDRequest::BD_DONE );
+    request_list_ = br->getNextRequest();
+    if( br->getThread() )
+      Scheduler::instance()->wake( br->getThread() );
+  }
   else
   {
     blocks_done = br->getNumBlocks();
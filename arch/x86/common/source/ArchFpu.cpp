@@ -0,0 +1,228 @@
+#include "ArchFpu.h"
+#include "ArchInterrupts.h"
+#include "cpuid.h"
+#include "kprintf.h"
+#include "kstring.h"
+#include "assert.h"
+#include "debug.h"
+
+#define CR0_MP 0x00000002 // monitor coprocessor: wait/fwait honour TS
+#define CR0_EM 0x00000004 // emulation: all fpu instructions raise #NM
+#define CR0_TS 0x00000008 // task switched: the next fpu/sse instruction raises #NM
+
+#define CR4_OSFXSR     0x00000200 // fxsave/fxrstor and sse instructions
+#define CR4_OSXMMEXCPT 0x00000400 // unmasked sse exceptions raise #XF
+#define CR4_OSXSAVE    0x00040000 // xsave/xrstor and xsetbv
+
+#define CPUID_1_EDX_FXSR     (1 << 24)
+#define CPUID_1_ECX_XSAVE    (1 << 26)
+#define CPUID_D_1_EAX_XSAVEOPT (1 << 0)
+
+#define XCR0_X87 0x1
+#define XCR0_SSE 0x2
+#define XCR0_AVX 0x4
+
+#define FNSAVE_STATE_SIZE 108
+#define FXSAVE_STATE_SIZE 512
+#define STATE_ALIGNMENT 64
+#define MXCSR_DEFAULT 0x1F80
+
+uint8* ArchFpu::owner_ = 0;
+uint8* ArchFpu::initial_state_ = 0;
+size_t ArchFpu::state_size_ = FNSAVE_STATE_SIZE;
+ArchFpu::SaveMode ArchFpu::mode_ = ArchFpu::FNSAVE;
+uint64 ArchFpu::xcr0_ = 0;
+
+static size_t readCR0()
+{
+  size_t cr0;
+  asm volatile("mov %%cr0, %0" : "=r"(cr0));
+  return cr0;
+}
+
+static void writeCR0(size_t cr0)
+{
+  asm volatile("mov %0, %%cr0" : : "r"(cr0));
+}
+
+static size_t readCR4()
+{
+  size_t cr4;
+  asm volatile("mov %%cr4, %0" : "=r"(cr4));
+  return cr4;
+}
+
+static void writeCR4(size_t cr4)
+{
+  asm volatile("mov %0, %%cr4" : : "r"(cr4));
+}
+
+static void clearTS()
+{
+  asm volatile("clts");
+}
+
+static void setTS()
+{
+  writeCR0(readCR0() | CR0_TS);
+}
+
+void ArchFpu::initialise()
+{
+  if (initial_state_)
+    return;
+
+  uint32 eax, ebx, ecx, edx;
+  cpuid(0, 0, eax, ebx, ecx, edx);
+  uint32 max_leaf = eax;
+  cpuid(1, 0, eax, ebx, ecx, edx);
+
+  writeCR0((readCR0() | CR0_MP) & ~(CR0_EM | CR0_TS));
+
+  if ((ecx & CPUID_1_ECX_XSAVE) && max_leaf >= 0xD)
+  {
+    writeCR4(readCR4() | CR4_OSFXSR | CR4_OSXMMEXCPT | CR4_OSXSAVE);
+    cpuid(0xD, 0, eax, ebx, ecx, edx);
+    xcr0_ = (XCR0_X87 | XCR0_SSE | XCR0_AVX) & eax;
+    asm volatile("xsetbv" : : "c"(0), "a"((uint32) xcr0_), "d"((uint32) (xcr0_ >> 32)));
+    // ebx reflects the components enabled in xcr0 only after xsetbv
+    cpuid(0xD, 0, eax, ebx, ecx, edx);
+    state_size_ = ebx;
+    cpuid(0xD, 1, eax, ebx, ecx, edx);
+    mode_ = (eax & CPUID_D_1_EAX_XSAVEOPT) ? XSAVEOPT : XSAVE;
+  }
+  else if (edx & CPUID_1_EDX_FXSR)
+  {
+    writeCR4(readCR4() | CR4_OSFXSR | CR4_OSXMMEXCPT);
+    state_size_ = FXSAVE_STATE_SIZE;
+    mode_ = FXSAVE;
+  }
+
+  initial_state_ = allocateState();
+  // the xsave header of the initial state has to be zero for xrstor to accept it
+  memset(initial_state_, 0, state_size_);
+  asm volatile("fninit");
+  if (mode_ != FNSAVE)
+  {
+    uint32 mxcsr = MXCSR_DEFAULT;
+    asm volatile("ldmxcsr %0" : : "m"(mxcsr));
+  }
+  save(initial_state_);
+
+  owner_ = 0;
+  setTS();
+  debug(A_COMMON, "ArchFpu::initialise: mode %d, state size %zu, xcr0 %x\n", mode_, state_size_, (uint32) xcr0_);
+}
+
+uint8* ArchFpu::allocateState()
+{
+  uint8* raw = new uint8[state_size_ + STATE_ALIGNMENT + sizeof(uint8*)];
+  uint8* state = (uint8*) (((size_t) raw + sizeof(uint8*) + STATE_ALIGNMENT - 1) & ~(size_t) (STATE_ALIGNMENT - 1));
+  ((uint8**) state)[-1] = raw;
+  return state;
+}
+
+uint8* ArchFpu::createState()
+{
+  // threads are already created before ArchThreads::initialise, e.g. the scheduler's
+  initialise();
+  uint8* state = allocateState();
+  memcpy(state, initial_state_, state_size_);
+  return state;
+}
+
+void ArchFpu::deleteState(uint8* state)
+{
+  if (!state)
+    return;
+  bool interrupts_enabled = ArchInterrupts::disableInterrupts();
+  if (owner_ == state)
+    owner_ = 0;
+  if (interrupts_enabled)
+    ArchInterrupts::enableInterrupts();
+  delete[] ((uint8**) state)[-1];
+}
+
+void ArchFpu::deviceNotAvailable(uint8* state)
+{
+  assert(state && "#NM without a register state");
+  clearTS();
+  if (owner_ == state)
+    return;
+  if (owner_)
+    save(owner_);
+  restore(state);
+  owner_ = state;
+}
+
+void ArchFpu::contextSwitch(uint8* state)
+{
+  if (state && state == owner_)
+    clearTS();
+  else
+    setTS();
+}
+
+bool ArchFpu::kernelBegin()
+{
+  bool interrupts_enabled = ArchInterrupts::disableInterrupts();
+  clearTS();
+  if (owner_)
+    save(owner_);
+  owner_ = 0;
+  asm volatile("fninit");
+  return interrupts_enabled;
+}
+
+void ArchFpu::kernelEnd(bool interrupts_enabled)
+{
+  setTS();
+  if (interrupts_enabled)
+    ArchInterrupts::enableInterrupts();
+}
+
+bool ArchFpu::kernelSSEAvailable()
+{
+  return initial_state_ && mode_ != FNSAVE;
+}
+
+size_t ArchFpu::getStateSize()
+{
+  return state_size_;
+}
+
+void ArchFpu::save(uint8* state)
+{
+  switch (mode_)
+  {
+    case XSAVEOPT:
+      asm volatile("xsaveopt (%0)" : : "r"(state), "a"((uint32) xcr0_), "d"((uint32) (xcr0_ >> 32)) : "memory");
+      break;
+    case XSAVE:
+      asm volatile("xsave (%0)" : : "r"(state), "a"((uint32) xcr0_), "d"((uint32) (xcr0_ >> 32)) : "memory");
+      break;
+    case FXSAVE:
+      asm volatile("fxsave (%0)" : : "r"(state) : "memory");
+      break;
+    default:
+      asm volatile("fnsave (%0)" : : "r"(state) : "memory");
+      break;
+  }
+}
+
+void ArchFpu::restore(uint8* state)
+{
+  switch (mode_)
+  {
+    case XSAVEOPT:
+    case XSAVE:
+      asm volatile("xrstor (%0)" : : "r"(state), "a"((uint32) xcr0_), "d"((uint32) (xcr0_ >> 32)) : "memory");
+      break;
+    case FXSAVE:
+      asm volatile("fxrstor (%0)" : : "r"(state) : "memory");
+      break;
+    default:
+      asm volatile("frstor (%0)" : : "r"(state) : "memory");
+      break;
+  }
+}
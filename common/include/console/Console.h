@@ -134,6 +134,13 @@ class Console : public Thread
     virtual uint32 consoleGetNumColumns() const=0;
     virtual void consoleScrollUp(uint8 const &state) =0;
 
+    /**
+     * Called regularly by the console thread, consoles that defer drawing catch up here.
+     */
+    virtual void consoleFlush()
+    {
+    }
+
     ustl::list<Terminal *> terminals_;
     Mutex console_lock_;
     Mutex set_active_lock_;
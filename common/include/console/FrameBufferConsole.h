@@ -6,8 +6,19 @@
 
 #include "Console.h"
 
+#define GLYPH_WIDTH 8
+#define GLYPH_HEIGHT 16
+#define GLYPH_WORDS (GLYPH_WIDTH * sizeof(uint16) / sizeof(size_t)) // words per line of a glyph
+
 /**
  * @class FrameBufferConsole the framebuffer console implementation
+ *
+ * Characters are not drawn into the linear framebuffer right away, the
+ * console keeps the character and state of every cell in normal memory and
+ * remembers which columns of each row changed since the last flush. Scrolling
+ * only rotates the rows of that buffer. The console thread draws the damaged
+ * cells with whole words per glyph line, while booting or with interrupts
+ * disabled they are drawn immediately. Expects 16 bits per pixel.
  */
 class FrameBufferConsole : public Console
 {
@@ -31,6 +42,13 @@ class FrameBufferConsole : public Console
     virtual uint32 consoleSetCharacter(uint32 const &row, uint32 const&column, uint8 const &character,
                                        uint8 const &state);
 
+  protected:
+
+    /**
+     * Draws the cells that changed since the last flush.
+     */
+    virtual void consoleFlush();
+
   private:
 
     /**
@@ -68,9 +86,57 @@ class FrameBufferConsole : public Console
     uint16 convertConsoleColor(CONSOLECOLOR color);
     void colorsFromState(uint8 const &state, CONSOLECOLOR &fg, CONSOLECOLOR &bg);
 
+    /**
+     * Marks the columns [begin, end) of the given row as changed.
+     */
+    void damage(uint32 row, uint32 begin, uint32 end);
+
+    /**
+     * Draws the damaged cells, the caller has to hold the console lock
+     * unless the system is still booting.
+     */
+    void drawDamage();
+
+    /**
+     * Draws the damaged cells right away if the console thread can not do it.
+     */
+    void drawDamageIfSynchronous();
+
+    /**
+     * Draws one cell from the buffer into the linear framebuffer.
+     */
+    void drawCell(uint32 row, uint32 column);
+
+    uint16 &cell(uint32 row, uint32 column);
+
     uint32 x_res_;
     uint32 y_res_;
     uint32 bits_per_pixel_;
     uint32 bytes_per_pixel_;
+    uint32 num_rows_;
+    uint32 num_columns_;
+
+    /**
+     * character | state << 8 of every cell, the rows form a ring starting at first_row_
+     */
+    uint16 *cells_;
+    uint32 first_row_;
+
+    /**
+     * per row the columns [begin, end) that differ from the framebuffer
+     */
+    uint32 *damage_begin_;
+    uint32 *damage_end_;
+    bool damaged_;
+
+    /**
+     * the console colors, repeated to fill a word
+     */
+    size_t colors_[16];
+
+    /**
+     * for every byte of the font the pixels of a glyph line, all bits set for the foreground
+     */
+    static size_t glyph_masks_[256][GLYPH_WORDS];
 };
 
@@ -156,9 +156,31 @@ class Terminal : public CharacterDevice
 
     /**
      * Scrolls up the terminal.
+     * Within beginBatch/endBatch the console is only told at the end.
      */
     void scrollUp();
 
+    /**
+     * Starts collecting the changes of a run of characters, nothing is drawn until endBatch.
+     */
+    void beginBatch();
+
+    /**
+     * Draws what changed since beginBatch: scrolls the console once per scrolled line, or redraws
+     * everything if the whole screen scrolled away, and redraws the rows written to.
+     */
+    void endBatch();
+
+    /**
+     * Draws the rows from first to the bottom of the screen, the caller holds the console lock.
+     */
+    void drawRows(uint32 first);
+
+    /**
+     * @return the index of the cell in characters_ and character_states_
+     */
+    uint32 cellIndex(uint32 row, uint32 column) const;
+
     /**
      * Checks if the given key is a lower case letter.
      * @param key the key to check
@@ -183,6 +205,14 @@ class Terminal : public CharacterDevice
     uint8 *characters_;
     uint8 *character_states_;
 
+    /**
+     * the rows of characters_ and character_states_ form a ring, first_row_ is the top of the screen
+     */
+    uint32 first_row_;
+
+    bool batching_;
+    uint32 batch_scrolls_;
+
     uint32 current_column_;
     uint8 current_state_;
 
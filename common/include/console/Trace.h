@@ -0,0 +1,94 @@
+/**
+ * @file Trace.h
+ *
+ * binary trace buffer for debug() flags marked with OUTPUT_TRACE
+ *
+ * Instead of formatting the message and writing it to the debug port
+ * character by character, debug() stores a fixed size record holding a
+ * timestamp, the address of the format string and the raw arguments.
+ * The records are read from /dev/trace and formatted offline with
+ * utils/tracedecode, which looks up the strings in the kernel binary.
+ */
+
+#pragma once
+
+#include "types.h"
+
+#define TRACE_MAX_ARGS 10
+#define TRACE_RECORDS 2048 // must be a power of two
+
+/**
+ * one trace record, all fields are 64 bit wide so that the layout is
+ * the same on all architectures (128 bytes, little endian on x86)
+ */
+struct TraceRecord
+{
+  uint64 sequence;  // index of the record + 1, 0 while it is being written
+  uint64 timestamp; // ArchCommon::getTimestamp()
+  uint64 format;    // address of the format string, identifies the event
+  uint64 flag_name; // address of the name of the debug flag
+  uint64 thread;    // address of the current thread
+  uint32 flag;      // the debug flag
+  uint32 num_args;  // number of arguments passed, at most TRACE_MAX_ARGS are stored
+  uint64 args[TRACE_MAX_ARGS];
+};
+
+/**
+ * @class Trace
+ * There is one buffer as there is one cpu. Writers only reserve a slot with
+ * an atomic increment and never block, so debug() may be used in interrupt
+ * handlers and while holding spinlocks. If the reader does not keep up, the
+ * oldest records are overwritten; the decoder reports the gaps.
+ */
+class Trace
+{
+  public:
+
+    /**
+     * records a debug() call, the arguments are stored unformatted
+     * @param flag the debug flag
+     * @param flag_name the name of the debug flag
+     * @param format the printf format string
+     * @param args the arguments, integers or pointers
+     */
+    template<typename... Args>
+    static void record(size_t flag, const char* flag_name, const char* format, Args... args)
+    {
+      uint64 values[] = { value(args)..., 0 };
+      write(flag, flag_name, format, values, sizeof...(Args));
+    }
+
+    /**
+     * stores a record in the buffer
+     * @param num_args the number of values in args
+     */
+    static void write(size_t flag, const char* flag_name, const char* format, const uint64* args, size_t num_args);
+
+    /**
+     * copies the committed records not read yet to buffer, only whole records are copied
+     * @pre there is only one reader at a time
+     * @param buffer the destination
+     * @param size the size of the buffer
+     * @return the number of bytes copied, a multiple of sizeof(TraceRecord)
+     */
+    static size_t read(char* buffer, size_t size);
+
+  private:
+
+    template<typename T>
+    static uint64 value(T* pointer_value)
+    {
+      return (size_t) pointer_value;
+    }
+
+    template<typename T>
+    static uint64 value(T integer_value)
+    {
+      return (uint64) integer_value;
+    }
+
+    static TraceRecord records_[TRACE_RECORDS];
+    static size_t head_;
+    static size_t tail_;
+};
+
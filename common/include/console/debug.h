@@ -13,7 +13,8 @@ enum AnsiColor
 
 #define OUTPUT_ENABLED 0x80000000
 #define OUTPUT_ADVANCED 0x70000000
-#define OUTPUT_FLAGS (OUTPUT_ENABLED | OUTPUT_ADVANCED)
+#define OUTPUT_TRACE 0x08000000 // record in the binary trace buffer (see Trace.h) instead of printing
+#define OUTPUT_FLAGS (OUTPUT_ENABLED | OUTPUT_ADVANCED | OUTPUT_TRACE)
 
 #ifndef NOCOLOR
 #define DEBUG_FORMAT_STRING "\033[0;%zum[%-11s]\033[1;m"
@@ -24,8 +25,14 @@ enum AnsiColor
 #endif
 
 #ifndef EXE2MINIXFS
+#ifdef __cplusplus
+#include "Trace.h"
+#define debug(flag, ...) do { if (flag & OUTPUT_ENABLED) { kprintfd(DEBUG_FORMAT_STRING, COLOR_PARAM(flag)); kprintfd(__VA_ARGS__); } \
+                              else if (flag & OUTPUT_TRACE) { Trace::record(flag, #flag, __VA_ARGS__); } } while (0)
+#else
 #define debug(flag, ...) do { if (flag & OUTPUT_ENABLED) { kprintfd(DEBUG_FORMAT_STRING, COLOR_PARAM(flag)); kprintfd(__VA_ARGS__); } } while (0)
 #endif
+#endif
 
 //group minix
 const size_t M_STORAGE_MANAGER  = Ansi_Yellow;
@@ -41,20 +48,21 @@ const size_t BD_VIRT_DEVICE     = Ansi_Yellow;
 const size_t KPRINTF            = Ansi_Yellow;
 
 //group kernel
-const size_t LOCK               = Ansi_Yellow  | OUTPUT_ENABLED;
+const size_t LOCK               = Ansi_Yellow  | OUTPUT_TRACE;
 const size_t LOADER             = Ansi_White   | OUTPUT_ENABLED;
-const size_t SCHEDULER          = Ansi_Yellow  | OUTPUT_ENABLED;
-const size_t SYSCALL            = Ansi_Blue    | OUTPUT_ENABLED;
+const size_t SCHEDULER          = Ansi_Yellow  | OUTPUT_TRACE;
+const size_t SYSCALL            = Ansi_Blue    | OUTPUT_TRACE;
 const size_t MAIN               = Ansi_Red     | OUTPUT_ENABLED;
 const size_t THREAD             = Ansi_Magenta | OUTPUT_ENABLED;
 const size_t USERPROCESS        = Ansi_Cyan    | OUTPUT_ENABLED;
 const size_t PROCESS_REG        = Ansi_Yellow  | OUTPUT_ENABLED;
 const size_t BACKTRACE          = Ansi_Red     | OUTPUT_ENABLED;
 const size_t USERTRACE          = Ansi_Red     | OUTPUT_ENABLED;
+const size_t RING               = Ansi_Cyan;
 
 //group memory management
 const size_t PM                 = Ansi_Green | OUTPUT_ENABLED;
-const size_t PAGEFAULT          = Ansi_Green | OUTPUT_ENABLED;
+const size_t PAGEFAULT          = Ansi_Green | OUTPUT_TRACE;
 const size_t KMM                = Ansi_Yellow;
 
 //group driver
@@ -74,6 +82,7 @@ const size_t A_INTERRUPTS       = Ansi_Yellow;
 //group file system
 const size_t FS                 = Ansi_Yellow;
 const size_t RAMFS              = Ansi_White;
+const size_t TMPFS              = Ansi_White;
 const size_t DENTRY             = Ansi_Blue;
 const size_t PATHWALKER         = Ansi_Yellow;
 const size_t PSEUDOFS           = Ansi_Yellow;
@@ -4,6 +4,12 @@
 #include "ulist.h"
 #include "ustring.h"
 
+/**
+ * longest transfer handed to a driver at once, longer reads and writes are split
+ * (the ATA sector count register only has 8 bits)
+ */
+#define BD_MAX_REQUEST_SECTORS 128
+
 class BDDriver;
 class BDRequest;
 
@@ -61,6 +67,12 @@ class BDVirtualDevice
      */
     virtual int32 writeData(uint32 offset, uint32 size, char *buffer);
 
+    /**
+     * makes the data written so far durable, i.e. flushes the write cache of the drive
+     * @return 0 on success, -1 on error
+     */
+    virtual int32 flush();
+
     /**
      * the PartitionType is a 8bit field in the PartitionTable of a MBR
      * it specifies the FileSystem which is installed on the partition
@@ -88,6 +100,13 @@ class BDVirtualDevice
 
   private:
     BDVirtualDevice();
+
+    /**
+     * waits until the driver has finished the request
+     * @return true if the request was successful
+     */
+    bool waitForRequest(BDRequest *request);
+
     uint32 dev_number_;
     uint32 offset_;
     uint32 num_sectors_;
@@ -174,6 +174,26 @@ class File
       return 0;
     }
 
+    /**
+     * reads from the file at an absolute position,
+     * the current file position is neither used nor changed
+     * @param buffer is the buffer where the data is written to
+     * @param count is the number of bytes to read.
+     * @param position is the absolute offset in the file to read from.
+     * @return the number of bytes read, -1 if the file may not be read
+     */
+    virtual int32 pread(char *buffer, size_t count, l_off_t position);
+
+    /**
+     * writes to the file at an absolute position,
+     * the current file position is neither used nor changed
+     * @param buffer is the buffer where the data is read from
+     * @param count is the number of bytes to write.
+     * @param position is the absolute offset in the file to write to.
+     * @return the number of bytes written, -1 if the file may not be written
+     */
+    virtual int32 pwrite(const char *buffer, size_t count, l_off_t position);
+
     /**
      * Opens the file
      * @param inode is the inode the read the file from.
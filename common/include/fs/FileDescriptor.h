@@ -2,6 +2,7 @@
 
 #include "types.h"
 #include "ulist.h"
+#include "IntrusiveList.h"
 
 class File;
 class FileDescriptor;
@@ -13,6 +14,8 @@ extern ustl::list<FileDescriptor*> global_fd;
  */
 class FileDescriptor
 {
+    friend class Superblock;
+
   protected:
     /**
      * the file descriptor
@@ -24,6 +27,11 @@ class FileDescriptor
      */
     File* file_;
 
+    /**
+     * link of the list of open files of the superblock
+     */
+    IntrusiveListLink<FileDescriptor> s_files_link_;
+
   public:
     /**
      * constructor
@@ -3,6 +3,7 @@
 #include "types.h"
 #include "kprintf.h"
 #include <ulist.h>
+#include "IntrusiveList.h"
 
 class Dentry;
 class File;
@@ -39,6 +40,8 @@ class Superblock;
  */
 class Inode
 {
+    friend class Superblock;
+
   protected:
     /**
      * The dentry of this inode. (dir)
@@ -80,6 +83,13 @@ class Inode
      */
     uint32 i_state_;
 
+    /**
+     * links of the all, used and dirty inode lists of the superblock
+     */
+    IntrusiveListLink<Inode> i_all_link_;
+    IntrusiveListLink<Inode> i_used_link_;
+    IntrusiveListLink<Inode> i_dirty_link_;
+
   public:
 
     /**
@@ -123,6 +133,15 @@ class Inode
       return 0;
     }
 
+    /**
+     * makes sure every entry of the directory has a child dentry, file systems
+     * that only resolve the entries asked for in lookup read the rest here.
+     * Has to be called before walking the d_child_ list of the dentry.
+     */
+    virtual void loadChildren()
+    {
+    }
+
     /**
      * The link method should make a hard link to the name referred to by the
      * denty, which is in the directory refered to by the Inode.
@@ -268,6 +287,28 @@ class Inode
       return 0;
     }
 
+    /**
+     * sets the size of the file, data beyond the new size is dropped
+     * @param size the new size
+     * @return 0 on success, -1 if the file system does not support it
+     */
+    virtual int32 truncate(uint32 /*size*/)
+    {
+      return -1;
+    }
+
+    /**
+     * returns the physical page holding the data at the given page index so that
+     * it can be mapped into an address space without copying, a hole gets a new page
+     * @param index the page index in the file
+     * @return the physical page with a reference taken for the caller (dropped with
+     *         PageManager::freePPN), 0 if the file system does not keep its data in pages
+     */
+    virtual size_t getSharedPage(uint32 /*index*/)
+    {
+      return 0;
+    }
+
     /**
      * insert the opened file point to the file_list of this inode.
      * @param file the file to insert
@@ -2,6 +2,8 @@
 
 #include "types.h"
 #include <ulist.h>
+#include "Inode.h"
+#include "FileDescriptor.h"
 
 class Iattr;
 class Statfs;
@@ -69,25 +71,27 @@ class Superblock
 
     /**
      * A list of dirty inodes.
+     * The lists of the superblock are linked through the inodes and file
+     * descriptors, adding, removing and finding an entry take constant time.
      */
-    ustl::list<Inode*> dirty_inodes_;
+    IntrusiveList<Inode, &Inode::i_dirty_link_> dirty_inodes_;
 
     /**
      * A list of used inodes. It is only used to open-file.
      */
-    ustl::list<Inode*> used_inodes_;
+    IntrusiveList<Inode, &Inode::i_used_link_> used_inodes_;
 
     /**
      * inodes of the superblock.
      */
-    ustl::list<Inode*> all_inodes_;
+    IntrusiveList<Inode, &Inode::i_all_link_> all_inodes_;
 
     /**
      * This is a list of files (linked on f_list) of open files on this
      * file-system. It is used, for example, to check if there are any files
      * open for write before remounting the file-system as read-only.
      */
-    ustl::list<FileDescriptor*> s_files_;
+    IntrusiveList<FileDescriptor, &FileDescriptor::s_files_link_> s_files_;
 
   public:
 
@@ -130,6 +134,17 @@ class Superblock
     }
     ;
 
+    /**
+     * writes the inodes which have been marked dirty and the other metadata
+     * held in memory to the device of the file system
+     * @return 0 on success
+     */
+    virtual int32 sync()
+    {
+      return 0;
+    }
+    ;
+
     /**
      * This method is called whenever the reference count on an inode reaches 0,
      * and it is found that the link count (i_nlink= is also zero. It si
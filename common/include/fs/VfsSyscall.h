@@ -5,6 +5,26 @@
 #pragma once
 
 #include "types.h"
+#ifdef EXE2MINIXFS
+#include <sys/uio.h>
+#else
+/**
+ * one element of a scatter/gather list as passed to readv() and writev(),
+ * the layout has to match struct iovec of the userspace libc (sys/uio.h)
+ */
+struct iovec
+{
+    void* iov_base;
+    size_t iov_len;
+};
+#endif
+
+/**
+ * maximum number of elements in a scatter/gather list
+ */
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
 
 class Dirent;
 class Dentry;
@@ -118,6 +138,83 @@ class VfsSyscall
      */
     static int32 write(uint32 fd, const char *buffer, uint32 count);
 
+    /**
+     * pread() reads up to count bytes from file descriptor fd at the given
+     * position into the buffer. The file position is not changed.
+     * @param fd the file descriptor
+     * @param buffer the buffer that to read the date
+     * @param count the size of the byte
+     * @param position the absolute offset in the file
+     * @return On success, the number of bytes read is returned (zero indicates
+     *         end of file). On error, -1 is returned.
+     */
+    static int32 pread(uint32 fd, char* buffer, uint32 count, l_off_t position);
+
+    /**
+     * pwrite() writes up to count bytes from the buffer to the file referenced
+     * by the file descriptor fd at the given position. The file position is
+     * not changed.
+     * @param fd the file descriptor
+     * @param buffer the buffer that to store the date
+     * @param count the size of the byte
+     * @param position the absolute offset in the file
+     * @return On success, the number of bytes written are returned. On error,
+     *         -1 is returned
+     */
+    static int32 pwrite(uint32 fd, const char *buffer, uint32 count, l_off_t position);
+
+    /**
+     * readv() reads from the file descriptor fd into the iovcnt buffers
+     * described by iov, filling each buffer before going on to the next one.
+     * The file descriptor is only looked up once for all buffers.
+     * @param fd the file descriptor
+     * @param iov the array of buffers
+     * @param iovcnt the number of buffers
+     * @return On success, the number of bytes read is returned. On error,
+     *         -1 is returned.
+     */
+    static int32 readv(uint32 fd, const struct iovec* iov, uint32 iovcnt);
+
+    /**
+     * writev() writes the iovcnt buffers described by iov to the file
+     * descriptor fd, one buffer after the other.
+     * The file descriptor is only looked up once for all buffers.
+     * @param fd the file descriptor
+     * @param iov the array of buffers
+     * @param iovcnt the number of buffers
+     * @return On success, the number of bytes written are returned. On error,
+     *         -1 is returned
+     */
+    static int32 writev(uint32 fd, const struct iovec* iov, uint32 iovcnt);
+
+    /**
+     * copyFileRange() copies up to count bytes from fd_in to fd_out inside
+     * the kernel, the data never passes through a userspace buffer.
+     * If off_in (off_out) is 0 the file position of fd_in (fd_out) is used
+     * and advanced, otherwise the data is read (written) at *off_in (*off_out)
+     * which is then advanced while the file position is left unchanged.
+     * @param fd_in the file descriptor to read from
+     * @param off_in pointer to the read position or 0
+     * @param fd_out the file descriptor to write to
+     * @param off_out pointer to the write position or 0
+     * @param count the number of bytes to copy
+     * @return On success, the number of bytes copied is returned. On error,
+     *         -1 is returned
+     */
+    static int32 copyFileRange(uint32 fd_in, l_off_t* off_in, uint32 fd_out, l_off_t* off_out, uint32 count);
+
+    /**
+     * sendfile() copies up to count bytes from in_fd to out_fd inside the
+     * kernel, see copyFileRange().
+     * @param out_fd the file descriptor to write to
+     * @param in_fd the file descriptor to read from
+     * @param offset pointer to the read position or 0
+     * @param count the number of bytes to copy
+     * @return On success, the number of bytes copied is returned. On error,
+     *         -1 is returned
+     */
+    static int32 sendfile(uint32 out_fd, uint32 in_fd, l_off_t* offset, uint32 count);
+
     /**
      * flushes the file with the given file descriptor to the disc
      * so that changes in the system are written to disc
@@ -126,6 +223,21 @@ class VfsSyscall
      */
     static int32 flush(uint32 fd);
 
+    /**
+     * sets the size of the file with the given file descriptor,
+     * the file position is not changed
+     * @param fd the file descriptor, opened for writing
+     * @param length the new size of the file
+     * @return 0 on success, -1 on error or if the file system cannot truncate files
+     */
+    static int32 ftruncate(uint32 fd, uint32 length);
+
+    /**
+     * writes the cached metadata of all mounted file systems to the disc
+     * @return 0 on success, -1 on error
+     */
+    static int32 sync();
+
     /**
      * mounts a file system
      * @param device_name the device name i.e. ida
@@ -6,6 +6,9 @@
 
 #include "types.h"
 #include <ustl/ulist.h>
+#ifndef EXE2MINIXFS
+#include "Mutex.h"
+#endif
 
 /**
  * File system flag indicating if the system in question requires an device.
@@ -36,6 +39,11 @@ class VirtualFileSystem
      */
     ustl::list<Superblock*> superblocks_;
 
+    /**
+     * keeps superblocks from being unmounted while they are synced
+     */
+    Mutex superblocks_lock_;
+
     /**
      * List of mounted Filesystems
      */
@@ -127,6 +135,12 @@ class VirtualFileSystem
      */
     int32 rootUmount();
 
+    /**
+     * writes the cached metadata of all mounted file systems to their devices
+     * @return 0 on success, -1 if a file system failed
+     */
+    int32 sync();
+
 };
 
 extern VirtualFileSystem vfs;
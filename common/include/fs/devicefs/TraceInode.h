@@ -0,0 +1,52 @@
+/**
+ * @file TraceInode.h
+ */
+
+#pragma once
+
+#include "types.h"
+#include "fs/Inode.h"
+
+/**
+ * @class TraceInode
+ * /dev/trace, reading it drains the binary trace buffer (see Trace.h),
+ * every read returns whole TraceRecords and consumes them
+ */
+class TraceInode : public Inode
+{
+  public:
+
+    /**
+     * constructor
+     * @param super_block the superblock of the device file system
+     */
+    TraceInode(Superblock *super_block);
+
+    virtual ~TraceInode();
+
+    /**
+     * links the inode to its dentry in /dev
+     * @param dentry the dentry
+     * @return 0 on success
+     */
+    virtual int32 mknod(Dentry *dentry);
+
+    virtual File* link(uint32 flag);
+
+    virtual int32 unlink(File* file);
+
+    /**
+     * reads the records not read yet
+     * @param offset ignored, the buffer is consumed by reading
+     * @param size the size of the buffer
+     * @param buffer the destination
+     * @return the number of bytes read, a multiple of sizeof(TraceRecord)
+     */
+    virtual int32 readData(uint32 offset, uint32 size, char *buffer);
+
+    /**
+     * the trace can not be written
+     * @return -1
+     */
+    virtual int32 writeData(uint32 offset, uint32 size, const char *buffer);
+};
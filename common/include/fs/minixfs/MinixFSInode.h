@@ -6,6 +6,12 @@
 #include "MinixFSZone.h"
 #include <ulist.h>
 
+/**
+ * number of zones reserved for a file when it grows, the ones the write did
+ * not need are kept for the next write until the file is closed
+ */
+#define MINIX_PREALLOC_ZONES 8
+
 /**
  * @class MinixFSInode represents an inode on a minix file system and handles the corresponding functions
  *
@@ -26,11 +32,6 @@ class MinixFSInode : public Inode
      */
     uint32 i_num_;
 
-    /**
-     * reads all the inode's children from disc and creates their objects
-     */
-    virtual void loadChildren();
-
   public:
 
     /**
@@ -66,6 +67,12 @@ class MinixFSInode : public Inode
      */
     virtual Dentry* lookup(const char *name);
 
+    /**
+     * reads all the inode's children from disc and creates the objects of
+     * the ones lookup has not created yet
+     */
+    virtual void loadChildren();
+
     /**
      * The link method makes a hard link to the name referred to by the
      * denty, which is in the directory refered to by the Inode.
@@ -135,11 +142,16 @@ class MinixFSInode : public Inode
     virtual int32 writeData(uint32 offset, uint32 size, const char *buffer);
 
     /**
-     * flushes the inode to the file system
+     * writes the inode and the bitmaps to the file system and flushes the device (fsync)
      * @return 0 on success
      */
     virtual int32 flush();
 
+    /**
+     * gives the zones reserved for this inode but not used yet back to the file system
+     */
+    void releasePreallocation();
+
   private:
     /**
      * writes the inode dentry to disc
@@ -156,6 +168,46 @@ class MinixFSInode : public Inode
      */
     int32 findDentry(uint32 i_num);
 
+    /**
+     * reads the directory entries from disc and creates the inode and dentry
+     * objects of the entries that have no child dentry yet
+     * @param name only create the entry with this name, all entries if 0
+     * @return the dentry created for name, 0 if name is not in the directory
+     */
+    Dentry* readChildren(const char* name);
+
+    /**
+     * creates the dentry of one directory entry and loads its inode,
+     * inodes already in memory get the dentry as an additional name
+     * @param inode_index the inode number of the entry
+     * @param name the name of the entry
+     * @return the new dentry, 0 if the inode is not in use
+     */
+    Dentry* addChild(uint32 inode_index, const char* name);
+
+    /**
+     * @return true if the inode and its dentry can be dropped from memory,
+     *         it is re-read from disc by the next lookup of its name
+     */
+    bool isEvictable();
+
+    /**
+     * takes the next zone of the preallocation window, a new window of at least
+     * num_wanted zones following the last zone of the inode is reserved if it is empty
+     * @param num_wanted the number of zones the current write still needs
+     * @return the zone index
+     */
+    uint16 allocateZone(uint32 num_wanted);
+
+    /**
+     * writes a range of the inode's data to its zones, which have to be allocated,
+     * whole zones are written without reading them first
+     * @param offset the offset of the range in the inode
+     * @param size the size of the range
+     * @param buffer the data to write, 0 to write zeros
+     */
+    void writeZones(uint32 offset, uint32 size, const char *buffer);
+
     /**
      * true if the inodes children are allready loaded
      */
@@ -163,5 +215,16 @@ class MinixFSInode : public Inode
 
     ustl::list<Dentry*> other_dentries_;
 
+    /**
+     * zones reserved for the inode in the zone bitmap but not part of it yet
+     */
+    uint16 prealloc_zone_;
+    uint32 num_prealloc_zones_;
+
+    /**
+     * next inode in the same bucket of the superblock's inode table
+     */
+    MinixFSInode* hash_next_;
+
 };
 
@@ -3,6 +3,15 @@
 #include "Superblock.h"
 #include "MinixStorageManager.h"
 #include "umap.h"
+#ifndef EXE2MINIXFS
+#include "Mutex.h"
+#endif
+
+/**
+ * number of loaded inodes above which unused ones are dropped from memory
+ */
+#define MINIX_CACHED_INODES 256
+#define INODE_TABLE_INITIAL_SIZE 64
 
 class Inode;
 class MinixFSInode;
@@ -58,11 +67,24 @@ class MinixFSSuperblock : public Superblock
     virtual int32 readInode(Inode* inode);
 
     /**
-     * writes the inode from the mounted file system
+     * writes the inode to the mounted file system right away
      * @param inode the inode to write
      */
     virtual void writeInode(Inode* inode);
 
+    /**
+     * puts the inode on the dirty list, it is written by the next sync
+     * @param inode the changed inode
+     */
+    void markInodeDirty(Inode* inode);
+
+    /**
+     * writes the dirty inodes, a block of inodes at a time, and the bitmaps
+     * to the file system and flushes the device
+     * @return 0 on success
+     */
+    virtual int32 sync();
+
     /**
      * removes one inode from the file system and frees all its resources
      * @param inode the inode to delete
@@ -70,17 +92,23 @@ class MinixFSSuperblock : public Superblock
     virtual void delete_inode(Inode* inode);
 
     /**
-     * add an inode to the all_inodes_ data structures
+     * add an inode to all_inodes_ and the inode table
      * @param inode to add
      */
     void all_inodes_add_inode(Inode* inode);
 
     /**
-     * remove an inode to the all_inodes_ data structures
+     * remove an inode from all_inodes_ and the inode table
      * @param inode to remove
      */
     void all_inodes_remove_inode(Inode* inode);
 
+    /**
+     * drops unused file inodes and their dentries from memory once more than
+     * MINIX_CACHED_INODES inodes are loaded, lookup reads them again on demand
+     */
+    void evictUnusedInodes();
+
     /**
      * create a file with the given flag and a file descriptor with the given inode.
      * @param inode the inode to link the file with
@@ -95,6 +123,15 @@ class MinixFSSuperblock : public Superblock
      */
     virtual uint16 allocateZone();
 
+    /**
+     * allocates up to count zones that follow each other on the file system
+     * @param goal the zone the run should start at, 0 if any position is fine
+     * @param count the number of zones wanted
+     * @param num_allocated set to the number of zones allocated, at least 1
+     * @return the zone index of the first zone
+     */
+    uint16 allocateZones(uint16 goal, uint32 count, uint32& num_allocated);
+
     /**
      * frees zone on the file system
      * @param index the zone index
@@ -114,7 +151,7 @@ class MinixFSSuperblock : public Superblock
      * creates an Inode object with the given number from the file system
      * this overloaded version should be used; directories usually have
      * "." and ".." entries, which are pointing to already loaded inodes!!!
-     * by now this method is only called from MinixFSInode::loadChildren
+     * by now this method is only called from MinixFSInode::addChild
      * @param i_num the inode number
      * @param is_already_loaded should be set to true if already loaded
      * @return the Inode object
@@ -128,6 +165,14 @@ class MinixFSSuperblock : public Superblock
      */
     void readZone(uint16 zone, char *buffer);
 
+    /**
+     * reads zones that follow each other on the file system with one request
+     * @param zone the zone index of the first zone to read
+     * @param num_zones the number of zones to read
+     * @param buffer the buffer to write in
+     */
+    void readZones(uint16 zone, uint32 num_zones, char *buffer);
+
     /**
      * reads the given number of blocks from the file system to the given buffer
      * @param block the index of the block to start reading
@@ -143,6 +188,20 @@ class MinixFSSuperblock : public Superblock
      */
     void writeZone(uint16 zone, char *buffer);
 
+    /**
+     * writes zones that follow each other on the file system with one request
+     * @param zone the zone index of the first zone to write
+     * @param num_zones the number of zones to write
+     * @param buffer the buffer to write
+     */
+    void writeZones(uint16 zone, uint32 num_zones, const char *buffer);
+
+    /**
+     * makes the blocks written so far durable on the device,
+     * writes only reach the write cache of the drive
+     */
+    void flushDevice();
+
     /**
      * writes the given number of blcoks to the file system from the given buffer
      * @param block the index of the first block to write
@@ -180,10 +239,23 @@ class MinixFSSuperblock : public Superblock
   private:
 
     /**
-     * reads the root inode and its children from the filesystem
+     * reads the root inode from the filesystem, its children are read by lookup
      */
     void initInodes();
 
+    /**
+     * writes the given inodes and their zones holding zone addresses to the
+     * file system, inodes on the same block are written with one request
+     * @pre dirty_inodes_lock_ is held
+     * @param inodes the inodes to write, by inode number
+     */
+    void writeInodes(ustl::map<uint32, MinixFSInode*>& inodes);
+
+    /**
+     * writes the inodes on the dirty list
+     */
+    void writeDirtyInodes();
+
     /**
      * # usable inodes on the minor device
      */
@@ -223,7 +295,23 @@ class MinixFSSuperblock : public Superblock
     uint64 offset_;
 
 
-    ustl::map<uint32, Inode*> all_inodes_set_;
+    /**
+     * doubles the number of buckets of the inode table and rehashes the loaded inodes
+     */
+    void growInodeTable();
+
+    /**
+     * hash table of the loaded inodes by inode number, chained through
+     * MinixFSInode::hash_next_, the number of buckets is a power of two and
+     * grows with the number of loaded inodes so that a lookup takes constant time
+     */
+    MinixFSInode** inode_table_;
+    uint32 inode_table_size_;
+
+    /**
+     * protects dirty_inodes_ and keeps inodes from being deleted while they are written
+     */
+    Mutex dirty_inodes_lock_;
 
     /**
      * pointer to self for compatability
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "types.h"
+#ifndef EXE2MINIXFS
+#include "Mutex.h"
+#endif
 
 class MinixFSSuperblock;
 
@@ -12,6 +15,8 @@ class MinixFSSuperblock;
  * the first 7 are directly addressed to its first 7 zones
  * the 8th is the address of a zone containing the zone addresses 8 to 520
  * the 9th is the address of a zone containing the zone addresses for further zones containg the addresses 520 to 262,664
+ * the zones holding addresses are only read when an index in their range is accessed the first time,
+ * all methods take the zones lock, so a sync never writes a zone array that is being changed
  */
 class MinixFSZone
 {
@@ -50,19 +55,21 @@ class MinixFSZone
     void addZone(uint32 zone);
 
     /**
-     * returns the number of zones
+     * returns the number of zones, reads all zones holding addresses the first time
      * @return the number of zones
      */
-    uint32 getNumZones()
-    {
-      return num_zones_;
-    }
+    uint32 getNumZones();
 
     /**
-     * flushes the zones to the file system
-     * @param i_num the inode number of the inode to flush the zones to
+     * stores the direct zone addresses in the zone array of an inode as it is on the file system
+     * @param buffer the zone array of the inode
      */
-    void flush(uint32 i_num);
+    void storeZones(char *buffer);
+
+    /**
+     * writes the zones holding zone addresses to the file system if an address in them changed
+     */
+    void flush();
 
     /**
      * frees all zones, also the ones which are storing zone addresses
@@ -71,13 +78,56 @@ class MinixFSZone
 
   private:
 
+    /**
+     * @pre zones_lock_ is held
+     * @return the number of zones, reads all zones holding addresses the first time
+     */
+    uint32 countZones();
+
+    /**
+     * sets the zone address at the given index
+     * @pre zones_lock_ is held
+     * @param index the index
+     * @param zone the zone address
+     */
+    void putZone(uint32 index, uint32 zone);
+
+    /**
+     * reads the zone addresses stored in a zone
+     * @param zone the zone holding the addresses
+     * @return a new array of NUM_ZONE_ADDRESSES addresses
+     */
+    uint32 *readZoneAddresses(uint32 zone);
+
+    /**
+     * @return a new array of NUM_ZONE_ADDRESSES zero addresses
+     */
+    uint32 *emptyZoneAddresses();
+
+    /**
+     * @return the indirect zone addresses, read on first use, 0 if there is no indirect zone
+     */
+    uint32 *indirectZones();
+
+    /**
+     * @param ind_zone the index in the double indirect linking zone
+     * @return the zone addresses linked at ind_zone, read on first use, 0 if there are none
+     */
+    uint32 *doubleIndirectZones(uint32 ind_zone);
+
     MinixFSSuperblock *superblock_;
     uint32 direct_zones_[10];
+
+    // only the parts that were accessed are in memory, 0 means not read yet or not existing
     uint32 *indirect_zones_;
     uint32 *double_indirect_linking_zone_;
     uint32 **double_indirect_zones_;
 
     uint32 num_zones_;
+    bool num_zones_counted_;
+    bool addresses_changed_;
+
+    Mutex zones_lock_;
 
 };
 
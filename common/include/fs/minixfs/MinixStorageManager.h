@@ -3,6 +3,9 @@
 #include "StorageManager.h"
 #include "types.h"
 #include "minix_fs_consts.h"
+#ifndef EXE2MINIXFS
+#include "Mutex.h"
+#endif
 
 class MinixFSSuperblock;
 
@@ -38,6 +41,17 @@ class MinixStorageManager : public StorageManager
      */
     virtual size_t allocZone();
 
+    /**
+     * reserves up to count free zones that follow each other on the disc,
+     * a run starting at goal is preferred so that a growing file stays sequential,
+     * otherwise the first run of count zones or the first one of half the length and so on
+     * @param goal the zone index the run should start at, 0 if there is none
+     * @param count the number of zones wanted
+     * @param num_allocated set to the number of zones reserved, between 1 and count
+     * @return the index of the first reserved zone
+     */
+    size_t allocZones(size_t goal, size_t count, size_t& num_allocated);
+
     /**
      * returns the next free inode index and sets it as used
      * @return the inode index
@@ -70,7 +84,8 @@ class MinixStorageManager : public StorageManager
     virtual uint32 getNumUsedInodes();
 
     /**
-     * writes the bitmaps to the minix file system
+     * writes the bitmaps to the minix file system if they were changed since the last flush,
+     * the bitmaps are copied under the lock, so concurrent allocations do not tear the written blocks
      * @param superblock the superblock of the minix file system to write to
      */
     void flush(MinixFSSuperblock *superblock);
@@ -82,12 +97,30 @@ class MinixStorageManager : public StorageManager
 
   private:
 
+    /**
+     * copies the bits of the bitmap to the start of the buffer,
+     * the bits after the last one of the bitmap are set
+     * @param bitmap the inode or zone bitmap
+     * @param buffer the bitmap blocks as written to disc
+     */
+    void writeBitmap(Bitmap& bitmap, uint8* buffer);
+
     size_t curr_zone_pos_;
     size_t curr_inode_pos_;
 
     uint32 num_inode_bm_blocks_;
     uint32 num_zone_bm_blocks_;
 
+    /**
+     * true if a bit was changed since the bitmaps were read or written
+     */
+    bool changed_;
+
+    /**
+     * protects the bitmaps and the allocation positions
+     */
+    Mutex bitmap_lock_;
+
 };
 
 
@@ -6,6 +6,8 @@
 
 #include "types.h"
 #include "fs/Inode.h"
+#include "PageTree.h"
+#include "Mutex.h"
 
 /**
  * @class RamFsInode
@@ -15,9 +17,33 @@ class RamFSInode : public Inode
   protected:
 
     /**
-     * the data of the inode
+     * the pages holding the data of the file, allocated on the first write to them
      */
-    char* data_;
+    PageTree pages_;
+
+    /**
+     * protects pages_, a hole is looked up, charged and filled under it
+     */
+    Mutex pages_lock_;
+
+    /**
+     * called with pages_lock_ held before the pages for a hole of the file are allocated,
+     * the nodes of the page tree leading to it included
+     * @param num_pages the number of pages
+     * @return false if the pages must not be allocated
+     */
+    virtual bool chargePages(size_t /*num_pages*/)
+    {
+      return true;
+    }
+
+    /**
+     * called with pages_lock_ held after pages or page tree nodes of the file were freed
+     * @param num_pages the number of pages
+     */
+    virtual void unchargePages(size_t /*num_pages*/)
+    {
+    }
 
   public:
 
@@ -124,12 +150,24 @@ class RamFSInode : public Inode
     /// @return On successe, return 0. On error, return -1.
     virtual int32 readData ( uint32 offset, uint32 size, char *buffer );
 
-    /// write the data to the inode
+    /// write the data to the inode, the file grows if the data goes beyond its end,
+    /// the write stops early if no page may be allocated for a hole
     /// @param offset offset byte
-    /// @param size the size of data that write to this inode (data_)
+    /// @param size the size of data that write to this inode
     /// @buffer the src char-array
-    /// @return On successe, return 0. On error, return -1.
+    /// @return On successe, return the number of bytes written. On error, return -1.
     virtual int32 writeData ( uint32 offset, uint32 size, const char *buffer );
 
+    /// sets the size of the file, the pages beyond the new end are freed,
+    /// growing the file leaves a hole that reads as zeros
+    /// @param size the new size
+    /// @return On successe, return 0. On error, return -1.
+    virtual int32 truncate ( uint32 size );
+
+    /// returns the page holding the data at the page index with a reference taken
+    /// @param index the page index in the file
+    /// @return the physical page, 0 if the inode is no file
+    virtual size_t getSharedPage ( uint32 index );
+
 };
 
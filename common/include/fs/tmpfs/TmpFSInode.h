@@ -0,0 +1,50 @@
+/**
+ * @file TmpFSInode.h
+ */
+
+#pragma once
+
+#include "fs/ramfs/RamFSInode.h"
+
+class TmpFSSuperblock;
+
+/**
+ * @class TmpFSInode
+ * ramfs inode which takes the pages for its data from the budget of its tmpfs mount
+ */
+class TmpFSInode : public RamFSInode
+{
+  public:
+
+    /**
+     * constructor
+     * @param super_block the superblock to create the inode on
+     * @param inode_type the inode type
+     */
+    TmpFSInode(TmpFSSuperblock *super_block, uint32 inode_type);
+
+    /**
+     * @return the number of pages the file takes from the mount, the nodes of its page tree included
+     */
+    size_t getNumPages() const
+    {
+      return pages_.getNumPages() + pages_.getNumNodes();
+    }
+
+  protected:
+    /**
+     * reserves the pages for holes in the budget of the mount
+     * @param num_pages the number of pages
+     * @return false if the mount is full
+     */
+    virtual bool chargePages(size_t num_pages);
+
+    /**
+     * returns freed pages to the budget of the mount
+     * @param num_pages the number of pages
+     */
+    virtual void unchargePages(size_t num_pages);
+
+  private:
+    TmpFSSuperblock* superblock();
+};
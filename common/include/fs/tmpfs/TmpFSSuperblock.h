@@ -0,0 +1,57 @@
+/**
+ * @file TmpFSSuperblock.h
+ */
+
+#pragma once
+
+#include "fs/ramfs/RamFSSuperblock.h"
+#include "Mutex.h"
+
+/**
+ * @class TmpFSSuperblock
+ * superblock of a tmpfs mount, counts the pages of its files against a limit, the nodes of their page trees included
+ */
+class TmpFSSuperblock : public RamFSSuperblock
+{
+  public:
+
+    /**
+     * constructor
+     * @param s_root the root dentry of the new filesystem
+     * @param s_dev the device number of the new filesystem
+     * @param max_pages the number of pages the files may use
+     */
+    TmpFSSuperblock(Dentry* s_root, uint32 s_dev, size_t max_pages);
+
+    /**
+     * create a new Inode of the superblock, mknod with dentry, add in the list.
+     * @param dentry the dentry to create the new inode with
+     * @param type the inode type
+     * @return the inode
+     */
+    virtual Inode* createInode(Dentry* dentry, uint32 type);
+
+    /**
+     * removes one inode from the file system and returns its pages to the budget
+     * @param inode the inode to delete
+     */
+    virtual void delete_inode(Inode* inode);
+
+    /**
+     * takes pages from the budget of the mount
+     * @param num_pages the number of pages
+     * @return false if the limit would be exceeded, nothing is taken then
+     */
+    bool reservePages(size_t num_pages);
+
+    /**
+     * returns pages to the budget of the mount
+     * @param num_pages the number of pages
+     */
+    void releasePages(size_t num_pages);
+
+  private:
+    size_t max_pages_;
+    size_t num_pages_;
+    Mutex pages_lock_;
+};
@@ -0,0 +1,45 @@
+/**
+ * @file TmpFSType.h
+ */
+
+#pragma once
+
+#include "fs/FileSystemType.h"
+
+/**
+ * @class TmpFSType
+ * file system keeping its files in page cache pages, like ramfs but every mount
+ * may only use a limited number of pages
+ */
+class TmpFSType : public FileSystemType
+{
+  public:
+
+    /**
+     * constructor
+     * @param max_pages the number of pages each mount may use
+     */
+    TmpFSType(size_t max_pages);
+
+    /**
+     * destructor
+     */
+    virtual ~TmpFSType();
+
+    /**
+     * Reads the superblock from the device.
+     * @param superblock is the superblock to fill with data.
+     * @param data is the data given to the mount system call.
+     * @return is a pointer to the resulting superblock.
+     */
+    virtual Superblock *readSuper(Superblock *superblock, void *data) const;
+
+    /**
+     * Creates an Superblock object for the actual file system type.
+     * @return a pointer to the Superblock object
+     */
+    virtual Superblock *createSuper(Dentry *root, uint32 s_dev) const;
+
+  private:
+    size_t max_pages_;
+};
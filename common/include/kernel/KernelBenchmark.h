@@ -0,0 +1,71 @@
+/**
+ * @file KernelBenchmark.h
+ */
+
+#pragma once
+
+#include "Thread.h"
+
+class BDVirtualDevice;
+
+/**
+ * @class KernelBenchmark
+ * Kernel thread measuring primitives of the kernel with ArchCommon::getTimestamp()
+ * (cpu cycles on x86). It is started instead of the ProcessRegistry if benchmarks
+ * are selected in kernel_benchmarks.h, and starts the ProcessRegistry when done.
+ *
+ * Every measurement is written to the debug output as one line
+ *   BENCH <name> iterations=<n> cycles=<total> per_iteration=<avg> [min=<min> max=<max>] [bytes=<n>]
+ * framed by BENCH_BEGIN and BENCH_END, so runs can be compared by a script.
+ */
+class KernelBenchmark : public Thread
+{
+  public:
+    /**
+     * Constructor
+     * @param root_fs_info the FileSystemInfo
+     * @param benchmarks the names of the benchmarks to run, 0 terminated
+     * @param progs the userprograms started afterwards, handed to the ProcessRegistry
+     */
+    KernelBenchmark(FileSystemInfo *root_fs_info, char const *benchmarks[], char const *progs[]);
+
+    virtual void Run();
+
+  private:
+
+    /**
+     * per iteration timings of one benchmark
+     */
+    struct Result
+    {
+      size_t iterations;
+      uint64 total;
+      uint64 min;
+      uint64 max;
+    };
+
+    bool selected(const char* name) const;
+
+    static void begin(Result& result);
+    static void add(Result& result, uint64 cycles);
+    static void print(const char* name, Result& result, size_t bytes = 0);
+    static void printTotal(const char* name, size_t iterations, uint64 cycles);
+
+    /**
+     * runs function in a second kernel thread and returns when it finished
+     * while the calling thread executes own_part
+     */
+    void runPair(void (*function)(void*), void (*own_part)(void*), void* argument);
+
+    void benchmarkKmalloc();
+    void benchmarkPPN();
+    void benchmarkPaging();
+    void benchmarkMutex();
+    void benchmarkCondition();
+    void benchmarkYield();
+    void benchmarkBlockDevice();
+    void benchmarkBlockDeviceReads(BDVirtualDevice* device, bool random);
+
+    char const **benchmarks_;
+    char const **progs_;
+};
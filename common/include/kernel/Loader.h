@@ -10,9 +10,11 @@
 #include "Mutex.h"
 #include "ArchMemory.h"
 #include "ElfFormat.h"
+#include "VirtualMemoryArea.h"
 #include <uvector.h>
 
 class Stabs2DebugInfo;
+class File;
 
 /**
 * @class Loader manages the Addressspace creation of a thread
@@ -57,8 +59,42 @@ class Loader
      */
     void* getEntryFunction() const;
 
+    /**
+     * maps a file into the address space, its pages are mapped on the first access
+     * @param start the address wished for, taken if it is page aligned and free
+     * @param length the length of the mapping in bytes
+     * @param prot the PROT_ flags of the mapping
+     * @param flags the MAP_ flags of the mapping
+     * @param file the file to map, opened for the mapping only and closed by unmap,
+     *        0 for anonymous memory
+     * @param offset the page aligned offset in the file
+     * @return the address of the mapping, 0 if there is no free range large enough
+     */
+    pointer mapFile(pointer start, size_t length, uint32 prot, uint32 flags, File* file, size_t offset);
+
+    /**
+     * removes the mappings created by mapFile in the given range,
+     * the changed pages of shared mappings are written back to their files first
+     * @param start the page aligned start of the range
+     * @param length the length of the range in bytes
+     * @return 0 on success, -1 if the start is not page aligned
+     */
+    int32 unmap(pointer start, size_t length);
+
+    /**
+     * writes the changed pages of the shared mappings in the given range back to their files
+     * @param start the page aligned start of the range
+     * @param length the length of the range in bytes
+     * @return 0 on success, -1 if the start is not page aligned
+     */
+    int32 sync(pointer start, size_t length);
+
     ArchMemory arch_memory_;
 
+    // mappings are placed between 1.25 GiB and 1.875 GiB, above the ring and below the stack
+    static const size_t MMAP_START_PAGE = 1024 * 320;
+    static const size_t MMAP_END_PAGE = 1024 * 480;
+
   private:
 
     /**
@@ -88,5 +124,34 @@ class Loader
 
     Stabs2DebugInfo *userspace_debug_info_;
 
+    /**
+     * maps the page of a mapping created by mapFile
+     * @param virtual_address the address accessed
+     * @return false if the address does not belong to a mapping
+     */
+    bool loadMappedPage(pointer virtual_address);
+
+    /**
+     * writes the pages of a mapping that changed since they were written last back to its file
+     * @pre vmas_lock_ is held
+     * @param vma the mapping
+     * @param first the first virtual page to write back
+     * @param end the virtual page behind the last one to write back
+     */
+    void writeBack(VirtualMemoryArea* vma, size_t first, size_t end);
+
+    /**
+     * @param start_page the page wished for, 0 for any
+     * @param num_pages the number of pages
+     * @return the first page of a free range in the mapping area, 0 if there is none
+     */
+    size_t findFreeRange(size_t start_page, size_t num_pages);
+
+    /**
+     * the mappings sorted by address
+     */
+    ustl::list<VirtualMemoryArea*> vmas_;
+    Mutex vmas_lock_;
+
 };
 
@@ -2,8 +2,24 @@
 
 #include "types.h"
 
+#define LOCKSTAT_TOP 20 // locks listed by printStatistics
+
 class Thread;
 
+/**
+ * Contention counters of a lock, the times are in ArchCommon::getTimestamp() units.
+ * They are only updated by the thread holding the lock, so no extra synchronisation is needed.
+ */
+struct LockStatistics
+{
+  uint64 acquisitions;
+  uint64 contended; // acquisitions which had to wait
+  uint64 wait_total;
+  uint64 wait_max;
+  uint64 hold_total;
+  uint64 hold_max;
+};
+
 /**
  * This call represents the locks which are used to synchronize the kernel.
  */
@@ -38,6 +54,17 @@ public:
    */
   static void printHoldingList(Thread* thread);
 
+  /**
+   * Print the contention counters of the LOCKSTAT_TOP locks which were waited for
+   * the longest in total, followed by the ones held the longest in total.
+   */
+  static void printStatistics();
+
+  /**
+   * Reset the contention counters of all locks.
+   */
+  static void resetStatistics();
+
   Thread* heldBy() const
   {
     return held_by_;
@@ -53,6 +80,11 @@ public:
     return name_;
   }
 
+  inline const LockStatistics& getStatistics() const
+  {
+    return statistics_;
+  }
+
   inline bool hasNextOnHoldingList() const
   {
     return next_lock_on_holding_list_;
@@ -165,6 +197,17 @@ protected:
    */
   void printStatus();
 
+  /**
+   * Count an acquisition, has to be called by the thread which just got the lock.
+   * @param waiting_since timestamp at which the thread started to wait, 0 if it did not wait
+   */
+  void acquired(uint64 waiting_since);
+
+  /**
+   * Count the hold time, has to be called before the lock is given away.
+   */
+  void releasing();
+
 private:
 
   /**
@@ -187,6 +230,37 @@ private:
    */
   size_t waiters_list_lock_;
 
+  LockStatistics statistics_;
+
+  /**
+   * The timestamp of the last acquisition.
+   */
+  uint64 acquired_at_;
+
+  /**
+   * All constructed locks are chained for the statistics. No dynamic memory is used,
+   * as locks are created before the memory management is ready.
+   */
+  Lock* next_lock_;
+  Lock* previous_lock_;
+  static Lock* locks_;
+
+  struct StatisticsEntry
+  {
+    const char* name;
+    LockStatistics statistics;
+  };
+
+  /**
+   * Collect the LOCKSTAT_TOP locks with the largest total wait or hold time.
+   * @pre interrupts are disabled, so no lock can be created or destroyed meanwhile
+   * @return the number of entries filled, ordered by the time descending
+   */
+  static size_t collectStatistics(StatisticsEntry* top, bool by_wait);
+
+  Lock(const Lock&);
+  Lock& operator=(const Lock&);
+
   /**
    * Check if a deadlock would happen in combination with other locks.
    * @param thread_waiting The thread which wants to wait on the lock
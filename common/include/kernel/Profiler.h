@@ -0,0 +1,108 @@
+/**
+ * @file Profiler.h
+ */
+
+#pragma once
+
+#include "types.h"
+#include "Mutex.h"
+
+#define PROFILER_DEPTH 4       // frames per sample, the first one is the interrupted instruction
+#define PROFILER_BUCKETS 1024  // distinct call stacks that can be counted, must be a power of two
+#define PROFILER_TOP 30        // lines printed per section of the profile
+
+class Stabs2DebugInfo;
+
+/**
+ * @class Profiler
+ *
+ * Sampling profiler driven by the timer interrupt. Every period ticks the
+ * interrupted instruction and a short backtrace (kernel or user, whatever was
+ * interrupted) are counted in a histogram of call stacks. printProfile
+ * symbolizes the histogram with Stabs2DebugInfo and prints a flat profile and
+ * the caller -> callee edges of the call graph.
+ *
+ * Started and stopped with the profile syscall or F8 on the console, F7 prints.
+ * User samples of processes that have exited can not be symbolized anymore.
+ */
+class Profiler
+{
+  public:
+
+    /**
+     * Singleton Class Instance Access Method
+     * @pre not called from interrupt context, the instance is created on first use
+     * @return Pointer to Profiler
+     */
+    static Profiler* instance();
+
+    /**
+     * called by the timer interrupt handler, does nothing unless profiling was started
+     * @pre IF==0
+     * @param instruction_pointer the interrupted instruction
+     */
+    static void timerTick(pointer instruction_pointer);
+
+    /**
+     * forgets a debug info that is about to be deleted, samples referring to it are kept unsymbolized
+     * @param debug_info the debug info of a userspace binary
+     */
+    static void releaseDebugInfo(Stabs2DebugInfo const* debug_info);
+
+    /**
+     * starts sampling
+     * @param period take a sample every period timer ticks, at least 1
+     */
+    void start(size_t period);
+
+    /**
+     * stops sampling, the samples are kept
+     */
+    void stop();
+
+    /**
+     * @return whether samples are being taken
+     */
+    bool isRunning() const;
+
+    /**
+     * throws away all samples
+     */
+    void reset();
+
+    /**
+     * prints the flat profile and the call graph to the debug output
+     */
+    void printProfile();
+
+  private:
+
+    Profiler();
+
+    struct Bucket
+    {
+      size_t count;
+      Stabs2DebugInfo const* debug_info;
+      size_t depth;
+      pointer frames[PROFILER_DEPTH];
+    };
+
+    void sample(pointer instruction_pointer);
+    void record(Stabs2DebugInfo const* debug_info, pointer* frames, size_t depth);
+    pointer functionStart(Stabs2DebugInfo const* debug_info, pointer address) const;
+    void printFunction(Stabs2DebugInfo const* debug_info, pointer function) const;
+
+    Bucket buckets_[PROFILER_BUCKETS];
+    size_t period_;
+    size_t ticks_;
+    size_t samples_;
+    size_t dropped_;
+
+    /**
+     * keeps debug infos alive while the profile is printed
+     */
+    Mutex lock_;
+
+    static Profiler* instance_;
+};
+
@@ -8,6 +8,9 @@
 #include <ulist.h>
 #include "IdleThread.h"
 #include "CleanupThread.h"
+#include "rusage-definitions.h"
+
+#define USAGE_TOP 20 // threads listed by printUsage
 
 class Thread;
 class Mutex;
@@ -47,6 +50,12 @@ class Scheduler
      */
     void sleep();
 
+    /**
+     * puts the currentThread to sleep until the given number of timer ticks has passed
+     * @param ticks the number of ticks to sleep
+     */
+    void sleepTicks(size_t ticks);
+
     /**
      * wakes up a sleeping thread
      * @param *thread_to_wake, Pointer to the Thread that will be woken up
@@ -73,6 +82,21 @@ class Scheduler
      */
     void printLockingInformation();
 
+    /**
+     * prints the resource usage of the threads which used the most cpu time since
+     * the last call, top style, to the active terminal
+     */
+    void printUsage();
+
+    /**
+     * sums up the resource usage counters of a thread or of all threads of its process
+     * @param thread the thread
+     * @param whole_process whether the other threads sharing the address space of the thread are included
+     * @param usage the sum is stored here
+     * @param syscall_counts array of RUSAGE_SYSCALLS entries receiving the calls per syscall number, may be 0
+     */
+    void getUsage(Thread* thread, bool whole_process, ResourceUsage& usage, uint32* syscall_counts);
+
     /**
      * Sleep on a lock and release the waiters list.
      * This operations have to be done when the scheduler is disabled,
@@ -146,6 +170,11 @@ class Scheduler
 
     size_t ticks_;
 
+    /**
+     * ticks_ when printUsage was called the last time
+     */
+    size_t usage_ticks_seen_;
+
     IdleThread idle_thread_;
     CleanupThread cleanup_thread_;
 };
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "types.h"
+#include "Mutex.h"
+#include "Condition.h"
+#include "ring-definitions.h"
+
+class Loader;
+class Terminal;
+class FileSystemInfo;
+
+/**
+ * @class SubmissionRing
+ * Submission and completion queue shared between one process and the kernel.
+ * The process fills in submissions in the mapped ring pages and calls
+ * ring_enter, a kernel worker thread (@ref SubmissionRingThread) running in the
+ * address space of the process executes them and posts the completions.
+ * The kernel accesses the ring pages through their identity mapping only.
+ * The ring lives until both the process and the worker are gone, the worker
+ * keeps the address space of a dead process until it has finished.
+ */
+class SubmissionRing
+{
+  public:
+    /**
+     * first virtual page of the ring in the address space of the process
+     */
+    static const size_t USER_PAGE = 1024 * 256; // 1 GiB
+
+    /**
+     * Allocates the ring pages, maps them into the process and starts the worker
+     * @param loader the loader of the process, its address space is used by the worker
+     * @param working_dir the working directory the worker resolves paths in
+     * @param terminal the terminal of the process
+     */
+    SubmissionRing(Loader* loader, FileSystemInfo* working_dir, Terminal* terminal);
+
+    /**
+     * Deletes the address space handed over by the process, if any.
+     * The ring pages are freed together with it.
+     */
+    ~SubmissionRing();
+
+    /**
+     * Called by the dying process: stops the worker without waiting for it.
+     * A worker still running takes over the address space and the working directory,
+     * otherwise the ring is deleted right away.
+     * @pre called by the CleanupThread
+     * @param loader the loader of the process
+     * @param working_dir the working directory of the process
+     * @return true if the worker took over the loader and the working directory
+     */
+    bool detachProcess(Loader* loader, FileSystemInfo* working_dir);
+
+    /**
+     * Called when the worker thread is destroyed, deletes the ring if the process is gone as well
+     * @pre called by the CleanupThread
+     */
+    void detachWorker();
+
+    /**
+     * @return the virtual address of the ring in the process
+     */
+    pointer getUserAddress();
+
+    /**
+     * Hands the published submissions to the worker and waits for completions
+     * @param to_submit the number of submissions the process has published
+     * @param min_complete the number of completions to wait for
+     * @return the number of submissions handed to the worker, -1U if the ring is broken
+     */
+    size_t enter(size_t to_submit, size_t min_complete);
+
+    /**
+     * the worker loop, executes submissions until the ring is shut down
+     */
+    void run();
+
+    /**
+     * tells the ring that the worker is gone, may be called in interrupt context
+     */
+    void workerDied();
+
+  private:
+    RingHeader* header();
+    RingSubmission* submission(uint32 index);
+    RingCompletion* completion(uint32 index);
+
+    /**
+     * executes one request like the corresponding syscall would
+     * @param request the request
+     * @return the result of the request
+     */
+    int32 execute(const RingSubmission& request);
+
+    size_t ppns_[RING_PAGES];
+    Mutex lock_;
+    Condition work_available_;
+    Condition work_done_;
+    bool stop_;
+    bool busy_;
+    volatile bool worker_active_;
+
+    // both are only changed by the CleanupThread, so they need no lock
+    bool process_attached_;
+    bool worker_attached_;
+    Loader* loader_;
+    FileSystemInfo* working_dir_;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Thread.h"
+
+class SubmissionRing;
+
+/**
+ * @class SubmissionRingThread
+ * Kernel thread executing the requests of one @ref SubmissionRing
+ * in the address space of the owning process.
+ */
+class SubmissionRingThread : public Thread
+{
+  public:
+    /**
+     * Constructor
+     * @param ring the ring to work on
+     * @param loader the loader of the owning process
+     * @param working_dir the working directory of the owning process
+     * @param terminal the terminal of the owning process
+     */
+    SubmissionRingThread(SubmissionRing* ring, Loader* loader, FileSystemInfo* working_dir, Terminal* terminal);
+
+    virtual ~SubmissionRingThread();
+
+    virtual void kill();
+
+    virtual void Run();
+
+  private:
+    SubmissionRing* ring_;
+    Terminal* terminal_;
+};
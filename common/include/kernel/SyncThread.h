@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Thread.h"
+
+/**
+ * ticks between two syncs, about 5 seconds with the 18.2 Hz of the x86 timer
+ */
+#define SYNC_INTERVAL_TICKS 91
+
+/**
+ * @class SyncThread writes the metadata the file systems keep in memory
+ * (e.g. the dirty inodes of minixfs) to the disc every SYNC_INTERVAL_TICKS
+ */
+class SyncThread : public Thread
+{
+  public:
+    SyncThread();
+
+    virtual void Run();
+};
+
@@ -82,6 +82,142 @@ class Syscall
  */
   static size_t read(size_t fd, pointer buffer, size_t count);
 
+/**
+ * pread reads from a file at the given position without changing the file position
+ *
+ * @pre IF==1
+ * @pre pointer < 2gb
+ * @param fd File-Descriptor of an opened file (fd>2)
+ * @param buffer is a pointer to a userspace buffer
+ * @param count is the maximum number of bytes to read
+ * @param position is the absolute offset in the file
+ */
+  static size_t pread(size_t fd, pointer buffer, size_t count, size_t position);
+
+/**
+ * pwrite writes to a file at the given position without changing the file position
+ *
+ * @pre IF==1
+ * @pre pointer < 2gb
+ * @param fd File-Descriptor of an opened file (fd>2)
+ * @param buffer is a pointer to a userspace buffer
+ * @param size is the size of the buffer
+ * @param position is the absolute offset in the file
+ */
+  static size_t pwrite(size_t fd, pointer buffer, size_t size, size_t position);
+
+/**
+ * readv scatters data read from a file into several userspace buffers
+ *
+ * @pre IF==1
+ * @pre pointer < 2gb
+ * @param fd File-Descriptor as described in syscall-definitions:
+ *        fd_stdin,fd_stdout,fd_stderr or fd>2 is anything else a process has opened
+ * @param iov is a pointer to a userspace array of struct iovec
+ * @param iovcnt is the number of elements in the array
+ */
+  static size_t readv(size_t fd, pointer iov, size_t iovcnt);
+
+/**
+ * writev gathers data from several userspace buffers and writes it to a file
+ *
+ * @pre IF==1
+ * @pre pointer < 2gb
+ * @param fd File-Descriptor as described in syscall-definitions:
+ *        fd_stdin,fd_stdout,fd_stderr or fd>2 is anything else a process has opened
+ * @param iov is a pointer to a userspace array of struct iovec
+ * @param iovcnt is the number of elements in the array
+ */
+  static size_t writev(size_t fd, pointer iov, size_t iovcnt);
+
+/**
+ * lseek sets the file position of an opened file
+ *
+ * @pre IF==1
+ * @param fd File-Descriptor of an opened file (fd>2)
+ * @param offset the offset to set
+ * @param origin one of SEEK_SET, SEEK_CUR and SEEK_END
+ */
+  static size_t lseek(size_t fd, size_t offset, size_t origin);
+
+/**
+ * sendfile copies data from one file to another without passing it through userspace
+ *
+ * @pre IF==1
+ * @pre pointer < 2gb
+ * @param out_fd File-Descriptor to write to
+ * @param in_fd File-Descriptor to read from
+ * @param offset pointer to the read offset in userspace, 0 to use the file position
+ * @param count is the maximum number of bytes to copy
+ */
+  static size_t sendfile(size_t out_fd, size_t in_fd, pointer offset, size_t count);
+
+/**
+ * copy_file_range copies data from one file to another without passing it through userspace
+ *
+ * @pre IF==1
+ * @pre pointer < 2gb
+ * @param fd_in File-Descriptor to read from
+ * @param off_in pointer to the read offset in userspace, 0 to use the file position
+ * @param fd_out File-Descriptor to write to
+ * @param off_out pointer to the write offset in userspace, 0 to use the file position
+ * @param count is the maximum number of bytes to copy
+ */
+  static size_t copy_file_range(size_t fd_in, pointer off_in, size_t fd_out, pointer off_out, size_t count);
+
+/**
+ * ring_setup maps the submission ring of the process (see ring-definitions.h)
+ * into its address space and starts the kernel worker executing the submissions
+ *
+ * @pre IF==1
+ * @return the address of the ring in userspace
+ */
+  static size_t ring_setup();
+
+/**
+ * ring_enter hands submissions published in the ring to the kernel worker
+ *
+ * @pre IF==1
+ * @param to_submit the number of submissions published
+ * @param min_complete the number of completions to wait for
+ * @return the number of submissions handed to the worker, -1 if there is no usable ring
+ */
+  static size_t ring_enter(size_t to_submit, size_t min_complete);
+
+/**
+ * maps a file or anonymous memory into the address space of the process, the pages
+ * are mapped on the first access to them
+ *
+ * @pre IF==1
+ * @pre pointer < 2gb
+ * @param args pointer to a struct MmapArgs (see mman-definitions.h)
+ * @return the address of the mapping, -1 upon error
+ */
+  static size_t mmap(pointer args);
+
+/**
+ * removes the mappings in the given range
+ *
+ * @pre IF==1
+ * @pre pointer < 2gb
+ * @param start the page aligned start of the range
+ * @param length the length of the range
+ * @return 0 on success, -1 upon error
+ */
+  static size_t munmap(pointer start, size_t length);
+
+/**
+ * writes the changed pages of the shared file mappings in the given range back to their files
+ *
+ * @pre IF==1
+ * @pre pointer < 2gb
+ * @param start the page aligned start of the range
+ * @param length the length of the range
+ * @param flags MS_ASYNC or MS_SYNC, optionally with MS_INVALIDATE
+ * @return 0 on success, -1 upon error
+ */
+  static size_t msync(pointer start, size_t length, size_t flags);
+
 /**
  * close is a basic example of a method handling the close syscall
  *
@@ -91,6 +227,33 @@ class Syscall
  */
   static size_t close(size_t fd);
 
+/**
+ * writes the data and the metadata of an opened file to the disc
+ *
+ * @pre IF==1
+ * @param fd File-Descriptor of an opened file (fd>2)
+ * @return 0 on success, -1 upon error
+ */
+  static size_t fsync(size_t fd);
+
+/**
+ * writes the cached metadata of all mounted file systems to the disc
+ *
+ * @pre IF==1
+ * @return 0 on success, -1 upon error
+ */
+  static size_t sync();
+
+/**
+ * sets the size of an opened file, supported by ramfs
+ *
+ * @pre IF==1
+ * @param fd File-Descriptor of a file opened for writing (fd>2)
+ * @param length the new size of the file
+ * @return 0 on success, -1 upon error
+ */
+  static size_t ftruncate(size_t fd, size_t length);
+
 /**
  * open is a basic example of a method handling the open syscall
  *
@@ -100,6 +263,16 @@ class Syscall
  */
   static size_t open(size_t path, size_t flags);
 
+/**
+ * removes a regular file
+ *
+ * @pre IF==1
+ * @pre path < 2gb
+ * @param path the path of the file
+ * @return -1 upon error, 0 otherwise
+ */
+  static size_t unlink(size_t path);
+
 /**
  * creates a new process
  *
@@ -120,6 +293,29 @@ class Syscall
 
   static void trace();
 
+/**
+ * controls the sampling profiler, the profile is printed to the debug output
+ *
+ * @pre IF==1
+ * @param command one of PROFILE_STOP, PROFILE_START, PROFILE_PRINT and PROFILE_RESET
+ * @param period for PROFILE_START: take a sample every period timer ticks
+ * @return 0 on success, -1 for an unknown command
+ */
+  static size_t profile(size_t command, size_t period);
+
+/**
+ * copies the resource usage counters of the calling process or thread to userspace
+ *
+ * @pre IF==1
+ * @pre pointers < 2gb
+ * @param who RUSAGE_SELF or RUSAGE_THREAD
+ * @param usage pointer to a struct ResourceUsage
+ * @param syscall_counts pointer to an array of unsigned int receiving the calls per syscall number, may be 0
+ * @param num_counts the number of entries of syscall_counts
+ * @return 0 on success, -1 upon error
+ */
+  static size_t getrusage(size_t who, pointer usage, pointer syscall_counts, size_t num_counts);
+
   private:
   //helper functions
 };
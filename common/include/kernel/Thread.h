@@ -2,6 +2,7 @@
 
 #include "types.h"
 #include "fs/FileSystemInfo.h"
+#include "rusage-definitions.h"
 
 #define STACK_CANARY ((uint32)0xDEADDEAD ^ (uint32)(size_t)this)
 
@@ -123,6 +124,17 @@ class Thread
      */
     Lock* holding_lock_list_;
 
+    /**
+     * Resource usage counters, only updated by the thread itself or by the
+     * scheduler while the thread does not run.
+     */
+    ResourceUsage usage_;
+
+    /**
+     * Calls per syscall number, counted in Syscall::syscallException.
+     */
+    uint32 syscall_counts_[RUSAGE_SYSCALLS];
+
   private:
     Thread(Thread const &src);
     Thread &operator=(Thread const &src);
@@ -131,6 +143,21 @@ class Thread
 
     Terminal* my_terminal_;
 
+    /**
+     * Set by Scheduler::yield, tells schedule that the thread gives up the cpu voluntarily.
+     */
+    bool yielding_;
+
+    /**
+     * user_ticks + kernel_ticks when Scheduler::printUsage was called the last time.
+     */
+    uint64 ticks_seen_;
+
+    /**
+     * Set by Scheduler::sleepTicks, the tick at which schedule wakes the sleeping thread, 0 if none.
+     */
+    size_t wakeup_tick_;
+
   protected:
     FileSystemInfo* working_dir_;
 
@@ -3,6 +3,7 @@
 #include "Thread.h"
 
 class ProcessRegistry;
+class SubmissionRing;
 
 /**
  * @class UserProcess
@@ -27,8 +28,15 @@ class UserProcess : public Thread
 
     virtual void Run(); // not used
 
+    /**
+     * returns the submission ring of the process, it is created on first use
+     * @return the ring
+     */
+    SubmissionRing* getSubmissionRing();
+
   private:
     int32 fd_;
     ProcessRegistry *process_registry_;
+    SubmissionRing *submission_ring_;
 };
 
@@ -0,0 +1,65 @@
+/**
+ * @file VirtualMemoryArea.h
+ */
+
+#pragma once
+
+#include "types.h"
+
+class File;
+
+/**
+ * @class VirtualMemoryArea
+ * a range of pages in the address space of a process created by mmap,
+ * the pages are mapped on the first access to them.
+ * An anonymous area has no file, its pages start out zeroed.
+ */
+class VirtualMemoryArea
+{
+  public:
+
+    /**
+     * constructor
+     * @param start_page the first virtual page of the area
+     * @param num_pages the number of pages
+     * @param prot the PROT_ flags of the mapping
+     * @param flags the MAP_ flags of the mapping
+     * @param file the file mapped, opened for the area only, 0 for anonymous memory
+     * @param file_page the page index in the file mapped at the first page
+     */
+    VirtualMemoryArea(size_t start_page, size_t num_pages, uint32 prot, uint32 flags, File* file, size_t file_page) :
+        start_page_(start_page), num_pages_(num_pages), prot_(prot), flags_(flags), file_(file), file_page_(file_page),
+        write_back_(false)
+    {
+    }
+
+    /**
+     * @return the first virtual page behind the area
+     */
+    size_t endPage() const
+    {
+      return start_page_ + num_pages_;
+    }
+
+    /**
+     * @param page a virtual page
+     * @return true if the page belongs to the area
+     */
+    bool contains(size_t page) const
+    {
+      return page >= start_page_ && page < endPage();
+    }
+
+    size_t start_page_;
+    size_t num_pages_;
+    uint32 prot_;
+    uint32 flags_;
+    File* file_;
+    size_t file_page_;
+
+    /**
+     * the pages of a shared area are copies of the file,
+     * their changes have to be written back to it
+     */
+    bool write_back_;
+};
@@ -0,0 +1,13 @@
+/**
+ * @file kernel_benchmarks.h
+ */
+#pragma once
+
+// DO NOT CHANGE THE NAME OR THE TYPE OF THE kernel_benchmarks VARIABLE!
+// If the list is not empty, the benchmarks of class KernelBenchmark are run at boot
+// before the user_progs are started, "all" selects every benchmark.
+char const *kernel_benchmarks[] = {
+//                            "all",
+//                            "kmalloc", "ppn", "paging", "mutex", "condition", "yield", "blockdevice",
+                            0
+                           };
@@ -0,0 +1,35 @@
+/**
+ * @file mman-definitions.h
+ * flags and arguments of the mmap and msync syscalls,
+ * this file is included by the kernel and by the userspace library
+ */
+
+#pragma once
+
+#define PROT_NONE     0x00000000  // 00..00
+#define PROT_READ     0x00000001  // ..0001
+#define PROT_WRITE    0x00000002  // ..0010
+
+#define MAP_PRIVATE   0x00000000  // 00..00
+#define MAP_SHARED    0x40000000  // 0100..
+#define MAP_ANONYMOUS 0x80000000  // 1000..
+
+#define MAP_FAILED ((void*) -1)
+
+#define MS_ASYNC      0x00000001
+#define MS_SYNC       0x00000002
+#define MS_INVALIDATE 0x00000004
+
+/**
+ * the arguments of sc_mmap, they are passed in memory
+ * as there are more of them than a syscall takes
+ */
+struct MmapArgs
+{
+  unsigned long start;
+  unsigned long length;
+  unsigned long prot;
+  unsigned long flags;
+  unsigned long fd;
+  unsigned long offset;
+};
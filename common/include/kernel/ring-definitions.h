@@ -0,0 +1,64 @@
+/**
+ * @file ring-definitions.h
+ * layout of the submission/completion ring shared between a process and the kernel,
+ * this file is included by the kernel and by the userspace library
+ */
+
+#pragma once
+
+#define RING_PAGES 4
+#define RING_SQ_ENTRIES 256
+#define RING_CQ_ENTRIES 256
+
+// page 0 holds the ring header, pages 1 and 2 the submissions, page 3 the completions
+#define RING_SQ_OFFSET 0x1000
+#define RING_CQ_OFFSET 0x3000
+
+#define RING_OP_NOP 0
+#define RING_OP_READ 1
+#define RING_OP_WRITE 2
+#define RING_OP_OPEN 3
+#define RING_OP_CLOSE 4
+#define RING_OP_LSEEK 5
+
+// read/write at offset instead of the file position (pread/pwrite semantics)
+#define RING_F_OFFSET 0x1
+
+/**
+ * the producer of a queue only advances its tail, the consumer only its head,
+ * both are free running and reduced modulo the number of entries
+ */
+struct RingHeader
+{
+  volatile unsigned int sq_head;
+  volatile unsigned int sq_tail;
+  volatile unsigned int cq_head;
+  volatile unsigned int cq_tail;
+  unsigned int sq_entries;
+  unsigned int cq_entries;
+};
+
+/**
+ * one request, addr is a buffer (read/write) or a path (open), len is the byte
+ * count (read/write), the open flags (open) or the seek origin (lseek)
+ */
+struct RingSubmission
+{
+  unsigned int opcode;
+  int fd;
+  unsigned int addr;
+  unsigned int len;
+  unsigned int offset;
+  unsigned int flags;
+  unsigned long long user_data;
+};
+
+/**
+ * the result of one request, res is what the corresponding syscall would have returned
+ */
+struct RingCompletion
+{
+  unsigned long long user_data;
+  int res;
+  unsigned int flags;
+};
@@ -0,0 +1,29 @@
+/**
+ * @file rusage-definitions.h
+ * resource usage counters returned by the getrusage syscall,
+ * this file is included by the kernel and by the userspace library
+ */
+
+#pragma once
+
+// who of getrusage
+#define RUSAGE_SELF 0   // all threads of the calling process
+#define RUSAGE_THREAD 1 // the calling thread only
+
+// syscall numbers below this are counted one by one
+#define RUSAGE_SYSCALLS 432
+
+/**
+ * the counters of a thread, the ticks are timer interrupts
+ */
+struct ResourceUsage
+{
+  unsigned long long user_ticks;
+  unsigned long long kernel_ticks;
+  unsigned long long voluntary_switches;   // gave up the cpu by sleeping or yielding
+  unsigned long long involuntary_switches; // preempted by the timer
+  unsigned long long page_faults;
+  unsigned long long syscalls;
+  unsigned long long bytes_read;
+  unsigned long long bytes_written;
+};
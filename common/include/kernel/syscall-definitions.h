@@ -28,6 +28,7 @@
 //....
 #define sc_nice 34
 //....
+#define sc_sync 36
 #define sc_kill 37
 //....
 #define sc_rename 38
@@ -43,21 +44,46 @@
 //....
 #define sc_dup2 63
 //....
+#define sc_getrusage 77
+//....
 #define sc_reboot 88
 //....
+#define sc_mmap 90
+#define sc_munmap 91
+//....
+#define sc_ftruncate 93
+//....
+#define sc_profile 98
+//....
 #define sc_outline 105
 //....
 #define sc_ipc 117
+#define sc_fsync 118
 //....
 #define sc_clone 120
 //....
 #define sc_flock 143
 #define sc_msync 144
+#define sc_readv 145
+#define sc_writev 146
 //....
 #define sc_sched_yield 158
 //....
+#define sc_pread 180
+#define sc_pwrite 181
+#define sc_sendfile 187
+//....
 #define sc_vfork 190
 #define sc_createprocess 191
 
 #define sc_trace 252
+#define sc_copy_file_range 377
+#define sc_ring_setup 425
+#define sc_ring_enter 426
+
 
+// commands of sc_profile
+#define PROFILE_STOP 0
+#define PROFILE_START 1
+#define PROFILE_PRINT 2
+#define PROFILE_RESET 3
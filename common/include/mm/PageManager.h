@@ -30,10 +30,19 @@ class PageManager
     /**
      * marks physical page <page_number> as free, if it was used in
      * user or kernel space.
+     * A page with references taken by refPPN only loses one reference.
      * @param page_number Physcial Page to mark as unused
      */
     void freePPN(uint32 page_number, uint32 page_size = PAGE_SIZE);
 
+    /**
+     * takes an additional reference to a used 4k page, so that it can be mapped
+     * in several places (e.g. the page cache and address spaces) and each of them
+     * frees it with freePPN, the page is only marked as free with the last one
+     * @param page_number Physical Page to share
+     */
+    void refPPN(uint32 page_number);
+
     Thread* heldBy()
     {
       return lock_.heldBy();
@@ -47,17 +56,15 @@ class PageManager
     }
 
   private:
-    /**
-     * used internally to mark pages as reserved
-     * @param ppn
-     * @param num
-     * @return
-     */
-    bool reservePages(uint32 ppn, uint32 num = 1);
-
     PageManager(PageManager const&);
 
     Bitmap* page_usage_table_;
+
+    /**
+     * additional references per page taken by refPPN,
+     * allocated with the first shared page
+     */
+    uint16* page_refs_;
     uint32 number_of_pages_;
     uint32 lowest_unreserved_page_;
 
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "types.h"
+#include "paging-definitions.h"
+
+/**
+ * @class PageTree
+ * radix tree mapping the page indices of a file to physical pages of the PageManager,
+ * the nodes of the tree are physical pages themselves, each holding
+ * PAGE_TREE_FANOUT physical page numbers of the level below.
+ * An index without a page is a hole and reads as zeros.
+ * The tree is as high as the largest index needs, a single level covers the first
+ * PAGE_TREE_FANOUT pages.
+ */
+class PageTree
+{
+  public:
+    static const size_t PAGE_TREE_FANOUT = PAGE_SIZE / sizeof(size_t);
+
+    PageTree();
+
+    /**
+     * frees all pages of the tree
+     */
+    ~PageTree();
+
+    /**
+     * returns the physical page at the given index
+     * @param index the page index in the file
+     * @param create allocate a zeroed page (and the nodes leading to it) if there is none
+     * @return the physical page number, 0 if there is no page at the index
+     */
+    size_t getPage(size_t index, bool create);
+
+    /**
+     * @param index the page index in the file
+     * @return the number of pages getPage(index, true) allocates, nodes included
+     */
+    size_t getNumMissingPages(size_t index) const;
+
+    /**
+     * frees all pages from the given index on, and the nodes that become empty
+     * @param first the index of the first page to free
+     */
+    void freePages(size_t first);
+
+    /**
+     * @return the number of pages holding data, without the nodes of the tree
+     */
+    size_t getNumPages() const
+    {
+      return num_pages_;
+    }
+
+    /**
+     * @return the number of pages the nodes of the tree take
+     */
+    size_t getNumNodes() const
+    {
+      return num_nodes_;
+    }
+
+  private:
+    PageTree(PageTree const&);
+
+    /**
+     * @param height the height of a subtree
+     * @return the number of page indices a subtree of the given height covers
+     */
+    static size_t capacity(uint32 height);
+
+    /**
+     * frees the pages from the given index on in a subtree
+     * @param node the physical page of the subtree's node
+     * @param height the height of the subtree, 1 if the node holds data pages
+     * @param start the index of the first page the subtree covers
+     * @param first the index of the first page to free
+     * @return true if the subtree is empty afterwards
+     */
+    bool freeRange(size_t node, uint32 height, size_t start, size_t first);
+
+    size_t root_;
+    uint32 height_;
+    size_t num_pages_;
+    size_t num_nodes_;
+};
@@ -4,6 +4,11 @@
 
 #define BITMAP_BYTE_COUNT(number_of_bits) (number_of_bits / Bitmap::bits_per_bitmap_atom_ + ((number_of_bits % Bitmap::bits_per_bitmap_atom_ > 0) ? 1 : 0))
 
+/**
+ * @class Bitmap stores its bits in machine words, bit n is bit n % (8 * sizeof(size_t))
+ * of word n / (8 * sizeof(size_t)). The searches look at a whole word at a time.
+ * The static functions work on plain byte arrays (BITMAP_BYTE_COUNT bytes), e.g. before the heap exists.
+ */
 class Bitmap
 {
   public:
@@ -22,6 +27,35 @@ class Bitmap
     bool unsetBit(size_t bit_number);
     static bool unsetBit(uint8* b, size_t& num_bits_set, size_t bit_number);
 
+    /**
+     * sets the bits first_bit to first_bit + num_bits - 1
+     * @param first_bit the number of the first bit
+     * @param num_bits the number of bits to set
+     */
+    void setRange(size_t first_bit, size_t num_bits);
+
+    /**
+     * unsets the bits first_bit to first_bit + num_bits - 1
+     * @param first_bit the number of the first bit
+     * @param num_bits the number of bits to unset
+     */
+    void clearRange(size_t first_bit, size_t num_bits);
+
+    /**
+     * @param from the number of the first bit to look at
+     * @return the number of the first unset bit at or after from, -1 if there is none
+     */
+    size_t findFirstZero(size_t from = 0);
+
+    /**
+     * searches for num_bits unset bits in a row
+     * @param num_bits the length of the run
+     * @param align the number of the first bit of the run has to be a multiple of align
+     * @param from the number of the first bit to look at
+     * @return the number of the first bit of the run, -1 if there is none
+     */
+    size_t findZeroRun(size_t num_bits, size_t align = 1, size_t from = 0);
+
     size_t getSize();
 
     /**
@@ -58,9 +92,40 @@ class Bitmap
      */
     uint8 getByte(size_t byte_number);
 
+    /**
+     * copies the first num_bits bits from a byte array (bit n is bit n % 8 of byte n / 8)
+     * @param bytes the byte array
+     * @param num_bits the number of bits to copy, at most getSize()
+     */
+    void setBytes(const uint8* bytes, size_t num_bits);
+
+    /**
+     * copies the bitmap to a byte array of BITMAP_BYTE_COUNT(getSize()) bytes,
+     * the bits after the last one of the bitmap are left unset
+     * @param bytes the byte array
+     */
+    void getBytes(uint8* bytes);
+
   private:
+
+    /**
+     * sets or unsets the bits of one word selected by mask and counts the changed bits
+     */
+    void setWordBits(size_t word_number, size_t mask, bool value);
+
+    /**
+     * sets or unsets num_bits bits starting at first_bit, a word at a time
+     */
+    void changeRange(size_t first_bit, size_t num_bits, bool value);
+
+    /**
+     * @return the number of the first set bit from from to to - 1, to if there is none
+     */
+    size_t findFirstOne(size_t from, size_t to);
+
     size_t size_;
     size_t num_bits_set_;
-    uint8 *bitmap_;
+    size_t num_words_;
+    size_t *bitmap_;
 };
 
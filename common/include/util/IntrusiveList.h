@@ -0,0 +1,158 @@
+/**
+ * @file IntrusiveList.h
+ */
+#pragma once
+
+#include "types.h"
+#include "assert.h"
+
+/**
+ * the pointers an element needs to be on an IntrusiveList,
+ * one link member per list the element can be on at the same time
+ */
+template<class T>
+struct IntrusiveListLink
+{
+    IntrusiveListLink() : prev_(0), next_(0)
+    {
+    }
+
+    T* prev_;
+    T* next_;
+};
+
+/**
+ * @class IntrusiveList
+ * doubly linked list through a link member of its elements,
+ * push_back, remove and contains take constant time and never allocate memory.
+ * The interface follows ustl::list so that it can replace a list of pointers.
+ * The current element may be removed (and deleted) while iterating over the list.
+ */
+template<class T, IntrusiveListLink<T> T::*LINK>
+class IntrusiveList
+{
+  public:
+
+    class iterator
+    {
+      public:
+        iterator(T* element) : element_(element), next_(element ? (element->*LINK).next_ : 0)
+        {
+        }
+
+        T* operator*() const
+        {
+          return element_;
+        }
+
+        iterator& operator++()
+        {
+          element_ = next_;
+          next_ = element_ ? (element_->*LINK).next_ : 0;
+          return *this;
+        }
+
+        bool operator!=(const iterator& other) const
+        {
+          return element_ != other.element_;
+        }
+
+      private:
+        T* element_;
+        T* next_; // read before the current element may be removed
+    };
+
+    IntrusiveList() : head_(0), tail_(0), size_(0)
+    {
+    }
+
+    /**
+     * appends an element
+     * @pre the element is not on the list
+     * @param element the element
+     */
+    void push_back(T* element)
+    {
+      IntrusiveListLink<T>& link = element->*LINK;
+      assert(!contains(element));
+      link.prev_ = tail_;
+      link.next_ = 0;
+      if (tail_)
+        (tail_->*LINK).next_ = element;
+      else
+        head_ = element;
+      tail_ = element;
+      ++size_;
+    }
+
+    /**
+     * removes an element, does nothing if it is not on the list
+     * @param element the element
+     */
+    void remove(T* element)
+    {
+      if (!contains(element))
+        return;
+      IntrusiveListLink<T>& link = element->*LINK;
+      if (link.prev_)
+        (link.prev_->*LINK).next_ = link.next_;
+      else
+        head_ = link.next_;
+      if (link.next_)
+        (link.next_->*LINK).prev_ = link.prev_;
+      else
+        tail_ = link.prev_;
+      link.prev_ = 0;
+      link.next_ = 0;
+      --size_;
+    }
+
+    /**
+     * @param element the element
+     * @return true if the element is on the list
+     */
+    bool contains(T* element) const
+    {
+      return (element->*LINK).prev_ || head_ == element;
+    }
+
+    /**
+     * removes all elements
+     */
+    void clear()
+    {
+      while (head_)
+        remove(head_);
+    }
+
+    T* front() const
+    {
+      return head_;
+    }
+
+    size_t size() const
+    {
+      return size_;
+    }
+
+    bool empty() const
+    {
+      return size_ == 0;
+    }
+
+    iterator begin() const
+    {
+      return iterator(head_);
+    }
+
+    iterator end() const
+    {
+      return iterator(0);
+    }
+
+  private:
+    T* head_;
+    T* tail_;
+    size_t size_;
+};
+
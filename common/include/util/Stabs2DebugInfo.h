@@ -1,6 +1,6 @@
 #pragma once
 
-#include "umap.h"
+#include "uvector.h"
 
 
 // The limit for function names, after that, they will get capped
@@ -18,6 +18,7 @@ public:
   ssize_t getFunctionLine(pointer start, pointer offset) const;
   void getCallNameAndLine(pointer address, const char*& mangled_name, ssize_t &line) const;
   pointer getFunctionName(pointer address, char function_name[], size_t size)  const;
+  pointer getFunctionStart(pointer address) const;
   void printCallInformation(pointer address) const;
 
   void printAllFunctions() const;
@@ -26,6 +27,22 @@ private:
 
   void initialiseSymbolTable();
 
+  struct FunctionSymbol
+  {
+    pointer start;
+    StabEntry const *stab;
+    size_t lines_begin; // range of the function in line_symbols_
+    size_t lines_end;
+  };
+
+  struct LineSymbol
+  {
+    size_t offset; // largest offset of the line entries of the function up to this one
+    size_t line;
+  };
+
+  FunctionSymbol const *findFunction(pointer address) const;
+  bool findLine(FunctionSymbol const *function, size_t offset, ssize_t &line) const;
 
   bool tryPasteOoperator(const char *& input, char *& buffer, size_t& size) const;
   int readNumber(const char *& input) const;
@@ -39,5 +56,10 @@ private:
   StabEntry const *stab_end_;
   char const *stabstr_buffer_;
 
-  ustl::map<size_t, StabEntry const*> function_symbols_;
+  /**
+   * functions sorted by their start address and the line entries of all
+   * functions, built once so that an address is resolved by binary search
+   */
+  ustl::vector<FunctionSymbol> function_symbols_;
+  ustl::vector<LineSymbol> line_symbols_;
 };
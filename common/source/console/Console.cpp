@@ -3,6 +3,8 @@
 #include "KeyboardManager.h"
 #include "Scheduler.h"
 #include "PageManager.h"
+#include "Profiler.h"
+#include "Lock.h"
 #include "backtrace.h"
 
 Console* main_console;
@@ -41,6 +43,25 @@ void Console::handleKey(uint32 key)
 // else...
   switch (key)
   {
+    case KEY_F5:
+      Scheduler::instance()->printUsage();
+      break;
+
+    case KEY_F6:
+      Lock::resetStatistics();
+      break;
+
+    case KEY_F7:
+      Profiler::instance()->printProfile();
+      break;
+
+    case KEY_F8:
+      if (Profiler::instance()->isRunning())
+        Profiler::instance()->stop();
+      else
+        Profiler::instance()->start(1);
+      break;
+
     case KEY_F9:
       PageManager::instance()->printBitmap();
       break;
@@ -111,6 +132,7 @@ void Console::Run(void)
         handleKey(key);
       }
     }
+    consoleFlush();
     Scheduler::instance()->yield();
   } while (1);
 }
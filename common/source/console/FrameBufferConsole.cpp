@@ -8,8 +8,11 @@
 #include "KeyboardManager.h"
 #include "kprintf.h"
 #include "Scheduler.h"
+#include "ArchInterrupts.h"
 #include "kstring.h"
 
+size_t FrameBufferConsole::glyph_masks_[256][GLYPH_WORDS];
+
 FrameBufferConsole::FrameBufferConsole(uint32 num_terminals) :
     Console(num_terminals, "VESAConsoleThread")
 {
@@ -17,6 +20,43 @@ FrameBufferConsole::FrameBufferConsole(uint32 num_terminals) :
   y_res_ = ArchCommon::getVESAConsoleHeight();
   bits_per_pixel_ = ArchCommon::getVESAConsoleBitsPerPixel();
   bytes_per_pixel_ = bits_per_pixel_ / 8;
+  num_rows_ = y_res_ / GLYPH_HEIGHT;
+  num_columns_ = x_res_ / GLYPH_WIDTH;
+
+  cells_ = new uint16[num_rows_ * num_columns_];
+  memset(cells_, 0, num_rows_ * num_columns_ * sizeof(uint16));
+  first_row_ = 0;
+  damage_begin_ = new uint32[num_rows_];
+  damage_end_ = new uint32[num_rows_];
+  damaged_ = false;
+  for (uint32 row = 0; row < num_rows_; ++row)
+  {
+    damage_begin_[row] = num_columns_;
+    damage_end_[row] = 0;
+  }
+
+  const uint32 pixels_per_word = sizeof(size_t) / sizeof(uint16);
+  for (uint32 color = 0; color < 16; ++color)
+  {
+    size_t word = 0;
+    for (uint32 pixel = 0; pixel < pixels_per_word; ++pixel)
+      word = (word << 16) | convertConsoleColor((CONSOLECOLOR) color);
+    colors_[color] = word;
+  }
+  for (uint32 pattern = 0; pattern < 256; ++pattern)
+  {
+    for (uint32 word = 0; word < GLYPH_WORDS; ++word)
+    {
+      size_t mask = 0;
+      for (uint32 pixel = 0; pixel < pixels_per_word; ++pixel)
+      {
+        // the leftmost pixel is the highest bit of the font byte and the lowest address
+        if (pattern & (0x80 >> (word * pixels_per_word + pixel)))
+          mask |= (size_t) 0xFFFF << (pixel * 16);
+      }
+      glyph_masks_[pattern][word] = mask;
+    }
+  }
 
   uint32 i, j = 10, log = 1, k = 0, l = 0;
 
@@ -53,16 +93,24 @@ FrameBufferConsole::FrameBufferConsole(uint32 num_terminals) :
 void FrameBufferConsole::consoleClearScreen()
 {
   memset((void*) ArchCommon::getVESAConsoleLFBPtr(), 0, x_res_ * y_res_ * bytes_per_pixel_);
+  memset(cells_, 0, num_rows_ * num_columns_ * sizeof(uint16));
+  // the framebuffer already matches the cleared cells
+  for (uint32 row = 0; row < num_rows_; ++row)
+  {
+    damage_begin_[row] = num_columns_;
+    damage_end_[row] = 0;
+  }
+  damaged_ = false;
 }
 
 uint32 FrameBufferConsole::consoleGetNumRows() const
 {
-  return y_res_ / 16;
+  return num_rows_;
 }
 
 uint32 FrameBufferConsole::consoleGetNumColumns() const
 {
-  return x_res_ / 8;
+  return num_columns_;
 }
 
 extern uint8 fontdata_sun8x16[];
@@ -81,54 +129,92 @@ void FrameBufferConsole::setPixel(uint32 x, uint32 y, uint8 r, uint8 g, uint8 b)
 uint32 FrameBufferConsole::consoleSetCharacter(uint32 const &row, uint32 const&column, uint8 const &character,
                                                uint8 const &state)
 {
-  CONSOLECOLOR fg, bg;
-  colorsFromState(state, fg, bg);
-  uint16 bg_color = convertConsoleColor(bg);
-  uint16 fg_color = convertConsoleColor(fg);
-  uint32 i, k;
-  uint32 character_index = character * 16;
+  uint16 value = character | (state << 8);
+  uint16 &current = cell(row, column);
+  if (current != value)
+  {
+    current = value;
+    damage(row, column, column + 1);
+  }
+  drawDamageIfSynchronous();
 
-  uint16 *lfb = (uint16*) ArchCommon::getVESAConsoleLFBPtr();
+  return 0;
+}
 
-  uint32 top_left_pixel = column * 8 + row * 16 * x_res_;
+void FrameBufferConsole::consoleScrollUp(uint8 const &state)
+{
+  first_row_ = (first_row_ + 1) % num_rows_;
+  for (uint32 column = 0; column < num_columns_; ++column)
+    cell(num_rows_ - 1, column) = ' ' | (state << 8);
 
-  for (i = 0; i < 16; ++i)
-  {
+  // every row moved on the screen
+  for (uint32 row = 0; row < num_rows_; ++row)
+    damage(row, 0, num_columns_);
+  drawDamageIfSynchronous();
+}
 
-    for (k = 0; k < 8; ++k)
-    {
-      // find out the bit we want to draw
-      uint8 temp = fontdata_sun8x16[character_index + i];
-      temp &= 1 << (7 - k);
-      if (temp)
-      {
-        lfb[top_left_pixel + k + i * x_res_] = fg_color;
-      }
-      else
-      {
-        lfb[top_left_pixel + k + i * x_res_] = bg_color;
-      }
-    }
+void FrameBufferConsole::consoleFlush()
+{
+  if (!damaged_)
+    return;
+  lockConsoleForDrawing();
+  drawDamage();
+  unLockConsoleForDrawing();
+}
 
-  }
+uint16 &FrameBufferConsole::cell(uint32 row, uint32 column)
+{
+  uint32 ring_row = row + first_row_;
+  if (ring_row >= num_rows_)
+    ring_row -= num_rows_;
+  return cells_[ring_row * num_columns_ + column];
+}
 
-  return 0;
+void FrameBufferConsole::damage(uint32 row, uint32 begin, uint32 end)
+{
+  if (begin < damage_begin_[row])
+    damage_begin_[row] = begin;
+  if (end > damage_end_[row])
+    damage_end_[row] = end;
+  damaged_ = true;
 }
 
-void FrameBufferConsole::consoleScrollUp(uint8 const &state)
+void FrameBufferConsole::drawDamageIfSynchronous()
+{
+  // nobody else would draw before the console thread runs again
+  if (system_state != RUNNING || !ArchInterrupts::testIFSet())
+    drawDamage();
+}
+
+void FrameBufferConsole::drawDamage()
 {
-  CONSOLECOLOR fg, bg;
-  colorsFromState(state, fg, bg);
-  uint16 bg_color = convertConsoleColor(bg);
-  pointer fb = ArchCommon::getVESAConsoleLFBPtr();
-  uint16* fb16 = (uint16*)fb;
-  memcpy((void*) fb, (void*) (fb + (consoleGetNumColumns() * bytes_per_pixel_ * 8 * 16)),
-         (consoleGetNumRows() - 1) * consoleGetNumColumns() * bytes_per_pixel_ * 8 * 16);
-
-  for(uint32 index = ((consoleGetNumRows() - 1) * consoleGetNumColumns() * bytes_per_pixel_ * 8 * 16) / 2;
-      index < x_res_ * y_res_; index++)
+  damaged_ = false;
+  for (uint32 row = 0; row < num_rows_; ++row)
+  {
+    for (uint32 column = damage_begin_[row]; column < damage_end_[row]; ++column)
+      drawCell(row, column);
+    damage_begin_[row] = num_columns_;
+    damage_end_[row] = 0;
+  }
+}
+
+void FrameBufferConsole::drawCell(uint32 row, uint32 column)
+{
+  uint16 value = cell(row, column);
+  uint8 const *glyph = fontdata_sun8x16 + (value & 0xFF) * GLYPH_HEIGHT;
+  size_t foreground = colors_[(value >> 8) & 15];
+  size_t background = colors_[value >> 12];
+  size_t line_size = x_res_ * bytes_per_pixel_;
+
+  uint8 *line = (uint8*) ArchCommon::getVESAConsoleLFBPtr() + row * GLYPH_HEIGHT * line_size
+      + column * GLYPH_WIDTH * bytes_per_pixel_;
+  for (uint32 i = 0; i < GLYPH_HEIGHT; ++i)
   {
-    fb16[index] = bg_color;
+    size_t const *mask = glyph_masks_[glyph[i]];
+    size_t *words = (size_t*) line;
+    for (uint32 word = 0; word < GLYPH_WORDS; ++word)
+      words[word] = (foreground & mask[word]) | (background & ~mask[word]);
+    line += line_size;
   }
 }
 
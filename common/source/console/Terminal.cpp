@@ -11,8 +11,8 @@
 
 Terminal::Terminal(char *name, Console *console, uint32 num_columns, uint32 num_rows) :
     CharacterDevice(name), console_(console), num_columns_(num_columns), num_rows_(num_rows), len_(
-        num_rows * num_columns), current_column_(0), current_state_(0x93), active_(0), mutex_("Terminal::mutex_"), layout_(
-        EN)
+        num_rows * num_columns), first_row_(0), batching_(false), batch_scrolls_(0), current_column_(0),
+    current_state_(0x93), active_(0), mutex_("Terminal::mutex_"), layout_(EN)
 {
   characters_ = new uint8[len_];
   character_states_ = new uint8[len_];
@@ -109,11 +109,13 @@ void Terminal::writeString(char const *string)
 {
   MutexLock lock(mutex_);
   console_->lockConsoleForDrawing();
+  beginBatch();
   while (string && *string)
   {
     writeInternal(*string);
     ++string;
   }
+  endBatch();
   console_->unLockConsoleForDrawing();
 }
 
@@ -130,12 +132,14 @@ void Terminal::writeBuffer(char const *buffer, size_t len)
 {
   MutexLock lock(mutex_);
   console_->lockConsoleForDrawing();
+  beginBatch();
   while (len)
   {
     writeInternal(*buffer);
     ++buffer;
     --len;
   }
+  endBatch();
   console_->unLockConsoleForDrawing();
 }
 
@@ -160,11 +164,20 @@ uint32 Terminal::getNumColumns() const
   return num_columns_;
 }
 
+uint32 Terminal::cellIndex(uint32 row, uint32 column) const
+{
+  uint32 ring_row = row + first_row_;
+  if (ring_row >= num_rows_)
+    ring_row -= num_rows_;
+  return column + ring_row * num_columns_;
+}
+
 uint32 Terminal::setCharacter(uint32 row, uint32 column, uint8 character)
 {
-  characters_[column + row * num_columns_] = character;
-  character_states_[column + row * num_columns_] = current_state_;
-  if (active_)
+  uint32 index = cellIndex(row, column);
+  characters_[index] = character;
+  character_states_[index] = current_state_;
+  if (active_ && !batching_)
     console_->consoleSetCharacter(row, column, character, current_state_);
 
   return 0;
@@ -199,42 +212,65 @@ void Terminal::initTerminalColors(Console::CONSOLECOLOR fg, Console::CONSOLECOLO
 
 void Terminal::scrollUp()
 {
-  uint32 i, k, runner;
+  uint32 i, runner;
 
-  runner = 0;
-  for (i = 0; i < num_rows_ - 1; ++i)
-  {
-    for (k = 0; k < num_columns_; ++k)
-    {
-      characters_[runner] = characters_[runner + num_columns_];
-      character_states_[runner] = character_states_[runner + num_columns_];
-      ++runner;
-    }
-  }
+  // the top row becomes the new bottom row
+  runner = first_row_ * num_columns_;
+  first_row_ = (first_row_ + 1) % num_rows_;
   for (i = 0; i < num_columns_; ++i)
   {
     characters_[runner] = 0;
     character_states_[runner] = 0;
     ++runner;
   }
-  if (active_)
+  if (batching_)
+    ++batch_scrolls_;
+  else if (active_)
     console_->consoleScrollUp(current_state_);
 
 }
-void Terminal::fullRedraw()
+
+void Terminal::beginBatch()
+{
+  batching_ = true;
+  batch_scrolls_ = 0;
+}
+
+void Terminal::endBatch()
+{
+  batching_ = false;
+  if (!active_)
+    return;
+
+  if (batch_scrolls_ >= num_rows_ - 1)
+  {
+    drawRows(0);
+    return;
+  }
+
+  for (uint32 i = 0; i < batch_scrolls_; ++i)
+    console_->consoleScrollUp(current_state_);
+  // the row that was written to before the first scroll and every row scrolled in since
+  drawRows(num_rows_ - 1 - batch_scrolls_);
+}
+
+void Terminal::drawRows(uint32 first)
 {
-  console_->lockConsoleForDrawing();
   uint32 i, k;
-  uint32 runner = 0;
-  for (i = 0; i < num_rows_; ++i)
+  for (i = first; i < num_rows_; ++i)
   {
     for (k = 0; k < num_columns_; ++k)
     {
-      console_->consoleSetCharacter(i, k, characters_[runner], character_states_[runner]);
-      ++runner;
+      uint32 index = cellIndex(i, k);
+      console_->consoleSetCharacter(i, k, characters_[index], character_states_[index]);
     }
   }
+}
 
+void Terminal::fullRedraw()
+{
+  console_->lockConsoleForDrawing();
+  drawRows(0);
   console_->unLockConsoleForDrawing();
 }
 
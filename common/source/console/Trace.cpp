@@ -0,0 +1,61 @@
+/**
+ * @file Trace.cpp
+ */
+
+#include "Trace.h"
+#include "ArchCommon.h"
+#include "ArchThreads.h"
+#include "kstring.h"
+
+TraceRecord Trace::records_[TRACE_RECORDS];
+size_t Trace::head_ = 0;
+size_t Trace::tail_ = 0;
+
+void Trace::write(size_t flag, const char* flag_name, const char* format, const uint64* args, size_t num_args)
+{
+  size_t index = __sync_fetch_and_add(&head_, 1);
+  TraceRecord& record = records_[index % TRACE_RECORDS];
+  record.sequence = 0;
+  asm volatile("" : : : "memory");
+
+  record.timestamp = ArchCommon::getTimestamp();
+  record.format = (size_t) format;
+  record.flag_name = (size_t) flag_name;
+  record.thread = (size_t) currentThread;
+  record.flag = flag;
+  record.num_args = num_args;
+  if (num_args > TRACE_MAX_ARGS)
+    num_args = TRACE_MAX_ARGS;
+  for (size_t i = 0; i < num_args; ++i)
+    record.args[i] = args[i];
+
+  asm volatile("" : : : "memory");
+  record.sequence = index + 1;
+}
+
+size_t Trace::read(char* buffer, size_t size)
+{
+  size_t copied = 0;
+  while (copied + sizeof(TraceRecord) <= size && tail_ != head_)
+  {
+    size_t head = head_;
+    if (head - tail_ > TRACE_RECORDS)
+      tail_ = head - TRACE_RECORDS; // overwritten before they were read
+
+    TraceRecord& record = records_[tail_ % TRACE_RECORDS];
+    TraceRecord* copy = (TraceRecord*) (buffer + copied);
+    memcpy(copy, &record, sizeof(TraceRecord));
+    asm volatile("" : : : "memory");
+
+    if (copy->sequence < tail_ + 1)
+      break; // still being written
+    if (copy->sequence > tail_ + 1 || record.sequence != copy->sequence)
+    {
+      ++tail_; // overwritten while copying
+      continue;
+    }
+    copied += sizeof(TraceRecord);
+    ++tail_;
+  }
+  return copied;
+}
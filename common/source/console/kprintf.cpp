@@ -16,16 +16,34 @@
 RingBuffer<char> *nosleep_rb_;
 Thread *flush_thread_;
 
+#define KPRINTF_LINE_LENGTH 128
+
+/**
+ * characters collected by kprintf, handed to the terminal a line at a time
+ */
+struct KprintfLine
+{
+  char buffer[KPRINTF_LINE_LENGTH];
+  size_t length;
+};
+
 void flushActiveConsole()
 {
   assert(main_console);
   assert(nosleep_rb_);
   assert(ArchInterrupts::testIFSet());
-  char c = 0;
-  while (nosleep_rb_->get(c))
+  char buffer[KPRINTF_LINE_LENGTH];
+  size_t length = 0;
+  while (nosleep_rb_->get(buffer[length]))
   {
-    main_console->getActiveTerminal()->write(c);
+    if (++length == sizeof(buffer))
+    {
+      main_console->getActiveTerminal()->writeBuffer(buffer, length);
+      length = 0;
+    }
   }
+  if (length)
+    main_console->getActiveTerminal()->writeBuffer(buffer, length);
   Scheduler::instance()->yield();
 }
 
@@ -54,27 +72,42 @@ void kprintf_init()
   Scheduler::instance()->addNewThread(flush_thread_);
 }
 
-void kprintf_func(int ch, void *arg __attribute__((unused)))
+void kprintf_flush(KprintfLine *line)
 {
+  if (!line->length)
+    return;
   //check if atomar or not in current context
   if ((ArchInterrupts::testIFSet() && Scheduler::instance()->isSchedulingEnabled())
       || (main_console->areLocksFree() && main_console->getActiveTerminal()->isLockFree()))
   {
-    main_console->getActiveTerminal()->write(ch);
+    main_console->getActiveTerminal()->writeBuffer(line->buffer, line->length);
   }
   else
   {
-    nosleep_rb_->put(ch);
+    for (size_t i = 0; i < line->length; ++i)
+      nosleep_rb_->put(line->buffer[i]);
   }
+  line->length = 0;
+}
+
+void kprintf_func(int ch, void *arg)
+{
+  KprintfLine *line = (KprintfLine*) arg;
+  line->buffer[line->length++] = ch;
+  if (ch == '\n' || line->length == sizeof(line->buffer))
+    kprintf_flush(line);
 }
 
 void kprintf(const char *fmt, ...)
 {
   va_list args;
+  KprintfLine line;
+  line.length = 0;
 
   va_start(args, fmt);
-  kvprintf(fmt, kprintf_func, 0, 10, args);
+  kvprintf(fmt, kprintf_func, &line, 10, args);
   va_end(args);
+  kprintf_flush(&line);
 }
 
 void kprintfd_func(int ch, void *arg __attribute__((unused)))
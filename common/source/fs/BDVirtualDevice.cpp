@@ -44,68 +44,77 @@ void BDVirtualDevice::addRequest(BDRequest * command)
 }
 ;
 
-int32 BDVirtualDevice::readData(uint32 offset, uint32 size, char *buffer)
+bool BDVirtualDevice::waitForRequest(BDRequest* request)
 {
-  assert(buffer);
-  assert(offset % block_size_ == 0 && "we can only read multiples of block_size_ from the device");
-  assert(size % block_size_ == 0 && "we can only read multiples of block_size_ from the device");
-  debug(BD_VIRT_DEVICE, "readData\n");
-  uint32 blocks2read = size / block_size_, jiffies = 0;
-  uint32 blockoffset = offset / block_size_;
-
-  debug(BD_VIRT_DEVICE, "blocks2read %d\n", blocks2read);
-  BDRequest bd(dev_number_, BDRequest::BD_READ, blockoffset, blocks2read, buffer);
-  addRequest(&bd);
-
+  uint32 jiffies = 0;
   if (driver_->irq != 0)
   {
     bool interrupt_context = ArchInterrupts::disableInterrupts();
     ArchInterrupts::enableInterrupts();
 
-    while (bd.getStatus() == BDRequest::BD_QUEUED && jiffies++ < IO_TIMEOUT)
+    while (request->getStatus() == BDRequest::BD_QUEUED && jiffies++ < IO_TIMEOUT)
       ArchInterrupts::yieldIfIFSet();
 
     if (!interrupt_context)
       ArchInterrupts::disableInterrupts();
   }
 
-  if (bd.getStatus() != BDRequest::BD_DONE)
+  return request->getStatus() == BDRequest::BD_DONE;
+}
+
+int32 BDVirtualDevice::readData(uint32 offset, uint32 size, char *buffer)
+{
+  assert(buffer);
+  assert(offset % block_size_ == 0 && "we can only read multiples of block_size_ from the device");
+  assert(size % block_size_ == 0 && "we can only read multiples of block_size_ from the device");
+  debug(BD_VIRT_DEVICE, "readData\n");
+  uint32 blocks2read = size / block_size_;
+  uint32 blockoffset = offset / block_size_;
+  uint32 max_blocks = Max(BD_MAX_REQUEST_SECTORS / (block_size_ / sector_size_), 1U);
+
+  debug(BD_VIRT_DEVICE, "blocks2read %d\n", blocks2read);
+  for (uint32 blocks_done = 0; blocks_done < blocks2read;)
   {
-    return -1;
+    uint32 num_blocks = Min(blocks2read - blocks_done, max_blocks);
+    BDRequest bd(dev_number_, BDRequest::BD_READ, blockoffset + blocks_done, num_blocks,
+                 buffer + blocks_done * block_size_);
+    addRequest(&bd);
+    if (!waitForRequest(&bd))
+      return -1;
+    blocks_done += num_blocks;
   }
   return size;
 }
-;
 
 int32 BDVirtualDevice::writeData(uint32 offset, uint32 size, char *buffer)
 {
   assert(offset % block_size_ == 0 && "we can only write multiples of block_size_ to the device");
   assert(size % block_size_ == 0 && "we can only write multiples of block_size_ to the device");
   debug(BD_VIRT_DEVICE, "writeData\n");
-  uint32 blocks2write = size / block_size_, jiffies = 0;
+  uint32 blocks2write = size / block_size_;
   uint32 blockoffset = offset / block_size_;
+  uint32 max_blocks = Max(BD_MAX_REQUEST_SECTORS / (block_size_ / sector_size_), 1U);
 
-  BDRequest bd(dev_number_, BDRequest::BD_WRITE, blockoffset, blocks2write, buffer);
-  addRequest(&bd);
-
-  if (driver_->irq != 0)
+  for (uint32 blocks_done = 0; blocks_done < blocks2write;)
   {
-    bool interrupt_context = ArchInterrupts::disableInterrupts();
-    ArchInterrupts::enableInterrupts();
-
-    while (bd.getStatus() == BDRequest::BD_QUEUED && jiffies++ < IO_TIMEOUT)
-      ArchInterrupts::yieldIfIFSet();
-
-    if (!interrupt_context)
-      ArchInterrupts::disableInterrupts();
+    uint32 num_blocks = Min(blocks2write - blocks_done, max_blocks);
+    BDRequest bd(dev_number_, BDRequest::BD_WRITE, blockoffset + blocks_done, num_blocks,
+                 buffer + blocks_done * block_size_);
+    addRequest(&bd);
+    if (!waitForRequest(&bd))
+      return -1;
+    blocks_done += num_blocks;
   }
+  return size;
+}
 
-  if (bd.getStatus() != BDRequest::BD_DONE)
-    return -1;
-  else
-    return size;
+int32 BDVirtualDevice::flush()
+{
+  debug(BD_VIRT_DEVICE, "flush\n");
+  BDRequest bd(dev_number_, BDRequest::BD_FLUSH);
+  addRequest(&bd);
+  return waitForRequest(&bd) ? 0 : -1;
 }
-;
 
 void BDVirtualDevice::setPartitionType(uint8 part_type)
 {
@@ -24,3 +24,25 @@ l_off_t File::lseek(l_off_t offset, uint8 origin)
 
   return offset_;
 }
+
+int32 File::pread(char *buffer, size_t count, l_off_t position)
+{
+  if (((flag_ == O_RDONLY) || (flag_ == O_RDWR)) && (mode_ & A_READABLE))
+    return f_inode_->readData(position, count, buffer);
+  else
+  {
+    // ERROR_FF
+    return -1;
+  }
+}
+
+int32 File::pwrite(const char *buffer, size_t count, l_off_t position)
+{
+  if (((flag_ == O_WRONLY) || (flag_ == O_RDWR)) && (mode_ & A_WRITABLE))
+    return f_inode_->writeData(position, count, buffer);
+  else
+  {
+    // ERROR_FF
+    return -1;
+  }
+}
@@ -17,10 +17,14 @@
 #ifndef EXE2MINIXFS
 #include "Mutex.h"
 #include "Thread.h"
+#include "fs/ramfs/RamFSType.h"
+#include "fs/tmpfs/TmpFSType.h"
+#include "PageManager.h"
 #endif
 
 #define SEPARATOR '/'
 #define CHAR_DOT '.'
+#define COPY_CHUNK_SIZE (16U * 1024U)
 
 extern FileSystemInfo* default_working_dir;
 
@@ -132,6 +136,7 @@ Dirent* VfsSyscall::readdir(const char* pathname)
       return (Dirent*) 0;
     }
 
+    pw_dentry->getInode()->loadChildren();
     debug(VFSSYSCALL, "listing dir %s:\n", pw_dentry->getName());
     for (Dentry* sub_dentry : pw_dentry->d_child_)
     {
@@ -378,6 +383,161 @@ int32 VfsSyscall::write(uint32 fd, const char *buffer, uint32 count)
   return file_descriptor->getFile()->write(buffer, count, 0);
 }
 
+int32 VfsSyscall::pread(uint32 fd, char* buffer, uint32 count, l_off_t position)
+{
+  FileDescriptor* file_descriptor = getFileDescriptor(fd);
+
+  if (file_descriptor == 0)
+  {
+    debug(VFSSYSCALL, "(pread) Error: the fd does not exist.\n");
+    return -1;
+  }
+
+  if (count == 0)
+    return 0;
+  return file_descriptor->getFile()->pread(buffer, count, position);
+}
+
+int32 VfsSyscall::pwrite(uint32 fd, const char *buffer, uint32 count, l_off_t position)
+{
+  FileDescriptor* file_descriptor = getFileDescriptor(fd);
+
+  if (file_descriptor == 0)
+  {
+    debug(VFSSYSCALL, "(pwrite) Error: the fd does not exist.\n");
+    return -1;
+  }
+
+  if (count == 0)
+    return 0;
+  return file_descriptor->getFile()->pwrite(buffer, count, position);
+}
+
+int32 VfsSyscall::readv(uint32 fd, const struct iovec* iov, uint32 iovcnt)
+{
+  FileDescriptor* file_descriptor = getFileDescriptor(fd);
+
+  if (file_descriptor == 0)
+  {
+    debug(VFSSYSCALL, "(readv) Error: the fd does not exist.\n");
+    return -1;
+  }
+
+  File* file = file_descriptor->getFile();
+  int32 total = 0;
+  for (uint32 i = 0; i < iovcnt; ++i)
+  {
+    if (iov[i].iov_len == 0)
+      continue;
+    int32 num_read = file->read((char*) iov[i].iov_base, iov[i].iov_len, 0);
+    if (num_read < 0)
+      return total ? total : -1;
+    total += num_read;
+    if ((size_t) num_read < iov[i].iov_len)
+      break; // end of file
+  }
+  return total;
+}
+
+int32 VfsSyscall::writev(uint32 fd, const struct iovec* iov, uint32 iovcnt)
+{
+  FileDescriptor* file_descriptor = getFileDescriptor(fd);
+
+  if (file_descriptor == 0)
+  {
+    debug(VFSSYSCALL, "(writev) Error: the fd does not exist.\n");
+    return -1;
+  }
+
+  File* file = file_descriptor->getFile();
+  int32 total = 0;
+  for (uint32 i = 0; i < iovcnt; ++i)
+  {
+    if (iov[i].iov_len == 0)
+      continue;
+    int32 written = file->write((const char*) iov[i].iov_base, iov[i].iov_len, 0);
+    if (written < 0)
+      return total ? total : -1;
+    total += written;
+    if ((size_t) written < iov[i].iov_len)
+      break;
+  }
+  return total;
+}
+
+int32 VfsSyscall::copyFileRange(uint32 fd_in, l_off_t* off_in, uint32 fd_out, l_off_t* off_out, uint32 count)
+{
+  FileDescriptor* in_descriptor = getFileDescriptor(fd_in);
+  FileDescriptor* out_descriptor = getFileDescriptor(fd_out);
+
+  if (in_descriptor == 0 || out_descriptor == 0)
+  {
+    debug(VFSSYSCALL, "(copyFileRange) Error: the fd does not exist.\n");
+    return -1;
+  }
+
+  File* in_file = in_descriptor->getFile();
+  File* out_file = out_descriptor->getFile();
+  l_off_t in_pos = off_in ? *off_in : in_file->lseek(0, SEEK_CUR);
+  l_off_t out_pos = off_out ? *off_out : out_file->lseek(0, SEEK_CUR);
+
+  if (in_file->getInode() == out_file->getInode() && in_pos < out_pos + count && out_pos < in_pos + count)
+  {
+    debug(VFSSYSCALL, "(copyFileRange) Error: source and destination overlap.\n");
+    return -1;
+  }
+  if (count == 0)
+    return 0;
+
+  // the only copy of the data: the inode reads whole zones straight into this
+  // buffer and writes them straight out of it again
+  uint32 chunk_size = count < COPY_CHUNK_SIZE ? count : COPY_CHUNK_SIZE;
+  char* chunk = new char[chunk_size];
+  int32 total = 0;
+  while ((uint32) total < count)
+  {
+    uint32 to_copy = count - total < chunk_size ? count - total : chunk_size;
+    int32 num_read = in_file->pread(chunk, to_copy, in_pos);
+    if (num_read <= 0)
+    {
+      if (num_read < 0 && total == 0)
+        total = -1;
+      break;
+    }
+    int32 written = out_file->pwrite(chunk, num_read, out_pos);
+    if (written <= 0)
+    {
+      if (written < 0 && total == 0)
+        total = -1;
+      break;
+    }
+    in_pos += written;
+    out_pos += written;
+    total += written;
+    if (written < num_read)
+      break;
+  }
+  delete[] chunk;
+
+  if (total > 0)
+  {
+    if (off_in)
+      *off_in = in_pos;
+    else
+      in_file->lseek(in_pos, SEEK_SET);
+    if (off_out)
+      *off_out = out_pos;
+    else
+      out_file->lseek(out_pos, SEEK_SET);
+  }
+  return total;
+}
+
+int32 VfsSyscall::sendfile(uint32 out_fd, uint32 in_fd, l_off_t* offset, uint32 count)
+{
+  return copyFileRange(in_fd, offset, out_fd, 0, count);
+}
+
 l_off_t VfsSyscall::lseek(uint32 fd, l_off_t offset, uint8 origin)
 {
   FileDescriptor* file_descriptor = getFileDescriptor(fd);
@@ -404,6 +564,26 @@ int32 VfsSyscall::flush(uint32 fd)
   return file_descriptor->getFile()->flush();
 }
 
+int32 VfsSyscall::ftruncate(uint32 fd, uint32 length)
+{
+  FileDescriptor* file_descriptor = getFileDescriptor(fd);
+
+  if (file_descriptor == 0)
+  {
+    debug(VFSSYSCALL, "(ftruncate) Error: the fd does not exist.\n");
+    return -1;
+  }
+
+  File* file = file_descriptor->getFile();
+  if (file->getFlag() == O_RDONLY)
+  {
+    debug(VFSSYSCALL, "(ftruncate) Error: the file is not opened for writing.\n");
+    return -1;
+  }
+
+  return file->getInode()->truncate(length);
+}
+
 #ifndef EXE2MINIXFS
 int32 VfsSyscall::mount(const char *device_name, const char *dir_name, const char *file_system_name, int32 flag)
 {
@@ -412,6 +592,15 @@ int32 VfsSyscall::mount(const char *device_name, const char *dir_name, const cha
   {
     assert(vfs.registerFileSystem(new MinixFSType()) == 0);
   }
+  else if (!type && strcmp(file_system_name, "ramfs") == 0)
+  {
+    assert(vfs.registerFileSystem(new RamFSType()) == 0);
+  }
+  else if (!type && strcmp(file_system_name, "tmpfs") == 0)
+  {
+    // like on linux every mount may fill half of the memory
+    assert(vfs.registerFileSystem(new TmpFSType(PageManager::instance()->getTotalNumPages() / 2)) == 0);
+  }
   else if (!type)
     return -1; // file system type not known
 
@@ -422,6 +611,11 @@ int32 VfsSyscall::umount(const char *dir_name, int32 flag)
 {
   return vfs.umount(dir_name, flag);
 }
+
+int32 VfsSyscall::sync()
+{
+  return vfs.sync();
+}
 #endif
 uint32 VfsSyscall::getFileSize(uint32 fd)
 {
@@ -20,7 +20,7 @@ void VirtualFileSystem::initialize()
   new (this) VirtualFileSystem();
 }
 
-VirtualFileSystem::VirtualFileSystem()
+VirtualFileSystem::VirtualFileSystem() : superblocks_lock_("VirtualFileSystem::superblocks_lock_")
 {
 }
 
@@ -96,6 +96,7 @@ FileSystemInfo *VirtualFileSystem::root_mount(const char *fs_name, uint32 /*flag
 
   VfsMount *root_mount = new VfsMount(0, mount_point, root, super, 0);
 
+  MutexLock lock(superblocks_lock_);
   mounts_.push_back(root_mount);
   superblocks_.push_back(super);
 
@@ -149,6 +150,7 @@ int32 VirtualFileSystem::mount(const char* dev_name, const char* dir_name, const
 
   // create a new vfs_mount
   VfsMount *std_mount = new VfsMount(found_vfs_mount, found_dentry, root, super, 0);
+  MutexLock lock(superblocks_lock_);
   mounts_.push_back(std_mount);
   superblocks_.push_back(super);
   return 0;
@@ -163,7 +165,9 @@ int32 VirtualFileSystem::rootUmount()
   VfsMount *root_vfs_mount = mounts_.at(0);
   delete root_vfs_mount;
 
+  MutexLock lock(superblocks_lock_);
   Superblock *root_sb = superblocks_.at(0);
+  superblocks_.remove(root_sb);
   delete root_sb;
   return 0;
 }
@@ -212,10 +216,24 @@ int32 VirtualFileSystem::umount(const char* dir_name, uint32 /*flags*/)
 
   Superblock *sb = found_vfs_mount->getSuperblock();
 
+  MutexLock lock(superblocks_lock_);
   mounts_.remove(found_vfs_mount);
+  superblocks_.remove(sb);
   delete found_vfs_mount;
   delete sb;
 
   return 0;
 }
 
+int32 VirtualFileSystem::sync()
+{
+  MutexLock lock(superblocks_lock_);
+  int32 result = 0;
+  for (Superblock* sb : superblocks_)
+  {
+    if (sb->sync() != 0)
+      result = -1;
+  }
+  return result;
+}
+
@@ -4,6 +4,7 @@
 
 #include "fs/devicefs/DeviceFSSuperblock.h"
 #include "fs/ramfs/RamFSInode.h"
+#include "fs/devicefs/TraceInode.h"
 #include "fs/Dentry.h"
 #include "fs/Inode.h"
 #include "fs/File.h"
@@ -52,6 +53,8 @@ DeviceFSSuperBlock::DeviceFSSuperBlock(Dentry* s_root, uint32 s_dev) :
   s_dev_dentry_ = device_root_dentry;
 
   cDevice = 0;
+
+  addDevice(new TraceInode(this), "trace");
 }
 
 DeviceFSSuperBlock::~DeviceFSSuperBlock()
@@ -60,17 +63,17 @@ DeviceFSSuperBlock::~DeviceFSSuperBlock()
 
   for (FileDescriptor* fd : s_files_)
   {
+    s_files_.remove(fd);
     delete fd->getFile();
     delete fd;
   }
-  s_files_.clear();
 
   for (Inode* inode : all_inodes_)
   {
+    all_inodes_.remove(inode);
     delete inode->getDentry();
     delete inode;
   }
-  all_inodes_.clear();
 }
 
 void DeviceFSSuperBlock::addDevice(Inode* device, const char* device_name)
@@ -115,7 +118,7 @@ int32 DeviceFSSuperBlock::createFd(Inode* inode, uint32 flag)
   s_files_.push_back(fd);
   FileDescriptor::add(fd);
 
-  if (ustl::find(used_inodes_, inode) == used_inodes_.end())
+  if (!used_inodes_.contains(inode))
   {
     used_inodes_.push_back(inode);
   }
@@ -0,0 +1,52 @@
+/**
+ * @file TraceInode.cpp
+ */
+
+#include "fs/devicefs/TraceInode.h"
+#include "fs/ramfs/RamFSFile.h"
+#include "fs/Dentry.h"
+#include "Trace.h"
+
+TraceInode::TraceInode(Superblock *super_block) :
+    Inode(super_block, I_CHARDEVICE)
+{
+}
+
+TraceInode::~TraceInode()
+{
+}
+
+int32 TraceInode::mknod(Dentry *dentry)
+{
+  if (dentry == 0)
+    return -1;
+
+  i_dentry_ = dentry;
+  dentry->setInode(this);
+  return 0;
+}
+
+File* TraceInode::link(uint32 flag)
+{
+  File* file = (File*) (new RamFSFile(this, i_dentry_, flag));
+  i_files_.push_back(file);
+  return file;
+}
+
+int32 TraceInode::unlink(File* file)
+{
+  i_files_.remove(file);
+  delete file;
+  return 0;
+}
+
+int32 TraceInode::readData(uint32 __attribute__((unused)) offset, uint32 size, char *buffer)
+{
+  return Trace::read(buffer, size);
+}
+
+int32 TraceInode::writeData(uint32 __attribute__((unused)) offset, uint32 __attribute__((unused)) size,
+                            const char __attribute__((unused)) *buffer)
+{
+  return -1;
+}
@@ -8,7 +8,8 @@
 #include "Dentry.h"
 
 MinixFSInode::MinixFSInode(Superblock *super_block, uint32 inode_type) :
-    Inode(super_block, inode_type), i_zones_(0), i_num_(0), children_loaded_(false)
+    Inode(super_block, inode_type), i_zones_(0), i_num_(0), children_loaded_(false), prealloc_zone_(0),
+    num_prealloc_zones_(0), hash_next_(0)
 {
   debug(M_INODE, "Simple Constructor\n");
   i_size_ = 0;
@@ -19,7 +20,7 @@ MinixFSInode::MinixFSInode(Superblock *super_block, uint32 inode_type) :
 MinixFSInode::MinixFSInode(Superblock *super_block, uint16 i_mode, uint32 i_size, uint16 i_nlinks, uint32* i_zones,
                            uint32 i_num) :
     Inode(super_block, 0), i_zones_(new MinixFSZone((MinixFSSuperblock*) super_block, i_zones)), i_num_(i_num),
-    children_loaded_(false)
+    children_loaded_(false), prealloc_zone_(0), num_prealloc_zones_(0), hash_next_(0)
 {
   i_size_ = i_size;
   i_nlink_ = i_nlinks;
@@ -40,13 +41,13 @@ MinixFSInode::MinixFSInode(Superblock *super_block, uint16 i_mode, uint32 i_size
   }
   // (hard/sym link/...) not handled!
 
-  debug(M_INODE, "Constructor: size: %d\tnlink: %d\tnum zones: %d\tmode: %x\n", i_size_, i_nlink_,
-        i_zones_->getNumZones(), i_mode);
+  debug(M_INODE, "Constructor: size: %d\tnlink: %d\tmode: %x\n", i_size_, i_nlink_, i_mode);
 }
 
 MinixFSInode::~MinixFSInode()
 {
   debug(M_INODE, "Destructor\n");
+  assert(num_prealloc_zones_ == 0);
   delete i_zones_;
 
   while (!other_dentries_.empty())
@@ -69,19 +70,36 @@ int32 MinixFSInode::readData(uint32 offset, uint32 size, char *buffer)
   }
   uint32 start_zone = offset / ZONE_SIZE;
   uint32 zone_offset = offset % ZONE_SIZE;
-  uint32 num_zones = (zone_offset + size) / ZONE_SIZE + 1;
+  uint32 num_zones = (zone_offset + size + ZONE_SIZE - 1) / ZONE_SIZE;
   char rbuffer[ZONE_SIZE];
 
   uint32 index = 0;
   debug(M_INODE, "readData: zone: %d, zone_offset %d, num_zones: %d\n", start_zone, zone_offset, num_zones);
   for (uint32 zone = start_zone; zone < start_zone + num_zones; zone++)
   {
-    memset(rbuffer, 0, sizeof(rbuffer));
-    ((MinixFSSuperblock *) superblock_)->readZone(i_zones_->getZone(zone), rbuffer);
     uint32 count = size - index;
     uint32 zone_diff = ZONE_SIZE - zone_offset;
     count = count < zone_diff ? count : zone_diff;
-    memcpy(buffer + index, rbuffer + zone_offset, count);
+    if (count == ZONE_SIZE)
+    {
+      // whole zones requested, read the ones following each other on disc
+      // with one request straight into the destination
+      uint32 first = i_zones_->getZone(zone);
+      uint32 run = 1;
+      while (size - index >= (run + 1) * ZONE_SIZE && i_zones_->getZone(zone + run) == first + run)
+        ++run;
+      ((MinixFSSuperblock *) superblock_)->readZones(first, run, buffer + index);
+      index += run * ZONE_SIZE;
+      zone += run - 1;
+      zone_offset = 0;
+      continue;
+    }
+    else
+    {
+      memset(rbuffer, 0, sizeof(rbuffer));
+      ((MinixFSSuperblock *) superblock_)->readZone(i_zones_->getZone(zone), rbuffer);
+      memcpy(buffer + index, rbuffer + zone_offset, count);
+    }
     index += count;
     zone_offset = 0;
   }
@@ -91,67 +109,78 @@ int32 MinixFSInode::readData(uint32 offset, uint32 size, char *buffer)
 int32 MinixFSInode::writeData(uint32 offset, uint32 size, const char *buffer)
 {
   debug(M_INODE, "MinixFSInode writeData> offset: %d, size: %d, i_size_: %d\n", offset, size, i_size_);
-  uint32 zone = offset / ZONE_SIZE;
-  uint32 num_zones = (offset % ZONE_SIZE + size) / ZONE_SIZE + 1;
-  uint32 last_used_zone = i_size_ / ZONE_SIZE;
-  uint32 last_zone = last_used_zone;
-  if ((size + offset) > i_size_)
+  uint32 end = (size + offset) > i_size_ ? size + offset : i_size_;
+  uint32 num_zones = i_zones_->getNumZones();
+  uint32 num_needed_zones = (end + ZONE_SIZE - 1) / ZONE_SIZE;
+  if (end > i_size_)
+    ((MinixFSSuperblock *) superblock_)->markInodeDirty(this);
+  for (; num_zones < num_needed_zones; num_zones++)
   {
-    uint32 num_new_zones = (size + offset - i_size_) / ZONE_SIZE + 1;
-    for (uint32 new_zones = 0; new_zones < num_new_zones; new_zones++, last_zone++)
-    {
-      MinixFSSuperblock* sb = (MinixFSSuperblock*) superblock_;
-      debug(M_INODE, "writeData: allocating new Zone\n");
-      uint16 new_zone = sb->allocateZone();
-      i_zones_->setZone(i_zones_->getNumZones(), new_zone);
-    }
+    debug(M_INODE, "writeData: allocating new Zone\n");
+    uint16 new_zone = allocateZone(num_needed_zones - num_zones);
+    i_zones_->setZone(num_zones, new_zone);
   }
   if (offset > i_size_)
   {
     debug(M_INODE, "writeData: have to clean memory\n");
-    uint32 zone_size_offset = i_size_ % ZONE_SIZE;
-    char fill_buffer[ZONE_SIZE];
-    memset(fill_buffer, 0, sizeof(fill_buffer));
-    if (zone_size_offset)
-    {
-      readData(i_size_ - zone_size_offset, zone_size_offset, fill_buffer);
-      ((MinixFSSuperblock *) superblock_)->writeZone(last_used_zone, fill_buffer);
-    }
-    ++last_used_zone;
-    for (; last_used_zone <= offset / ZONE_SIZE; last_used_zone++)
-    {
-      memset(fill_buffer, 0, sizeof(fill_buffer));
-      ((MinixFSSuperblock *) superblock_)->writeZone(last_used_zone, fill_buffer);
-    }
-    --last_used_zone;
+    writeZones(i_size_, offset - i_size_, 0);
     i_size_ = offset;
   }
-  uint32 zone_offset = offset % ZONE_SIZE;
-  char* wbuffer_array = new char[num_zones * ZONE_SIZE];
-  char* wbuffer = wbuffer_array;
-  memset((void*) wbuffer, 0, num_zones * ZONE_SIZE);
-  debug(M_INODE, "writeData: reading data at the beginning of zone: offset-zone_offset: %d,zone_offset: %d\n",
-        offset - zone_offset, zone_offset);
-  readData(offset - zone_offset, zone_offset, wbuffer);
-  for (uint32 index = 0, pos = zone_offset; index < size; pos++, index++)
-  {
-    wbuffer[pos] = buffer[index];
-  }
-  for (uint32 zone_index = 0; zone_index < num_zones; zone_index++)
-  {
-    debug(M_INODE, "writeData: writing zone_index: %d, i_zones_->getZone(zone) : %d\n", zone_index,
-          i_zones_->getZone(zone));
-    ((MinixFSSuperblock *) superblock_)->writeZone(i_zones_->getZone(zone_index + zone), wbuffer);
-    wbuffer += ZONE_SIZE;
-  }
+  writeZones(offset, size, buffer);
   if (i_size_ < offset + size)
   {
     i_size_ = offset + size;
   }
-  delete[] wbuffer_array;
   return size;
 }
 
+void MinixFSInode::writeZones(uint32 offset, uint32 size, const char *buffer)
+{
+  MinixFSSuperblock* sb = (MinixFSSuperblock*) superblock_;
+  char wbuffer[ZONE_SIZE];
+  uint32 index = 0;
+  while (index < size)
+  {
+    uint32 zone = (offset + index) / ZONE_SIZE;
+    uint32 zone_offset = (offset + index) % ZONE_SIZE;
+    uint32 count = size - index;
+    uint32 zone_diff = ZONE_SIZE - zone_offset;
+    count = count < zone_diff ? count : zone_diff;
+    debug(M_INODE, "writeZones: writing zone_index: %d, i_zones_->getZone(zone) : %d\n", zone,
+          i_zones_->getZone(zone));
+    if (count < ZONE_SIZE)
+    {
+      // partial head or tail zone, keep the bytes around the written range
+      memset(wbuffer, 0, sizeof(wbuffer));
+      if (zone * ZONE_SIZE < i_size_)
+        sb->readZone(i_zones_->getZone(zone), wbuffer);
+      if (buffer)
+        memcpy(wbuffer + zone_offset, buffer + index, count);
+      else
+        memset(wbuffer + zone_offset, 0, count);
+      sb->writeZone(i_zones_->getZone(zone), wbuffer);
+      index += count;
+    }
+    else if (buffer)
+    {
+      // whole zones covered, write the ones following each other on disc
+      // with one request straight from the source
+      uint32 first = i_zones_->getZone(zone);
+      uint32 run = 1;
+      while (size - index >= (run + 1) * ZONE_SIZE && i_zones_->getZone(zone + run) == first + run)
+        ++run;
+      sb->writeZones(first, run, buffer + index);
+      index += run * ZONE_SIZE;
+    }
+    else
+    {
+      memset(wbuffer, 0, sizeof(wbuffer));
+      sb->writeZone(i_zones_->getZone(zone), wbuffer);
+      index += ZONE_SIZE;
+    }
+  }
+}
+
 int32 MinixFSInode::mknod(Dentry *dentry)
 {
   //debug(M_INODE, "mknod: dentry: %d, i_type_: %d\n",dentry,i_type_);
@@ -196,6 +225,8 @@ int32 MinixFSInode::mkdir(Dentry *dentry)
   i_nlink_++;
   writeDentry(0, ((MinixFSInode *) dentry->getParent()->getInode())->i_num_, "..");
   ((MinixFSInode *) dentry->getParent()->getInode())->i_nlink_++;
+  ((MinixFSSuperblock *) superblock_)->markInodeDirty(this);
+  ((MinixFSSuperblock *) superblock_)->markInodeDirty(dentry->getParent()->getInode());
   return 0;
 }
 
@@ -217,6 +248,7 @@ int32 MinixFSInode::mkfile(Dentry *dentry)
   ((MinixFSInode *) dentry->getParent()->getInode())->writeDentry(0, i_num_, i_dentry_->getName());
   i_dentry_->setInode(this);
   i_nlink_++;
+  ((MinixFSSuperblock *) superblock_)->markInodeDirty(this);
   return 0;
 }
 
@@ -245,21 +277,30 @@ void MinixFSInode::writeDentry(uint32 dest_i_num, uint32 src_i_num, const char*
   debug(M_INODE, "writeDentry: dest_i_num : %d, src_i_num : %d, name : %s\n", dest_i_num, src_i_num, name);
   assert(name);
   int32 dentry_pos = findDentry(dest_i_num);
+  char dbuffer[ZONE_SIZE];
+  uint32 zone;
   if (dentry_pos < 0 && dest_i_num == 0)
   {
-    i_zones_->addZone(((MinixFSSuperblock *) superblock_)->allocateZone());
+    zone = ((MinixFSSuperblock *) superblock_)->allocateZone();
+    i_zones_->addZone(zone);
     dentry_pos = (i_zones_->getNumZones() - 1) * ZONE_SIZE;
+    // the zone may still hold data of a deleted file, which would show up as entries
+    memset(dbuffer, 0, sizeof(dbuffer));
+  }
+  else
+  {
+    zone = i_zones_->getZone(dentry_pos / ZONE_SIZE);
+    ((MinixFSSuperblock *) superblock_)->readZone(zone, dbuffer);
   }
-  char dbuffer[ZONE_SIZE];
-  uint32 zone = i_zones_->getZone(dentry_pos / ZONE_SIZE);
-  ((MinixFSSuperblock *) superblock_)->readZone(zone, dbuffer);
   *(uint16*) (dbuffer + (dentry_pos % ZONE_SIZE)) = src_i_num;
   strncpy(dbuffer + dentry_pos % ZONE_SIZE + INODE_BYTES, name, MAX_NAME_LENGTH);
   ((MinixFSSuperblock *) superblock_)->writeZone(zone, dbuffer);
 
   if (dest_i_num == 0 && i_size_ < (uint32) dentry_pos + INODE_SIZE)
+  {
     i_size_ += INODE_SIZE;
-
+    ((MinixFSSuperblock *) superblock_)->markInodeDirty(this);
+  }
 }
 
 File* MinixFSInode::link(uint32 flag)
@@ -289,6 +330,7 @@ int32 MinixFSInode::rmdir()
   Dentry* dentry = i_dentry_;
   Dentry* parent_dentry = dentry->getParent();
 
+  loadChildren();
   //the "." and ".." dentries will be deleted in some inode-dtor
   //("." in this inodes-dtor, ".." in the parent-dentry-inodes-dtor)
   for (Dentry* child : dentry->d_child_)
@@ -309,6 +351,7 @@ int32 MinixFSInode::rmdir()
 
   writeDentry(((MinixFSInode *) parent_dentry->getInode())->i_num_, 0, &ch); //this was ".."
   ((MinixFSInode *) parent_dentry->getInode())->i_nlink_--;
+  ((MinixFSSuperblock *) superblock_)->markInodeDirty(parent_dentry->getInode());
 
   ((MinixFSInode *) parent_dentry->getInode())->writeDentry(i_num_, 0, &ch);
   i_nlink_--;
@@ -361,31 +404,25 @@ Dentry* MinixFSInode::lookup(const char* name)
     return 0;
   }
 
-  Dentry* dentry_update = 0;
-
-  if (i_type_ == I_DIR)
+  if (i_type_ != I_DIR)
   {
-    dentry_update = i_dentry_->checkName(name);
-    if (dentry_update == 0)
-    {
-      // ERROR_NNE
-      return (Dentry*) 0;
-    }
-    else
-    {
-      debug(M_INODE, "lookup: dentry_update->getName(): %s\n", dentry_update->getName());
-      if (((MinixFSInode *) dentry_update->getInode())->i_type_ == I_DIR)
-      {
-        ((MinixFSInode *) dentry_update->getInode())->loadChildren();
-      }
-      return dentry_update;
-    }
+    // ERROR_IC
+    return (Dentry*) 0;
   }
-  else
+
+  ((MinixFSSuperblock *) superblock_)->evictUnusedInodes();
+
+  Dentry* dentry_update = i_dentry_->checkName(name);
+  if (dentry_update == 0 && !children_loaded_)
+    dentry_update = readChildren(name);
+
+  if (dentry_update == 0)
   {
-    // ERROR_IC
+    // ERROR_NNE
     return (Dentry*) 0;
   }
+  debug(M_INODE, "lookup: dentry_update->getName(): %s\n", dentry_update->getName());
+  return dentry_update;
 }
 
 void MinixFSInode::loadChildren()
@@ -395,6 +432,12 @@ void MinixFSInode::loadChildren()
     debug(M_INODE, "loadChildren: Children allready loaded\n");
     return;
   }
+  readChildren(0);
+  children_loaded_ = true;
+}
+
+Dentry* MinixFSInode::readChildren(const char* name)
+{
   char dbuffer[ZONE_SIZE];
   for (uint32 zone = 0; zone < i_zones_->getNumZones(); zone++)
   {
@@ -402,49 +445,95 @@ void MinixFSInode::loadChildren()
     for (uint32 curr_dentry = 0; curr_dentry < BLOCK_SIZE; curr_dentry += INODE_SIZE)
     {
       uint16 inode_index = *(uint16*) (dbuffer + curr_dentry);
-      if (inode_index)
+      if (!inode_index)
+        continue;
+
+      char entry_name[MAX_NAME_LENGTH + 1];
+      strncpy(entry_name, dbuffer + curr_dentry + INODE_BYTES, MAX_NAME_LENGTH);
+      entry_name[MAX_NAME_LENGTH] = 0;
+
+      if (name)
+      {
+        if (strcmp(entry_name, name) == 0)
+          return addChild(inode_index, entry_name);
+      }
+      else if (!i_dentry_->checkName(entry_name))
       {
-        debug(M_INODE, "loadChildren: loading child %d\n", inode_index);
-        bool is_already_loaded = false;
-
-        Inode* inode = ((MinixFSSuperblock *) superblock_)->getInode(inode_index, is_already_loaded);
-
-        if (!inode)
-        {
-          kprintfd("MinixFSInode::loadChildren: inode nr. %d not set in bitmap, but occurs in directory-entry; "
-                   "maybe filesystem was not properly unmounted last time\n",
-                   inode_index);
-          char ch = 0;
-          writeDentry(inode_index, 0, &ch);
-          continue;
-        }
-
-        char name[MAX_NAME_LENGTH + 1];
-        strncpy(name, dbuffer + curr_dentry + INODE_BYTES, MAX_NAME_LENGTH);
-
-        name[MAX_NAME_LENGTH] = 0;
-
-        debug(M_INODE, "loadChildren: dentry name: %s\n", name);
-        Dentry *new_dentry = new Dentry(name);
-        i_dentry_->setChild(new_dentry);
-        new_dentry->setParent(i_dentry_);
-        if (!is_already_loaded)
-        {
-          ((MinixFSInode *) inode)->i_dentry_ = new_dentry;
-          ((MinixFSSuperblock *) superblock_)->all_inodes_add_inode(inode);
-        }
-        else
-          ((MinixFSInode *) inode)->other_dentries_.push_back(new_dentry);
-        new_dentry->setInode(inode);
+        addChild(inode_index, entry_name);
       }
     }
   }
-  children_loaded_ = true;
+  return 0;
+}
+
+Dentry* MinixFSInode::addChild(uint32 inode_index, const char* name)
+{
+  debug(M_INODE, "addChild: loading child %d with dentry name: %s\n", inode_index, name);
+  bool is_already_loaded = false;
+
+  Inode* inode = ((MinixFSSuperblock *) superblock_)->getInode(inode_index, is_already_loaded);
+
+  if (!inode)
+  {
+    kprintfd("MinixFSInode::addChild: inode nr. %d not set in bitmap, but occurs in directory-entry; "
+             "maybe filesystem was not properly unmounted last time\n",
+             inode_index);
+    char ch = 0;
+    writeDentry(inode_index, 0, &ch);
+    return 0;
+  }
+
+  Dentry *new_dentry = new Dentry(name);
+  i_dentry_->setChild(new_dentry);
+  new_dentry->setParent(i_dentry_);
+  if (!is_already_loaded)
+  {
+    ((MinixFSInode *) inode)->i_dentry_ = new_dentry;
+    ((MinixFSSuperblock *) superblock_)->all_inodes_add_inode(inode);
+  }
+  else
+    ((MinixFSInode *) inode)->other_dentries_.push_back(new_dentry);
+  new_dentry->setInode(inode);
+  return new_dentry;
+}
+
+bool MinixFSInode::isEvictable()
+{
+  // directories stay, they may be a working directory or a mount point and
+  // their loaded children point back at them
+  return i_type_ == I_FILE && i_dentry_ && i_files_.empty() && other_dentries_.empty();
+}
+
+uint16 MinixFSInode::allocateZone(uint32 num_wanted)
+{
+  MinixFSSuperblock* sb = (MinixFSSuperblock*) superblock_;
+  if (!num_prealloc_zones_)
+  {
+    uint32 num_zones = i_zones_->getNumZones();
+    uint16 goal = num_zones ? i_zones_->getZone(num_zones - 1) + 1 : 0;
+    num_wanted = num_wanted > MINIX_PREALLOC_ZONES ? num_wanted : MINIX_PREALLOC_ZONES;
+    prealloc_zone_ = sb->allocateZones(goal, num_wanted, num_prealloc_zones_);
+    debug(M_INODE, "allocateZone: reserved zones %d - %d (goal %d)\n", prealloc_zone_,
+          prealloc_zone_ + num_prealloc_zones_ - 1, goal);
+  }
+  --num_prealloc_zones_;
+  return prealloc_zone_++;
+}
+
+void MinixFSInode::releasePreallocation()
+{
+  MinixFSSuperblock* sb = (MinixFSSuperblock*) superblock_;
+  for (; num_prealloc_zones_; --num_prealloc_zones_)
+    sb->freeZone(prealloc_zone_++);
 }
 
 int32 MinixFSInode::flush()
 {
-  superblock_->writeInode(this);
+  MinixFSSuperblock* sb = (MinixFSSuperblock*) superblock_;
+  sb->writeInode(this);
+  // the zones of the inode have to be marked as used on the disc as well
+  sb->storage_manager_->flush(sb);
+  sb->flushDevice();
   debug(M_INODE, "flush: flushed\n");
   return 0;
 }
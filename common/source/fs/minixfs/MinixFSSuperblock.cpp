@@ -16,9 +16,11 @@
 #define ROOT_NAME "/"
 
 MinixFSSuperblock::MinixFSSuperblock(Dentry* s_root, size_t s_dev, uint64 offset) :
-    Superblock(s_root, s_dev), superblock_(this)
+    Superblock(s_root, s_dev), inode_table_(new MinixFSInode*[INODE_TABLE_INITIAL_SIZE]),
+    inode_table_size_(INODE_TABLE_INITIAL_SIZE), dirty_inodes_lock_("MinixFSSuperblock::dirty_inodes_lock_"), superblock_(this)
 {
   offset_ = offset;
+  memset(inode_table_, 0, inode_table_size_ * sizeof(MinixFSInode*));
   //read Superblock data from disc
   readHeader();
   debug(M_SB, "s_num_inodes_ : %d\ns_zones_ : %d\ns_num_inode_bm_blocks_ : %d\ns_num_zone_bm_blocks_ : %d\n"
@@ -90,14 +92,13 @@ void MinixFSSuperblock::initInodes()
   root_dentry->setInode(root_inode);
 
   all_inodes_add_inode(root_inode);
-  //read children from disc
-  root_inode->loadChildren();
-
 }
 
 MinixFSInode* MinixFSSuperblock::getInode(uint16 i_num, bool &is_already_loaded)
 {
-  MinixFSInode* tmp = (MinixFSInode*) all_inodes_set_[i_num];
+  MinixFSInode* tmp = inode_table_[i_num & (inode_table_size_ - 1)];
+  while (tmp && tmp->i_num_ != i_num)
+    tmp = tmp->hash_next_;
   if (tmp)
   {
     is_already_loaded = true;
@@ -111,7 +112,7 @@ MinixFSInode* MinixFSSuperblock::getInode(uint16 i_num)
 {
   debug(M_SB, "getInode::called with i_num: %d\n", i_num);
 
-  if (i_num >= storage_manager_->getNumUsedInodes())
+  if (i_num == 0 || i_num > s_num_inodes_)
   {
     debug(M_SB, "getInode::bad inode number %d\n", i_num);
     return 0;
@@ -150,14 +151,17 @@ MinixFSInode* MinixFSSuperblock::getInode(uint16 i_num)
 MinixFSSuperblock::~MinixFSSuperblock()
 {
   debug(M_SB, "~MinixSuperblock\n");
+  for (Inode* inode : all_inodes_)
+    ((MinixFSInode*) inode)->releasePreallocation();
+  writeDirtyInodes();
   assert(dirty_inodes_.empty() == true);
   storage_manager_->flush(this);
   for (FileDescriptor* fd : s_files_)
   {
+    s_files_.remove(fd);
     delete fd->getFile();
     delete fd;
   }
-  s_files_.clear();
   assert(s_files_.empty() == true);
 
   if (M_SB & OUTPUT_ENABLED)
@@ -168,19 +172,16 @@ MinixFSSuperblock::~MinixFSSuperblock()
 
   for (Inode* inode : all_inodes_)
   {
-    debug(M_SB, "~MinixSuperblock writing inode to disc\n");
-    writeInode(inode);
-
-    debug(M_SB, "~MinixSuperblock inode written to disc\n");
+    all_inodes_.remove(inode);
     delete inode->getDentry();
 
     debug(M_SB, "~MinixSuperblock deleting inode\n");
     delete inode;
   }
   delete storage_manager_;
+  flushDevice();
 
-  all_inodes_.clear();
-  all_inodes_set_.clear();
+  delete[] inode_table_;
 
   debug(M_SB, "~MinixSuperblock finished\n");
 }
@@ -201,9 +202,7 @@ Inode* MinixFSSuperblock::createInode(Dentry* dentry, uint32 type)
   Inode *inode = new MinixFSInode(this, mode, 0, 0, zones, i_num);
   debug(M_SB, "createInode> created Inode\n");
   all_inodes_add_inode(inode);
-  debug(M_SB, "createInode> calling write Inode to Disc\n");
-  writeInode(inode);
-  debug(M_SB, "createInode> returned from write Inode to Disc\n");
+  markInodeDirty(inode);
   if (type == I_DIR)
   {
     debug(M_SB, "createInode> mkdir\n");
@@ -224,7 +223,7 @@ int32 MinixFSSuperblock::readInode(Inode* inode)
 {
   assert(inode);
   MinixFSInode *minix_inode = (MinixFSInode *) inode;
-  assert(ustl::find(all_inodes_.begin(), all_inodes_.end(), inode) != all_inodes_.end());
+  assert(all_inodes_.contains(inode));
   uint32 block = 2 + s_num_inode_bm_blocks_ + s_num_zone_bm_blocks_
       + ((minix_inode->i_num_ - 1) * INODE_SIZE / BLOCK_SIZE);
   uint32 offset = ((minix_inode->i_num_ - 1) * INODE_SIZE) % BLOCK_SIZE;
@@ -250,65 +249,183 @@ int32 MinixFSSuperblock::readInode(Inode* inode)
 void MinixFSSuperblock::writeInode(Inode* inode)
 {
   assert(inode);
-  assert(ustl::find(all_inodes_.begin(), all_inodes_.end(), inode) != all_inodes_.end());
-  //flush zones
+  assert(all_inodes_.contains(inode));
+  MutexLock lock(dirty_inodes_lock_);
+  dirty_inodes_.remove(inode);
+  ustl::map<uint32, MinixFSInode*> inodes;
+  inodes[((MinixFSInode*) inode)->i_num_] = (MinixFSInode*) inode;
+  writeInodes(inodes);
+}
+
+void MinixFSSuperblock::markInodeDirty(Inode* inode)
+{
   MinixFSInode *minix_inode = (MinixFSInode *) inode;
-  uint32 block = 2 + s_num_inode_bm_blocks_ + s_num_zone_bm_blocks_
-      + ((minix_inode->i_num_ - 1) * INODE_SIZE / BLOCK_SIZE);
-  uint32 offset = ((minix_inode->i_num_ - 1) * INODE_SIZE) % BLOCK_SIZE;
-  char buffer[INODE_SIZE];
-  memset((void*) buffer, 0, sizeof(buffer));
-  debug(M_SB, "writeInode> reading block %d with offset %d from disc\n", block, offset);
-  readBytes(block, offset, INODE_SIZE, buffer);
-  debug(M_SB, "writeInode> read data from disc\n");
-  debug(M_SB, "writeInode> the inode: i_type_: %d, i_nlink_: %d, i_size_: %d\n", minix_inode->i_type_,
-        minix_inode->i_nlink_, minix_inode->i_size_);
-  if (minix_inode->i_type_ == I_FILE)
-  {
-    debug(M_SB, "writeInode> setting mode to file : %x\n", *(uint16*) buffer | 0x81FF);
-    *(uint16*) buffer |= 0x81FF;
-  }
-  else if (minix_inode->i_type_ == I_DIR)
-  {
-    debug(M_SB, "writeInode> setting mode to dir : %x\n", *(uint16*) buffer | 0x41FF);
-    *(uint16*) buffer |= 0x41FF;
-  }
-  else
+  MutexLock lock(dirty_inodes_lock_);
+  if (minix_inode->i_state_ & I_DIRTY)
+    return;
+  minix_inode->i_state_ |= I_DIRTY;
+  dirty_inodes_.push_back(inode);
+}
+
+void MinixFSSuperblock::writeInodes(ustl::map<uint32, MinixFSInode*>& inodes)
+{
+  uint32 inodes_start = 2 + s_num_inode_bm_blocks_ + s_num_zone_bm_blocks_;
+  char buffer[BLOCK_SIZE];
+  auto it = inodes.begin();
+  while (it != inodes.end())
   {
-    // link etc. unhandled
+    uint32 block = inodes_start + (it->first - 1) / INODES_PER_BLOCK;
+    readBlocks(block, 1, buffer);
+    // the map is sorted by inode number, so the inodes of one block follow each other
+    for (; it != inodes.end() && inodes_start + (it->first - 1) / INODES_PER_BLOCK == block; ++it)
+    {
+      MinixFSInode *minix_inode = it->second;
+      char* inode = buffer + ((minix_inode->i_num_ - 1) % INODES_PER_BLOCK) * INODE_SIZE;
+      debug(M_SB, "writeInodes> inode %d on block %d: i_type_: %d, i_nlink_: %d, i_size_: %d\n",
+            minix_inode->i_num_, block, minix_inode->i_type_, minix_inode->i_nlink_, minix_inode->i_size_);
+      if (minix_inode->i_type_ == I_FILE)
+        *(uint16*) inode = 0x81FF;
+      else if (minix_inode->i_type_ == I_DIR)
+        *(uint16*) inode = 0x41FF;
+      // else link etc. unhandled
+      ((uint32*) inode)[1 + V3_OFFSET] = minix_inode->i_size_;
+      if (s_magic_ == MINIX_V3)
+        ((uint16*) inode)[1] = minix_inode->i_nlink_;
+      else
+        inode[13] = minix_inode->i_nlink_;
+      minix_inode->i_zones_->storeZones(inode + INODE_BYTES * (7 - V3_OFFSET));
+      minix_inode->i_state_ &= ~I_DIRTY;
+    }
+    writeBlocks(block, 1, buffer);
   }
-  ((uint32*)buffer)[1+V3_OFFSET] = minix_inode->i_size_;
-  if (s_magic_ == MINIX_V3)
-    ((uint16*)buffer)[1] = minix_inode->i_nlink_;
-  else
-    buffer[13] = minix_inode->i_nlink_;
-  debug(M_SB, "writeInode> writing bytes to disc on block %d with offset %d\n", block, offset);
-  writeBytes(block, offset, INODE_SIZE, buffer);
-  debug(M_SB, "writeInode> flushing zones of inode %p\n", inode);
-  minix_inode->i_zones_->flush(minix_inode->i_num_);
+  for (auto inode : inodes)
+    inode.second->i_zones_->flush();
+}
+
+void MinixFSSuperblock::writeDirtyInodes()
+{
+  MutexLock lock(dirty_inodes_lock_);
+  if (dirty_inodes_.empty())
+    return;
+  ustl::map<uint32, MinixFSInode*> inodes;
+  for (Inode* inode : dirty_inodes_)
+    inodes[((MinixFSInode*) inode)->i_num_] = (MinixFSInode*) inode;
+  dirty_inodes_.clear();
+  debug(M_SB, "writeDirtyInodes> writing %zu inodes\n", inodes.size());
+  writeInodes(inodes);
+}
+
+int32 MinixFSSuperblock::sync()
+{
+  writeDirtyInodes();
+  storage_manager_->flush(this);
+  flushDevice();
+  return 0;
 }
 
 void MinixFSSuperblock::all_inodes_add_inode(Inode* inode)
 {
   all_inodes_.push_back(inode);
-  all_inodes_set_[((MinixFSInode*) inode)->i_num_] = inode;
+  if (all_inodes_.size() > inode_table_size_)
+    growInodeTable();
+  MinixFSInode* minix_inode = (MinixFSInode*) inode;
+  MinixFSInode** bucket = &inode_table_[minix_inode->i_num_ & (inode_table_size_ - 1)];
+  minix_inode->hash_next_ = *bucket;
+  *bucket = minix_inode;
 }
 
 void MinixFSSuperblock::all_inodes_remove_inode(Inode* inode)
 {
   all_inodes_.remove(inode);
-  all_inodes_set_.erase(((MinixFSInode*) inode)->i_num_);
+  MinixFSInode* minix_inode = (MinixFSInode*) inode;
+  MinixFSInode** bucket = &inode_table_[minix_inode->i_num_ & (inode_table_size_ - 1)];
+  while (*bucket && *bucket != minix_inode)
+    bucket = &(*bucket)->hash_next_;
+  if (*bucket)
+    *bucket = minix_inode->hash_next_;
+  minix_inode->hash_next_ = 0;
+}
+
+void MinixFSSuperblock::growInodeTable()
+{
+  uint32 new_size = inode_table_size_ * 2;
+  MinixFSInode** new_table = new MinixFSInode*[new_size];
+  memset(new_table, 0, new_size * sizeof(MinixFSInode*));
+  for (uint32 i = 0; i < inode_table_size_; ++i)
+  {
+    MinixFSInode* inode = inode_table_[i];
+    while (inode)
+    {
+      MinixFSInode* next = inode->hash_next_;
+      MinixFSInode** bucket = &new_table[inode->i_num_ & (new_size - 1)];
+      inode->hash_next_ = *bucket;
+      *bucket = inode;
+      inode = next;
+    }
+  }
+  delete[] inode_table_;
+  inode_table_ = new_table;
+  inode_table_size_ = new_size;
+  debug(M_SB, "growInodeTable: %d buckets\n", inode_table_size_);
+}
+
+void MinixFSSuperblock::evictUnusedInodes()
+{
+  if (all_inodes_.size() <= MINIX_CACHED_INODES)
+    return;
+
+  // drop down to half the limit so that the scan does not run on every lookup
+  ustl::list<MinixFSInode*> evict;
+  size_t num_loaded = all_inodes_.size();
+  for (Inode* inode : all_inodes_)
+  {
+    if (num_loaded <= MINIX_CACHED_INODES / 2)
+      break;
+    if (((MinixFSInode*) inode)->isEvictable())
+    {
+      evict.push_back((MinixFSInode*) inode);
+      --num_loaded;
+    }
+  }
+  debug(M_SB, "evictUnusedInodes: %zu of %zu inodes evicted\n", evict.size(), all_inodes_.size());
+
+  MutexLock lock(dirty_inodes_lock_);
+  ustl::map<uint32, MinixFSInode*> dirty;
+  for (MinixFSInode* inode : evict)
+  {
+    inode->releasePreallocation();
+    if (inode->i_state_ & I_DIRTY)
+    {
+      dirty_inodes_.remove(inode);
+      dirty[inode->i_num_] = inode;
+    }
+  }
+  writeInodes(dirty);
+
+  for (MinixFSInode* inode : evict)
+  {
+    Dentry* dentry = inode->i_dentry_;
+    // the directory is not completely in memory anymore
+    ((MinixFSInode*) dentry->getParent()->getInode())->children_loaded_ = false;
+    dentry->releaseInode();
+    delete dentry;
+    inode->i_dentry_ = 0;
+    all_inodes_remove_inode(inode);
+    delete inode;
+  }
 }
 
 void MinixFSSuperblock::delete_inode(Inode* inode)
 {
   Dentry* dentry = inode->getDentry();
   assert(dentry == 0);
-  assert(ustl::find(used_inodes_.begin(), used_inodes_.end(), inode) == used_inodes_.end());
+  assert(!used_inodes_.contains(inode));
+  MutexLock lock(dirty_inodes_lock_);
   dirty_inodes_.remove(inode);
   MinixFSInode *minix_inode = (MinixFSInode *) inode;
   all_inodes_remove_inode(minix_inode);
   assert(minix_inode->i_files_.empty());
+  minix_inode->releasePreallocation();
   minix_inode->i_zones_->freeZones();
   storage_manager_->freeInode(minix_inode->i_num_);
   uint32 block = 2 + s_num_inode_bm_blocks_ + s_num_zone_bm_blocks_
@@ -329,7 +446,7 @@ int32 MinixFSSuperblock::createFd(Inode* inode, uint32 flag)
   s_files_.push_back(fd);
   FileDescriptor::add(fd);
 
-  if (ustl::find(used_inodes_.begin(), used_inodes_.end(), inode) == used_inodes_.end())
+  if (!used_inodes_.contains(inode))
   {
     used_inodes_.push_back(inode);
   }
@@ -352,6 +469,7 @@ int32 MinixFSSuperblock::removeFd(Inode* inode, FileDescriptor* fd)
   if (inode->getNumOpenedFile() == 0)
   {
     used_inodes_.remove(inode);
+    ((MinixFSInode*) inode)->releasePreallocation();
   }
   delete fd;
 
@@ -366,12 +484,28 @@ uint16 MinixFSSuperblock::allocateZone()
   return ret;
 }
 
+uint16 MinixFSSuperblock::allocateZones(uint16 goal, uint32 count, uint32& num_allocated)
+{
+  size_t storage_goal = goal >= s_1st_datazone_ ? goal - s_1st_datazone_ + 1 : 0;
+  size_t allocated = 0;
+  uint16 ret = storage_manager_->allocZones(storage_goal, count, allocated) + s_1st_datazone_ - 1;
+  num_allocated = allocated;
+  debug(M_SB, "MinixFSSuperblock allocateZones> returning %d - %d\n", ret, ret + num_allocated - 1);
+  return ret;
+}
+
 void MinixFSSuperblock::readZone(uint16 zone, char* buffer)
 {
   assert(buffer);
   readBlocks(zone, ZONE_SIZE / BLOCK_SIZE, buffer);
 }
 
+void MinixFSSuperblock::readZones(uint16 zone, uint32 num_zones, char* buffer)
+{
+  assert(buffer);
+  readBlocks(zone, num_zones * ZONE_SIZE / BLOCK_SIZE, buffer);
+}
+
 void MinixFSSuperblock::readBlocks(uint16 block, uint32 num_blocks, char* buffer)
 {
   assert(buffer);
@@ -389,6 +523,21 @@ void MinixFSSuperblock::writeZone(uint16 zone, char* buffer)
   writeBlocks(zone, ZONE_SIZE / BLOCK_SIZE, buffer);
 }
 
+void MinixFSSuperblock::writeZones(uint16 zone, uint32 num_zones, const char* buffer)
+{
+  writeBlocks(zone, num_zones * ZONE_SIZE / BLOCK_SIZE, (char*) buffer);
+}
+
+void MinixFSSuperblock::flushDevice()
+{
+#ifdef EXE2MINIXFS
+  fflush((FILE*)s_dev_);
+#else
+  BDVirtualDevice* bdvd = BDManager::getInstance()->getDeviceByNumber(s_dev_);
+  bdvd->flush();
+#endif
+}
+
 void MinixFSSuperblock::writeBlocks(uint16 block, uint32 num_blocks, char* buffer)
 {
 #ifdef EXE2MINIXFS
@@ -405,7 +554,7 @@ int32 MinixFSSuperblock::readBytes(uint32 block, uint32 offset, uint32 size, cha
   assert(offset+size <= BLOCK_SIZE);
   char rbuffer[BLOCK_SIZE];
   readBlocks(block, 1, rbuffer);
-  memcpy(rbuffer + offset, buffer, size);
+  memcpy(buffer, rbuffer + offset, size);
   return size;
 }
 
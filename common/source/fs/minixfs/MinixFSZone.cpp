@@ -7,205 +7,217 @@
 #include <assert.h>
 #include "minix_fs_consts.h"
 
-MinixFSZone::MinixFSZone(MinixFSSuperblock *superblock, uint32 *zones)
+MinixFSZone::MinixFSZone(MinixFSSuperblock *superblock, uint32 *zones) :
+    superblock_(superblock), indirect_zones_(0), double_indirect_linking_zone_(0), double_indirect_zones_(0),
+    num_zones_(0), num_zones_counted_(false), addresses_changed_(false), zones_lock_("MinixFSZone::zones_lock_")
 {
-  superblock_ = superblock;
-  num_zones_ = 0;
   for (uint32 i = 0; i < NUM_ZONES; i++)
   {
     direct_zones_[i] = zones[i];
-    if (zones[i] && i < 7)
-      ++num_zones_;
     debug(M_ZONE, "zone: %x\t", zones[i]);
   }
-  char buffer[ZONE_SIZE];
-  if (zones[7])
+}
+
+MinixFSZone::~MinixFSZone()
+{
+  if (double_indirect_zones_)
   {
-    indirect_zones_ = new uint32[NUM_ZONE_ADDRESSES];
-    superblock_->readZone(zones[7], buffer);
     for (uint32 i = 0; i < NUM_ZONE_ADDRESSES; i++)
     {
-      indirect_zones_[i] = V3_ARRAY(buffer,i);
-      if (indirect_zones_[i])
-        ++num_zones_;
+      delete[] double_indirect_zones_[i];
     }
+    delete[] double_indirect_zones_;
   }
-  else
-  {
-    indirect_zones_ = 0;
-  }
-  if (zones[8])
-  {
-    double_indirect_zones_ = new uint32*[NUM_ZONE_ADDRESSES];
-    double_indirect_linking_zone_ = new uint32[NUM_ZONE_ADDRESSES];
-    superblock_->readZone(zones[8], buffer);
-    char ind_buffer[ZONE_SIZE];
-    for (uint32 ind_zone = 0; ind_zone < NUM_ZONE_ADDRESSES; ind_zone++)
-    {
-      double_indirect_linking_zone_[ind_zone] = V3_ARRAY(buffer,ind_zone);
-      if (double_indirect_linking_zone_[ind_zone])
-      {
-        superblock_->readZone(double_indirect_linking_zone_[ind_zone], ind_buffer);
-        double_indirect_zones_[ind_zone] = new uint32[NUM_ZONE_ADDRESSES];
+  delete[] double_indirect_linking_zone_;
+  delete[] indirect_zones_;
+}
 
-        for (uint32 d_ind_zone = 0; d_ind_zone < NUM_ZONE_ADDRESSES; d_ind_zone++)
-        {
-          double_indirect_zones_[ind_zone][d_ind_zone] = V3_ARRAY(ind_buffer,d_ind_zone);
-          if (double_indirect_zones_[ind_zone][d_ind_zone])
-            ++num_zones_;
-        }
-      }
-      else
-      {
-        double_indirect_zones_[ind_zone] = 0;
-      }
-    }
-  }
-  else
-  {
-    double_indirect_zones_ = 0;
-    double_indirect_linking_zone_ = 0;
-  }
+uint32 *MinixFSZone::readZoneAddresses(uint32 zone)
+{
+  debug(M_ZONE, "MinixFSZone::readZoneAddresses> zone: %x\n", zone);
+  char buffer[ZONE_SIZE];
+  superblock_->readZone(zone, buffer);
+  uint32 *addresses = new uint32[NUM_ZONE_ADDRESSES];
+  for (uint32 i = 0; i < NUM_ZONE_ADDRESSES; i++)
+    addresses[i] = V3_ARRAY(buffer, i);
+  return addresses;
+}
+
+uint32 *MinixFSZone::emptyZoneAddresses()
+{
+  uint32 *addresses = new uint32[NUM_ZONE_ADDRESSES];
+  for (uint32 i = 0; i < NUM_ZONE_ADDRESSES; i++)
+    addresses[i] = 0;
+  return addresses;
+}
 
-  if (M_ZONE & OUTPUT_ENABLED)
+uint32 *MinixFSZone::indirectZones()
+{
+  if (!indirect_zones_ && direct_zones_[7])
+    indirect_zones_ = readZoneAddresses(direct_zones_[7]);
+  return indirect_zones_;
+}
+
+uint32 *MinixFSZone::doubleIndirectZones(uint32 ind_zone)
+{
+  if (!double_indirect_linking_zone_)
   {
-    kprintfd("=========Zones:======%d=======\n", num_zones_);
-    kprintfd("====direct Zones:====\n");
-    uint32 print_num_zones = 0;
-    for (uint32 i = 0; i < NUM_ZONES; i++, print_num_zones++)
-    {
-      kprintfd("====zone: %x\t", direct_zones_[i]);
-    }
-    kprintfd("===indirect Zones:===\n");
-    for (uint32 i = 0; i < NUM_ZONE_ADDRESSES && print_num_zones < num_zones_; i++, print_num_zones++)
-    {
-      kprintfd("===zone: %x\t", indirect_zones_[i]);
-    }
-    kprintfd("=dblindirect Zones:==\n");
-    for (uint32 ind_zone = 0; ind_zone < NUM_ZONE_ADDRESSES && print_num_zones < num_zones_;
-        ind_zone++, print_num_zones++)
-    {
-      for (uint32 d_ind_zone = 0; d_ind_zone < NUM_ZONE_ADDRESSES && print_num_zones < num_zones_;
-          d_ind_zone++, print_num_zones++)
-      {
-        kprintfd("=zone: %x\t", double_indirect_zones_[ind_zone][d_ind_zone]);
-      }
-    }
+    if (!direct_zones_[8])
+      return 0;
+    double_indirect_linking_zone_ = readZoneAddresses(direct_zones_[8]);
+    double_indirect_zones_ = new uint32*[NUM_ZONE_ADDRESSES];
+    for (uint32 i = 0; i < NUM_ZONE_ADDRESSES; i++)
+      double_indirect_zones_[i] = 0;
   }
+  if (!double_indirect_zones_[ind_zone] && double_indirect_linking_zone_[ind_zone])
+    double_indirect_zones_[ind_zone] = readZoneAddresses(double_indirect_linking_zone_[ind_zone]);
+  return double_indirect_zones_[ind_zone];
 }
 
-MinixFSZone::~MinixFSZone()
+uint32 MinixFSZone::getNumZones()
 {
-  if (double_indirect_zones_)
+  MutexLock lock(zones_lock_);
+  return countZones();
+}
+
+uint32 MinixFSZone::countZones()
+{
+  if (num_zones_counted_)
+    return num_zones_;
+
+  num_zones_ = 0;
+  for (uint32 i = 0; i < 7; i++)
+    if (direct_zones_[i])
+      ++num_zones_;
+  uint32 *zones = indirectZones();
+  if (zones)
   {
     for (uint32 i = 0; i < NUM_ZONE_ADDRESSES; i++)
-    {
-      delete[] double_indirect_zones_[i];
-    }
-    delete[] double_indirect_zones_;
-    delete[] double_indirect_linking_zone_;
+      if (zones[i])
+        ++num_zones_;
   }
-
-  delete[] indirect_zones_;
+  for (uint32 ind_zone = 0; direct_zones_[8] && ind_zone < NUM_ZONE_ADDRESSES; ind_zone++)
+  {
+    zones = doubleIndirectZones(ind_zone);
+    if (!zones)
+      continue;
+    for (uint32 d_ind_zone = 0; d_ind_zone < NUM_ZONE_ADDRESSES; d_ind_zone++)
+      if (zones[d_ind_zone])
+        ++num_zones_;
+  }
+  num_zones_counted_ = true;
+  debug(M_ZONE, "MinixFSZone::getNumZones> %d zones\n", num_zones_);
+  return num_zones_;
 }
 
 uint32 MinixFSZone::getZone(uint32 index)
 {
-  assert(index < num_zones_);
+  MutexLock lock(zones_lock_);
+  assert(!num_zones_counted_ || index < num_zones_);
   if (index < 7)
     return direct_zones_[index];
   index -= 7;
   if (index < NUM_ZONE_ADDRESSES)
-    return indirect_zones_[index];
+  {
+    uint32 *zones = indirectZones();
+    assert(zones);
+    return zones[index];
+  }
   index -= NUM_ZONE_ADDRESSES;
-  return double_indirect_zones_[index / NUM_ZONE_ADDRESSES][index % NUM_ZONE_ADDRESSES];
+  uint32 *zones = doubleIndirectZones(index / NUM_ZONE_ADDRESSES);
+  assert(zones);
+  return zones[index % NUM_ZONE_ADDRESSES];
 }
 
 void MinixFSZone::setZone(uint32 index, uint32 zone)
 {
-  debug(M_ZONE, "MinixFSZone::setZone> index: %d, zone: %d\n", index, zone);
+  MutexLock lock(zones_lock_);
+  putZone(index, zone);
+}
+
+void MinixFSZone::putZone(uint32 index, uint32 zone)
+{
+  debug(M_ZONE, "MinixFSZone::putZone> index: %d, zone: %d\n", index, zone);
+  countZones();
   if (index < 7)
   {
     direct_zones_[index] = zone;
     ++num_zones_;
     return;
   }
+  addresses_changed_ = true;
   index -= 7;
   if (index < NUM_ZONE_ADDRESSES)
   {
-    if (!indirect_zones_)
+    if (!indirectZones())
     {
       direct_zones_[7] = superblock_->allocateZone();
-      indirect_zones_ = new uint32[NUM_ZONE_ADDRESSES];
-      for (uint32 i = 0; i < NUM_ZONE_ADDRESSES; i++)
-        indirect_zones_[i] = 0;
+      indirect_zones_ = emptyZoneAddresses();
     }
     indirect_zones_[index] = zone;
     ++num_zones_;
     return;
   }
   index -= NUM_ZONE_ADDRESSES;
-  if (!double_indirect_zones_)
+  uint32 ind_zone = index / NUM_ZONE_ADDRESSES;
+  if (!direct_zones_[8])
   {
     direct_zones_[8] = superblock_->allocateZone();
-    double_indirect_linking_zone_ = new uint32[NUM_ZONE_ADDRESSES];
-    for (uint32 i = 0; i < NUM_ZONE_ADDRESSES; i++)
-      double_indirect_linking_zone_[i] = 0;
-
+    double_indirect_linking_zone_ = emptyZoneAddresses();
     double_indirect_zones_ = new uint32*[NUM_ZONE_ADDRESSES];
     for (uint32 i = 0; i < NUM_ZONE_ADDRESSES; i++)
       double_indirect_zones_[i] = 0;
   }
-  if (!double_indirect_zones_[index / NUM_ZONE_ADDRESSES])
+  if (!doubleIndirectZones(ind_zone))
   {
-    double_indirect_linking_zone_[index / NUM_ZONE_ADDRESSES] = superblock_->allocateZone();
-    double_indirect_zones_[index / NUM_ZONE_ADDRESSES] = new uint32[NUM_ZONE_ADDRESSES];
-    for (uint32 i = 0; i < NUM_ZONE_ADDRESSES; i++)
-      double_indirect_zones_[index / NUM_ZONE_ADDRESSES][i] = 0;
+    double_indirect_linking_zone_[ind_zone] = superblock_->allocateZone();
+    double_indirect_zones_[ind_zone] = emptyZoneAddresses();
   }
-  double_indirect_zones_[index / NUM_ZONE_ADDRESSES][index % NUM_ZONE_ADDRESSES] = zone;
+  double_indirect_zones_[ind_zone][index % NUM_ZONE_ADDRESSES] = zone;
 
   ++num_zones_;
 }
 
 void MinixFSZone::addZone(uint32 zone)
 {
-  setZone(num_zones_, zone);
+  MutexLock lock(zones_lock_);
+  putZone(countZones(), zone);
 }
 
-void MinixFSZone::flush(uint32 i_num)
+void MinixFSZone::storeZones(char *buffer)
 {
-  debug(M_ZONE, "MinixFSZone::flush i_num : %d; %p\n", i_num, this);
-  char buffer[NUM_ZONES * INODE_BYTES];
+  MutexLock lock(zones_lock_);
   for (uint32 index = 0; index < NUM_ZONES; index++)
     SET_V3_ARRAY(buffer,index,direct_zones_[index]);
-  uint32 block = 2 + superblock_->s_num_inode_bm_blocks_ + superblock_->s_num_zone_bm_blocks_
-      + ((i_num - 1) * INODE_SIZE) / BLOCK_SIZE;
-  superblock_->writeBytes(block, ((i_num - 1) * INODE_SIZE) % BLOCK_SIZE + INODE_BYTES * (7 - V3_OFFSET),
-                          NUM_ZONES * INODE_BYTES, buffer);
-  debug(M_ZONE, "MinixFSZone::flush direct written\n");
-  if (direct_zones_[7])
+}
+
+void MinixFSZone::flush()
+{
+  MutexLock lock(zones_lock_);
+  if (!addresses_changed_)
+    return;
+  debug(M_ZONE, "MinixFSZone::flush %p\n", this);
+  addresses_changed_ = false;
+  // zone addresses that were never read can not have changed
+  if (direct_zones_[7] && indirect_zones_)
   {
     char ind_buffer[ZONE_SIZE];
     debug(M_ZONE, "MinixFSZone::flush writing indirect\n");
-    assert(indirect_zones_);
     memset((void*)ind_buffer, 0, sizeof(ind_buffer));
     for (uint32 i = 0; i < NUM_ZONE_ADDRESSES; i++)
       SET_V3_ARRAY(ind_buffer,i,indirect_zones_[i]);
     superblock_->writeZone(direct_zones_[7], ind_buffer);
   }
 
-  if (direct_zones_[8])
+  if (direct_zones_[8] && double_indirect_linking_zone_)
   {
     char dbl_ind_buffer[ZONE_SIZE];
-    assert(double_indirect_linking_zone_);
-    assert(double_indirect_zones_);
     for (uint32 ind_zone = 0; ind_zone < NUM_ZONE_ADDRESSES; ind_zone++)
       SET_V3_ARRAY(dbl_ind_buffer, ind_zone, double_indirect_linking_zone_[ind_zone]);
     superblock_->writeZone(direct_zones_[8], dbl_ind_buffer);
     for (uint32 ind_zone = 0; ind_zone < NUM_ZONE_ADDRESSES; ind_zone++)
     {
-      if (double_indirect_linking_zone_[ind_zone])
+      if (double_indirect_linking_zone_[ind_zone] && double_indirect_zones_[ind_zone])
       {
         memset((void*)dbl_ind_buffer, 0, sizeof(dbl_ind_buffer));
         for (uint32 d_ind_zone = 0; d_ind_zone < NUM_ZONE_ADDRESSES; d_ind_zone++)
@@ -218,31 +230,30 @@ void MinixFSZone::flush(uint32 i_num)
 
 void MinixFSZone::freeZones()
 {
+  MutexLock lock(zones_lock_);
   for (uint32 i = 0; i < NUM_ZONES; i++)
     if (direct_zones_[i])
       superblock_->freeZone(direct_zones_[i]);
 
-  if (!indirect_zones_)
-    return;
-
-  for (uint32 i = 0; i < NUM_ZONE_ADDRESSES; i++)
-    if (indirect_zones_[i])
-      superblock_->freeZone(indirect_zones_[i]);
-
-  if (!double_indirect_linking_zone_)
-    return;
-
-  for (uint32 i = 0; i < NUM_ZONE_ADDRESSES; i++)
-    if (double_indirect_linking_zone_[i])
-      superblock_->freeZone(double_indirect_linking_zone_[i]);
+  uint32 *zones = indirectZones();
+  if (zones)
+  {
+    for (uint32 i = 0; i < NUM_ZONE_ADDRESSES; i++)
+      if (zones[i])
+        superblock_->freeZone(zones[i]);
+  }
 
-  if (!double_indirect_zones_)
+  if (!direct_zones_[8])
     return;
 
   for (uint32 i = 0; i < NUM_ZONE_ADDRESSES; i++)
-    if (double_indirect_zones_[i])
-      for (uint32 j = 0; j < NUM_ZONE_ADDRESSES; j++)
-        if (double_indirect_zones_[i][j])
-          superblock_->freeZone(double_indirect_zones_[i][j]);
+  {
+    zones = doubleIndirectZones(i);
+    if (!zones)
+      continue;
+    superblock_->freeZone(double_indirect_linking_zone_[i]);
+    for (uint32 j = 0; j < NUM_ZONE_ADDRESSES; j++)
+      if (zones[j])
+        superblock_->freeZone(zones[j]);
+  }
 }
-
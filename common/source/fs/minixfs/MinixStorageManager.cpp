@@ -2,10 +2,12 @@
 #include "MinixFSSuperblock.h"
 #include <assert.h>
 #include "kprintf.h"
+#include "kstring.h"
 
 MinixStorageManager::MinixStorageManager(char *bm_buffer, uint16 num_inode_bm_blocks, uint16 num_zone_bm_blocks,
                                          uint16 num_inodes, uint16 num_zones) :
-    StorageManager(num_inodes, num_zones)
+    StorageManager(num_inodes + 1, num_zones), // bit 0 is reserved, the inodes are numbered from 1
+    bitmap_lock_("MinixStorageManager::bitmap_lock_")
 {
   debug(M_STORAGE_MANAGER,
         "Constructor: num_inodes:%d\tnum_inode_bm_blocks:%d\tnum_zones:%d\tnum_zone_bm_blocks:%d\t\n", num_inodes,
@@ -14,32 +16,11 @@ MinixStorageManager::MinixStorageManager(char *bm_buffer, uint16 num_inode_bm_bl
   num_inode_bm_blocks_ = num_inode_bm_blocks;
   num_zone_bm_blocks_ = num_zone_bm_blocks;
 
-  uint32 i_byte = 0;
-  for (; i_byte < num_inodes / 8; i_byte++)
-  {
-    inode_bitmap_.setByte(i_byte, bm_buffer[i_byte]);
-  }
-  for (uint32 i_bit = 0; i_bit < num_inodes % 8; i_bit++)
-  {
-    uint8 byte = bm_buffer[i_byte];
-    if ((byte >> i_bit) & 0x01)
-      inode_bitmap_.setBit(i_byte * 8 + i_bit);
-  }
-  //read zone bitmap
-  uint32 z_byte = num_inode_bm_blocks * BLOCK_SIZE;
-  uint32 z_bm_byte = 0;
-  for (; z_bm_byte < num_zones / 8; z_byte++, z_bm_byte++)
-  {
-    zone_bitmap_.setByte(z_bm_byte, bm_buffer[z_byte]);
-  }
-  for (uint32 z_bit = 0; z_bit < num_zones % 8; z_bit++)
-  {
-    uint8 byte = bm_buffer[z_byte];
-    if ((byte >> z_bit) & 0x01)
-      zone_bitmap_.setBit(z_bm_byte * 8 + z_bit);
-  }
+  inode_bitmap_.setBytes((uint8*) bm_buffer, num_inodes + 1);
+  zone_bitmap_.setBytes((uint8*) bm_buffer + num_inode_bm_blocks * BLOCK_SIZE, num_zones);
   curr_inode_pos_ = 0;
   curr_zone_pos_ = 0;
+  changed_ = false;
 }
 
 MinixStorageManager::~MinixStorageManager()
@@ -49,49 +30,79 @@ MinixStorageManager::~MinixStorageManager()
 
 bool MinixStorageManager::isInodeSet(size_t index)
 {
+  MutexLock lock(bitmap_lock_);
   assert(index < inode_bitmap_.getSize() && "MinixStorageManager::isInodeSet called with bad index number");
   return inode_bitmap_.getBit(index);
 }
 
 uint32 MinixStorageManager::getNumUsedInodes()
 {
+  MutexLock lock(bitmap_lock_);
   return inode_bitmap_.getNumBitsSet();
 }
 
 size_t MinixStorageManager::allocZone()
 {
-  size_t pos = curr_zone_pos_ + 1;
-  for (; pos != curr_zone_pos_; pos++)
+  size_t num_allocated;
+  size_t pos = allocZones(0, 1, num_allocated); // first fit starts behind curr_zone_pos_
+  debug(M_STORAGE_MANAGER, "acquireZone: Zone %zu acquired\n", pos);
+  return pos;
+}
+
+size_t MinixStorageManager::allocZones(size_t goal, size_t count, size_t& num_allocated)
+{
+  assert(count > 0);
+  MutexLock lock(bitmap_lock_);
+  size_t size = zone_bitmap_.getSize();
+  size_t start = -1;
+  if (goal && goal < size && !zone_bitmap_.getBit(goal))
+  {
+    start = goal;
+  }
+  else
   {
-    if (pos >= zone_bitmap_.getSize())
-      pos = 0;
-    if (!zone_bitmap_.getBit(pos))
+    // first fit from the last allocation on, wrapping around once,
+    // with shorter runs if no run is long enough
+    size_t from = curr_zone_pos_ + 1 < size ? curr_zone_pos_ + 1 : 0;
+    for (size_t length = count; start == (size_t) -1 && length; length /= 2)
+    {
+      start = zone_bitmap_.findZeroRun(length, 1, from);
+      if (start == (size_t) -1)
+        start = zone_bitmap_.findZeroRun(length, 1, 0);
+    }
+    if (start == (size_t) -1)
     {
-      zone_bitmap_.setBit(pos);
-      curr_zone_pos_ = pos;
-      debug(M_STORAGE_MANAGER, "acquireZone: Zone %zu acquired\n", pos);
-      return pos;
+      kprintfd("acquireZone: NO FREE ZONE FOUND!\n");
+      assert(false); // full memory should have been checked.
+      num_allocated = 0;
+      return 0;
     }
   }
-  kprintfd("acquireZone: NO FREE ZONE FOUND!\n");
-  assert(false); // full memory should have been checked.
-  return 0;
+
+  num_allocated = 0;
+  while (num_allocated < count && start + num_allocated < size && !zone_bitmap_.getBit(start + num_allocated))
+    ++num_allocated;
+  zone_bitmap_.setRange(start, num_allocated);
+  changed_ = true;
+  curr_zone_pos_ = start + num_allocated - 1;
+  debug(M_STORAGE_MANAGER, "allocZones: Zones %zu - %zu acquired (goal %zu, wanted %zu)\n", start,
+        curr_zone_pos_, goal, count);
+  return start;
 }
 
 size_t MinixStorageManager::allocInode()
 {
-  size_t pos = curr_inode_pos_ + 1;
-  for (; pos != curr_inode_pos_; pos++)
+  MutexLock lock(bitmap_lock_);
+  size_t pos = inode_bitmap_.findFirstZero(curr_inode_pos_ + 1);
+  if (pos == (size_t) -1)
+    pos = inode_bitmap_.findFirstZero(0);
+  if (pos != (size_t) -1)
   {
-    if (pos >= inode_bitmap_.getSize())
-      pos = 0;
-    if (!inode_bitmap_.getBit(pos))
-    {
-      inode_bitmap_.setBit(pos);
-      curr_inode_pos_ = pos;
-      debug(M_STORAGE_MANAGER, "acquireInode: Inode %zu acquired\n", pos);
-      return pos;
-    }
+    inode_bitmap_.setBit(pos);
+    changed_ = true;
+    curr_inode_pos_ = pos;
+    debug(M_STORAGE_MANAGER, "acquireInode: Inode %zu acquired\n", pos);
+    return pos;
   }
   kprintfd("acquireInode: NO FREE INODE FOUND!\n");
   assert(false); // full memory should have been checked.
@@ -100,77 +111,49 @@ size_t MinixStorageManager::allocInode()
 
 void MinixStorageManager::freeZone(size_t index)
 {
+  MutexLock lock(bitmap_lock_);
   zone_bitmap_.unsetBit(index);
+  changed_ = true;
   debug(M_STORAGE_MANAGER, "freeZone: Zone %zu freed\n", index);
 }
 
 void MinixStorageManager::freeInode(size_t index)
 {
+  MutexLock lock(bitmap_lock_);
   inode_bitmap_.unsetBit(index);
+  changed_ = true;
   debug(M_STORAGE_MANAGER, "freeInode: Inode %zu freed\n", index);
 }
 
 void MinixStorageManager::flush(MinixFSSuperblock *superblock)
 {
-  debug(M_STORAGE_MANAGER, "flush: starting flushing\n");
-  char* bm_buffer = new char[(num_inode_bm_blocks_ + num_zone_bm_blocks_) * BLOCK_SIZE];
-  uint32 num_inodes = inode_bitmap_.getSize();
-  uint32 i_byte = 0;
-  for (; i_byte < num_inodes / 8; i_byte++)
-  {
-    bm_buffer[i_byte] = inode_bitmap_.getByte(i_byte);
-  }
-  uint8 byte = 0;
-  for (uint32 i_bit = 0; i_bit < 8; i_bit++)
-  {
-    if (i_bit < num_inodes % 8)
-    {
-      if (inode_bitmap_.getBit(i_byte * 8 + i_bit))
-      {
-        byte &= 0x01 << i_bit;
-      }
-    }
-    else
-      byte &= 0x01 << i_bit;
-  }
-  bm_buffer[i_byte] = byte;
-  ++i_byte;
-  for (; i_byte < num_inode_bm_blocks_ * BLOCK_SIZE; i_byte++)
-  {
-    bm_buffer[i_byte] = 0xff;
-  }
-
-  uint32 num_zones = zone_bitmap_.getSize();
-  uint32 z_byte = 0;
-  for (; z_byte < num_zones / 8; z_byte++, i_byte++)
+  uint32 bm_size = (num_inode_bm_blocks_ + num_zone_bm_blocks_) * BLOCK_SIZE;
+  uint8* bm_buffer;
   {
-    bm_buffer[i_byte] = zone_bitmap_.getByte(z_byte);
+    MutexLock lock(bitmap_lock_);
+    if (!changed_)
+      return;
+    debug(M_STORAGE_MANAGER, "flush: starting flushing\n");
+    changed_ = false;
+    bm_buffer = new uint8[bm_size];
+    // bits after the last inode and zone are set, as mkfs does
+    memset(bm_buffer, 0xff, bm_size);
+    writeBitmap(inode_bitmap_, bm_buffer);
+    writeBitmap(zone_bitmap_, bm_buffer + num_inode_bm_blocks_ * BLOCK_SIZE);
   }
-  byte = 0;
-  for (uint32 z_bit = 0; z_bit < 8; z_bit++)
-  {
-    if (z_bit < num_inodes % 8)
-    {
-      if (zone_bitmap_.getBit(z_byte * 8 + z_bit))
-      {
-        byte &= 0x01 << z_bit;
-      }
-    }
-    else
-      byte &= 0x01 << z_bit;
-  }
-  bm_buffer[i_byte] = byte;
-  ++z_byte;
-  ++i_byte;
-  for (; z_byte < num_zone_bm_blocks_ * BLOCK_SIZE; z_byte++, i_byte++)
-  {
-    bm_buffer[i_byte] = 0xff;
-  }
-  superblock->writeBlocks(2, num_inode_bm_blocks_ + num_zone_bm_blocks_, bm_buffer);
+  superblock->writeBlocks(2, num_inode_bm_blocks_ + num_zone_bm_blocks_, (char*) bm_buffer);
   delete[] bm_buffer;
   debug(M_STORAGE_MANAGER, "flush: flushing finished\n");
 }
 
+void MinixStorageManager::writeBitmap(Bitmap& bitmap, uint8* buffer)
+{
+  size_t num_bits = bitmap.getSize();
+  bitmap.getBytes(buffer);
+  if (num_bits % 8)
+    buffer[num_bits / 8] |= 0xff << (num_bits % 8);
+}
+
 void MinixStorageManager::printBitmap()
 {
   inode_bitmap_.bmprint();
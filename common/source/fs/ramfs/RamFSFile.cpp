@@ -25,8 +25,13 @@ RamFSFile::~RamFSFile()
 
 int32 RamFSFile::read(char *buffer, size_t count, l_off_t offset)
 {
-  if ((flag_ == O_RDONLY) || (flag_ == O_RDWR))
-    return (f_inode_->readData(offset, count, buffer));
+  if (((flag_ == O_RDONLY) || (flag_ == O_RDWR)) && (mode_ & A_READABLE))
+  {
+    int32 read_bytes = f_inode_->readData(offset_ + offset, count, buffer);
+    if (read_bytes > 0)
+      offset_ += read_bytes;
+    return read_bytes;
+  }
   else
   {
     // ERROR_FF
@@ -36,8 +41,13 @@ int32 RamFSFile::read(char *buffer, size_t count, l_off_t offset)
 
 int32 RamFSFile::write(const char *buffer, size_t count, l_off_t offset)
 {
-  if ((flag_ == O_WRONLY) || (flag_ == O_RDWR))
-    return (f_inode_->writeData(offset, count, buffer));
+  if (((flag_ == O_WRONLY) || (flag_ == O_RDWR)) && (mode_ & A_WRITABLE))
+  {
+    int32 written = f_inode_->writeData(offset_ + offset, count, buffer);
+    if (written > 0)
+      offset_ += written;
+    return written;
+  }
   else
   {
     // ERROR_FF
@@ -6,51 +6,114 @@
 #include "fs/Dentry.h"
 
 #include "console/kprintf.h"
-
-#define BASIC_ALLOC 256
+#include "console/debug.h"
+#include "ArchMemory.h"
+#include "PageManager.h"
 
 RamFSInode::RamFSInode(Superblock *super_block, uint32 inode_type) :
-    Inode(super_block, inode_type), data_(0)
+    Inode(super_block, inode_type), pages_lock_("RamFSInode::pages_lock_")
 {
-  if (inode_type == I_FILE)
-    data_ = new char[BASIC_ALLOC];
-
-  i_size_ = BASIC_ALLOC;
+  i_size_ = 0;
   i_nlink_ = 0;
   i_dentry_ = 0;
 }
 
 RamFSInode::~RamFSInode()
 {
-  delete[] data_;
 }
 
 int32 RamFSInode::readData(uint32 offset, uint32 size, char *buffer)
 {
-  if ((size + offset) > BASIC_ALLOC)
+  MutexLock lock(pages_lock_);
+  if ((size + offset) > i_size_)
   {
-    kprintfd("RamFSInode::ERROR: the size is bigger than size of the file\n");
-    assert(true);
+    if (i_size_ <= offset)
+      return 0;
+    size = i_size_ - offset;
   }
 
-  char *ptr_offset = data_ + offset;
-  memcpy(buffer, ptr_offset, size);
+  uint32 index = 0;
+  while (index < size)
+  {
+    uint32 page_offset = (offset + index) % PAGE_SIZE;
+    uint32 count = size - index;
+    if (count > PAGE_SIZE - page_offset)
+      count = PAGE_SIZE - page_offset;
+    size_t page = pages_.getPage((offset + index) / PAGE_SIZE, false);
+    if (page)
+      memcpy(buffer + index, (char*) ArchMemory::getIdentAddressOfPPN(page) + page_offset, count);
+    else
+      memset(buffer + index, 0, count); // hole
+    index += count;
+  }
   return size;
 }
 
 int32 RamFSInode::writeData(uint32 offset, uint32 size, const char *buffer)
 {
-  if ((size + offset) > BASIC_ALLOC)
+  assert(i_type_ == I_FILE);
+
+  if (offset + size < offset)
   {
-    kprintfd("RamFSInode::ERROR: the size is bigger than size of the file\n");
-    assert(true);
+    debug(RAMFS, "writeData: the file would be larger than 4GB\n");
+    return -1;
   }
 
-  assert(i_type_ == I_FILE);
+  MutexLock lock(pages_lock_);
+  uint32 index = 0;
+  while (index < size)
+  {
+    uint32 page_offset = (offset + index) % PAGE_SIZE;
+    uint32 count = size - index;
+    if (count > PAGE_SIZE - page_offset)
+      count = PAGE_SIZE - page_offset;
+    // the nodes of the page tree are charged with the data page
+    size_t missing = pages_.getNumMissingPages((offset + index) / PAGE_SIZE);
+    if (missing && !chargePages(missing))
+      break;
+    size_t page = pages_.getPage((offset + index) / PAGE_SIZE, true);
+    memcpy((char*) ArchMemory::getIdentAddressOfPPN(page) + page_offset, buffer + index, count);
+    index += count;
+  }
+  if (index == 0 && size > 0)
+    return -1;
+  if (offset + index > i_size_)
+    i_size_ = offset + index;
+  return index;
+}
 
-  char *ptr_offset = data_ + offset;
-  memcpy(ptr_offset, buffer, size);
-  return size;
+int32 RamFSInode::truncate(uint32 size)
+{
+  if (i_type_ != I_FILE)
+    return -1;
+
+  MutexLock lock(pages_lock_);
+  if (size < i_size_)
+  {
+    size_t num_pages = pages_.getNumPages() + pages_.getNumNodes();
+    pages_.freePages((size + PAGE_SIZE - 1) / PAGE_SIZE);
+    unchargePages(num_pages - pages_.getNumPages() - pages_.getNumNodes());
+    // a later grow has to read zeros behind the new end
+    size_t page = (size % PAGE_SIZE) ? pages_.getPage(size / PAGE_SIZE, false) : 0;
+    if (page)
+      memset((char*) ArchMemory::getIdentAddressOfPPN(page) + size % PAGE_SIZE, 0, PAGE_SIZE - size % PAGE_SIZE);
+  }
+  i_size_ = size;
+  return 0;
+}
+
+size_t RamFSInode::getSharedPage(uint32 index)
+{
+  if (i_type_ != I_FILE)
+    return 0;
+
+  MutexLock lock(pages_lock_);
+  size_t missing = pages_.getNumMissingPages(index);
+  if (missing && !chargePages(missing))
+    return 0;
+  size_t page = pages_.getPage(index, true);
+  PageManager::instance()->refPPN(page);
+  return page;
 }
 
 int32 RamFSInode::mknod(Dentry *dentry)
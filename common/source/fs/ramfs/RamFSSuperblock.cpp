@@ -45,17 +45,17 @@ RamFSSuperblock::~RamFSSuperblock()
 
   for (FileDescriptor* fd : s_files_)
   {
+    s_files_.remove(fd);
     delete fd->getFile();
     delete fd;
   }
-  s_files_.clear();
 
   for (Inode* inode : all_inodes_)
   {
+    all_inodes_.remove(inode);
     delete inode->getDentry();
     delete inode;
   }
-  all_inodes_.clear();
 }
 
 Inode* RamFSSuperblock::createInode(Dentry* dentry, uint32 type)
@@ -83,7 +83,7 @@ int32 RamFSSuperblock::readInode(Inode* inode)
 {
   assert(inode);
 
-  if (ustl::find(all_inodes_, inode) == all_inodes_.end())
+  if (!all_inodes_.contains(inode))
   {
     all_inodes_.push_back(inode);
   }
@@ -94,7 +94,7 @@ void RamFSSuperblock::writeInode(Inode* inode)
 {
   assert(inode);
 
-  if (ustl::find(all_inodes_, inode) == all_inodes_.end())
+  if (!all_inodes_.contains(inode))
   {
     all_inodes_.push_back(inode);
   }
@@ -102,7 +102,8 @@ void RamFSSuperblock::writeInode(Inode* inode)
 
 void RamFSSuperblock::delete_inode(Inode* inode)
 {
-  all_inodes_.remove(inode);
+  // frees the pages of the file as well
+  Superblock::delete_inode(inode);
 }
 
 int32 RamFSSuperblock::createFd(Inode* inode, uint32 flag)
@@ -114,7 +115,7 @@ int32 RamFSSuperblock::createFd(Inode* inode, uint32 flag)
   s_files_.push_back(fd);
   FileDescriptor::add(fd);
 
-  if (ustl::find(used_inodes_, inode) == used_inodes_.end())
+  if (!used_inodes_.contains(inode))
   {
     used_inodes_.push_back(inode);
   }
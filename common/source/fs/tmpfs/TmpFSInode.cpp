@@ -0,0 +1,34 @@
+/**
+ * @file TmpFSInode.cpp
+ */
+
+#include "fs/tmpfs/TmpFSInode.h"
+#include "fs/tmpfs/TmpFSSuperblock.h"
+
+#include "console/kprintf.h"
+#include "console/debug.h"
+
+TmpFSInode::TmpFSInode(TmpFSSuperblock *super_block, uint32 inode_type) :
+    RamFSInode(super_block, inode_type)
+{
+}
+
+TmpFSSuperblock* TmpFSInode::superblock()
+{
+  return (TmpFSSuperblock*) superblock_;
+}
+
+bool TmpFSInode::chargePages(size_t num_pages)
+{
+  if (!superblock()->reservePages(num_pages))
+  {
+    debug(TMPFS, "chargePages: no space left for %zu pages\n", num_pages);
+    return false;
+  }
+  return true;
+}
+
+void TmpFSInode::unchargePages(size_t num_pages)
+{
+  superblock()->releasePages(num_pages);
+}
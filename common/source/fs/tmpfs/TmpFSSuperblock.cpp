@@ -0,0 +1,64 @@
+/**
+ * @file TmpFSSuperblock.cpp
+ */
+
+#include "fs/tmpfs/TmpFSSuperblock.h"
+#include "fs/tmpfs/TmpFSInode.h"
+#include "assert.h"
+
+#include "console/kprintf.h"
+#include "console/debug.h"
+
+TmpFSSuperblock::TmpFSSuperblock(Dentry* s_root, uint32 s_dev, size_t max_pages) :
+    RamFSSuperblock(s_root, s_dev), max_pages_(max_pages), num_pages_(0), pages_lock_("TmpFSSuperblock::pages_lock_")
+{
+  debug(TMPFS, "mounted with a limit of %zu pages\n", max_pages_);
+}
+
+Inode* TmpFSSuperblock::createInode(Dentry* dentry, uint32 type)
+{
+  Inode *inode = (Inode*) (new TmpFSInode(this, type));
+  assert(inode);
+  if (type == I_DIR)
+  {
+    debug(TMPFS, "createInode: I_DIR\n");
+    int32 inode_init = inode->mknod(dentry);
+    assert(inode_init == 0);
+  }
+  else if (type == I_FILE)
+  {
+    debug(TMPFS, "createInode: I_FILE\n");
+    int32 inode_init = inode->mkfile(dentry);
+    assert(inode_init == 0);
+  }
+
+  all_inodes_.push_back(inode);
+  return inode;
+}
+
+void TmpFSSuperblock::delete_inode(Inode* inode)
+{
+  // pages still mapped somewhere stay allocated until they are unmapped,
+  // but they do not belong to the mount anymore
+  releasePages(((TmpFSInode*) inode)->getNumPages());
+  RamFSSuperblock::delete_inode(inode);
+}
+
+bool TmpFSSuperblock::reservePages(size_t num_pages)
+{
+  MutexLock lock(pages_lock_);
+  if (num_pages > max_pages_ - num_pages_)
+  {
+    debug(TMPFS, "reservePages: %zu pages requested, %zu of %zu in use\n", num_pages, num_pages_, max_pages_);
+    return false;
+  }
+  num_pages_ += num_pages;
+  return true;
+}
+
+void TmpFSSuperblock::releasePages(size_t num_pages)
+{
+  MutexLock lock(pages_lock_);
+  assert(num_pages <= num_pages_);
+  num_pages_ -= num_pages;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file TmpFSType.cpp
+ */
+
+#include "fs/tmpfs/TmpFSType.h"
+#include "fs/tmpfs/TmpFSSuperblock.h"
+
+
+TmpFSType::TmpFSType(size_t max_pages) : FileSystemType("tmpfs"), max_pages_(max_pages)
+{
+}
+
+
+TmpFSType::~TmpFSType()
+{}
+
+
+Superblock *TmpFSType::readSuper(Superblock *superblock, void*) const
+{
+  return superblock;
+}
+
+
+Superblock *TmpFSType::createSuper(Dentry *root, uint32 s_dev) const
+{
+  Superblock *super = new TmpFSSuperblock(root, s_dev, max_pages_);
+  return super;
+}
@@ -0,0 +1,395 @@
+/**
+ * @file KernelBenchmark.cpp
+ */
+
+#include "KernelBenchmark.h"
+#include "ProcessRegistry.h"
+#include "Scheduler.h"
+#include "Mutex.h"
+#include "Condition.h"
+#include "PageManager.h"
+#include "ArchMemory.h"
+#include "ArchCommon.h"
+#include "BDManager.h"
+#include "BDVirtualDevice.h"
+#include "kmalloc.h"
+#include "kprintf.h"
+#include "kstring.h"
+
+#define KMALLOC_ITERATIONS 1000
+#define KMALLOC_MIX_BLOCKS 128
+#define KMALLOC_MIX_ROUNDS 20
+#define PPN_ITERATIONS 1000
+#define PPN_BATCH 256
+#define PAGING_ITERATIONS 1000
+#define PAGING_VPN 0x1000 // somewhere in userspace of a fresh address space
+#define MUTEX_ITERATIONS 10000
+#define MUTEX_CONTENDED_ITERATIONS 1000
+#define CONDITION_ROUNDS 1000
+#define YIELD_ITERATIONS 1000
+#define BLOCKDEVICE_READS 256
+
+/**
+ * kernel thread running one half of a two thread benchmark
+ */
+class KernelBenchmarkHelper : public Thread
+{
+  public:
+    KernelBenchmarkHelper(FileSystemInfo *working_dir, void (*function)(void*), void* argument, volatile bool* done) :
+        Thread(working_dir, "KernelBenchmarkHelper", Thread::KERNEL_THREAD), function_(function), argument_(argument),
+        done_(done)
+    {
+    }
+
+    virtual ~KernelBenchmarkHelper()
+    {
+      // the working directory belongs to the benchmark thread
+      working_dir_ = 0;
+    }
+
+    virtual void Run()
+    {
+      function_(argument_);
+      *done_ = true;
+    }
+
+  private:
+    void (*function_)(void*);
+    void* argument_;
+    volatile bool* done_;
+};
+
+/**
+ * the same sequence on every run, so that runs can be compared
+ */
+static size_t nextRandom(size_t& state)
+{
+  state = state * 1103515245 + 12345;
+  return (state >> 16) & 0x7FFF;
+}
+
+KernelBenchmark::KernelBenchmark(FileSystemInfo *root_fs_info, char const *benchmarks[], char const *progs[]) :
+    Thread(root_fs_info, "KernelBenchmark", Thread::KERNEL_THREAD), benchmarks_(benchmarks), progs_(progs)
+{
+}
+
+void KernelBenchmark::Run()
+{
+  kprintfd("BENCH_BEGIN\n");
+  if (selected("kmalloc"))
+    benchmarkKmalloc();
+  if (selected("ppn"))
+    benchmarkPPN();
+  if (selected("paging"))
+    benchmarkPaging();
+  if (selected("mutex"))
+    benchmarkMutex();
+  if (selected("condition"))
+    benchmarkCondition();
+  if (selected("yield"))
+    benchmarkYield();
+  if (selected("blockdevice"))
+    benchmarkBlockDevice();
+  kprintfd("BENCH_END\n");
+
+  Scheduler::instance()->addNewThread(new ProcessRegistry(new FileSystemInfo(*getWorkingDirInfo()), progs_));
+}
+
+bool KernelBenchmark::selected(const char* name) const
+{
+  for (size_t i = 0; benchmarks_[i]; ++i)
+  {
+    if (!strcmp(benchmarks_[i], name) || !strcmp(benchmarks_[i], "all"))
+      return true;
+  }
+  return false;
+}
+
+void KernelBenchmark::begin(Result& result)
+{
+  result.iterations = 0;
+  result.total = 0;
+  result.min = -1ULL;
+  result.max = 0;
+}
+
+void KernelBenchmark::add(Result& result, uint64 cycles)
+{
+  ++result.iterations;
+  result.total += cycles;
+  if (cycles < result.min)
+    result.min = cycles;
+  if (cycles > result.max)
+    result.max = cycles;
+}
+
+void KernelBenchmark::print(const char* name, Result& result, size_t bytes)
+{
+  if (!result.iterations)
+    return;
+  kprintfd("BENCH %s iterations=%zu cycles=%llu per_iteration=%llu min=%llu max=%llu", name, result.iterations,
+           (unsigned long long) result.total, (unsigned long long) (result.total / result.iterations),
+           (unsigned long long) result.min, (unsigned long long) result.max);
+  if (bytes)
+    kprintfd(" bytes=%zu", bytes);
+  kprintfd("\n");
+}
+
+void KernelBenchmark::printTotal(const char* name, size_t iterations, uint64 cycles)
+{
+  kprintfd("BENCH %s iterations=%zu cycles=%llu per_iteration=%llu\n", name, iterations, (unsigned long long) cycles,
+           (unsigned long long) (cycles / iterations));
+}
+
+void KernelBenchmark::runPair(void (*function)(void*), void (*own_part)(void*), void* argument)
+{
+  volatile bool done = false;
+  Scheduler::instance()->addNewThread(new KernelBenchmarkHelper(getWorkingDirInfo(), function, argument, &done));
+  own_part(argument);
+  while (!done)
+    Scheduler::instance()->yield();
+}
+
+void KernelBenchmark::benchmarkKmalloc()
+{
+  static const struct
+  {
+    size_t size;
+    const char* kmalloc_name;
+    const char* kfree_name;
+  } sizes[] = {
+    { 16, "kmalloc_16", "kfree_16" }, { 64, "kmalloc_64", "kfree_64" }, { 256, "kmalloc_256", "kfree_256" },
+    { 1024, "kmalloc_1024", "kfree_1024" }, { 4096, "kmalloc_4096", "kfree_4096" },
+    { 16384, "kmalloc_16384", "kfree_16384" }
+  };
+
+  Result alloc_result, free_result;
+  for (auto& size : sizes)
+  {
+    begin(alloc_result);
+    begin(free_result);
+    for (size_t i = 0; i < KMALLOC_ITERATIONS; ++i)
+    {
+      uint64 start = ArchCommon::getTimestamp();
+      void* block = kmalloc(size.size);
+      uint64 allocated = ArchCommon::getTimestamp();
+      kfree(block);
+      uint64 freed = ArchCommon::getTimestamp();
+      add(alloc_result, allocated - start);
+      add(free_result, freed - allocated);
+    }
+    print(size.kmalloc_name, alloc_result);
+    print(size.kfree_name, free_result);
+  }
+
+  // many live blocks of mixed sizes, freed in a different order than allocated
+  void* blocks[KMALLOC_MIX_BLOCKS];
+  size_t random = 1;
+  begin(alloc_result);
+  begin(free_result);
+  for (size_t round = 0; round < KMALLOC_MIX_ROUNDS; ++round)
+  {
+    for (size_t i = 0; i < KMALLOC_MIX_BLOCKS; ++i)
+    {
+      size_t size = 8 + nextRandom(random) % 2048;
+      uint64 start = ArchCommon::getTimestamp();
+      blocks[i] = kmalloc(size);
+      add(alloc_result, ArchCommon::getTimestamp() - start);
+    }
+    for (size_t i = 0; i < KMALLOC_MIX_BLOCKS; ++i)
+    {
+      void* block = blocks[(i * 37) % KMALLOC_MIX_BLOCKS]; // 37 and the number of blocks are coprime
+      uint64 start = ArchCommon::getTimestamp();
+      kfree(block);
+      add(free_result, ArchCommon::getTimestamp() - start);
+    }
+  }
+  print("kmalloc_mix", alloc_result);
+  print("kfree_mix", free_result);
+}
+
+void KernelBenchmark::benchmarkPPN()
+{
+  Result alloc_result, free_result;
+  begin(alloc_result);
+  begin(free_result);
+  for (size_t i = 0; i < PPN_ITERATIONS; ++i)
+  {
+    uint64 start = ArchCommon::getTimestamp();
+    uint32 ppn = PageManager::instance()->allocPPN();
+    uint64 allocated = ArchCommon::getTimestamp();
+    PageManager::instance()->freePPN(ppn);
+    uint64 freed = ArchCommon::getTimestamp();
+    add(alloc_result, allocated - start);
+    add(free_result, freed - allocated);
+  }
+  print("allocPPN", alloc_result);
+  print("freePPN", free_result);
+
+  uint32 ppns[PPN_BATCH];
+  begin(alloc_result);
+  begin(free_result);
+  for (size_t i = 0; i < PPN_BATCH; ++i)
+  {
+    uint64 start = ArchCommon::getTimestamp();
+    ppns[i] = PageManager::instance()->allocPPN();
+    add(alloc_result, ArchCommon::getTimestamp() - start);
+  }
+  for (size_t i = 0; i < PPN_BATCH; ++i)
+  {
+    uint64 start = ArchCommon::getTimestamp();
+    PageManager::instance()->freePPN(ppns[(i * 37) % PPN_BATCH]);
+    add(free_result, ArchCommon::getTimestamp() - start);
+  }
+  print("allocPPN_batch", alloc_result);
+  print("freePPN_batch", free_result);
+}
+
+void KernelBenchmark::benchmarkPaging()
+{
+  ArchMemory* memory = new ArchMemory();
+  // keeps the page tables alive, so only the mapping itself is measured
+  memory->mapPage(PAGING_VPN, PageManager::instance()->allocPPN(), 1);
+
+  Result map, unmap;
+  begin(map);
+  begin(unmap);
+  for (size_t i = 0; i < PAGING_ITERATIONS; ++i)
+  {
+    uint32 ppn = PageManager::instance()->allocPPN();
+    uint64 start = ArchCommon::getTimestamp();
+    memory->mapPage(PAGING_VPN + 1, ppn, 1);
+    uint64 mapped = ArchCommon::getTimestamp();
+    memory->unmapPage(PAGING_VPN + 1); // frees the physical page
+    uint64 unmapped = ArchCommon::getTimestamp();
+    add(map, mapped - start);
+    add(unmap, unmapped - mapped);
+  }
+  print("mapPage", map);
+  print("unmapPage", unmap);
+
+  delete memory;
+}
+
+static void mutexContendedPart(void* argument)
+{
+  Mutex* mutex = (Mutex*) argument;
+  for (size_t i = 0; i < MUTEX_CONTENDED_ITERATIONS; ++i)
+  {
+    mutex->acquire();
+    Scheduler::instance()->yield(); // let the other thread run into the held mutex
+    mutex->release();
+  }
+}
+
+void KernelBenchmark::benchmarkMutex()
+{
+  Mutex mutex("KernelBenchmark::mutex");
+  Result result;
+  begin(result);
+  for (size_t i = 0; i < MUTEX_ITERATIONS; ++i)
+  {
+    uint64 start = ArchCommon::getTimestamp();
+    mutex.acquire();
+    mutex.release();
+    add(result, ArchCommon::getTimestamp() - start);
+  }
+  print("mutex_uncontended", result);
+
+  uint64 start = ArchCommon::getTimestamp();
+  runPair(mutexContendedPart, mutexContendedPart, &mutex);
+  printTotal("mutex_contended", 2 * MUTEX_CONTENDED_ITERATIONS, ArchCommon::getTimestamp() - start);
+}
+
+struct PingPong
+{
+  PingPong() :
+      lock("KernelBenchmark::PingPong::lock"), changed(&lock, "KernelBenchmark::PingPong::changed"), turn(0)
+  {
+  }
+
+  Mutex lock;
+  Condition changed;
+  size_t turn;
+};
+
+static void pingPongPart(PingPong* state, size_t me)
+{
+  for (size_t i = 0; i < CONDITION_ROUNDS; ++i)
+  {
+    state->lock.acquire();
+    while (state->turn != me)
+      state->changed.wait();
+    state->turn = 1 - me;
+    state->changed.signal();
+    state->lock.release();
+  }
+}
+
+static void pingPart(void* argument)
+{
+  pingPongPart((PingPong*) argument, 0);
+}
+
+static void pongPart(void* argument)
+{
+  pingPongPart((PingPong*) argument, 1);
+}
+
+void KernelBenchmark::benchmarkCondition()
+{
+  PingPong state;
+  uint64 start = ArchCommon::getTimestamp();
+  runPair(pongPart, pingPart, &state);
+  printTotal("condition_pingpong", CONDITION_ROUNDS, ArchCommon::getTimestamp() - start);
+}
+
+void KernelBenchmark::benchmarkYield()
+{
+  Result result;
+  begin(result);
+  for (size_t i = 0; i < YIELD_ITERATIONS; ++i)
+  {
+    uint64 start = ArchCommon::getTimestamp();
+    Scheduler::instance()->yield();
+    add(result, ArchCommon::getTimestamp() - start);
+  }
+  print("yield", result);
+}
+
+void KernelBenchmark::benchmarkBlockDevice()
+{
+  BDManager* manager = BDManager::getInstance();
+  if (manager->device_list_.empty())
+  {
+    kprintfd("BENCH_SKIP blockdevice no device\n");
+    return;
+  }
+  BDVirtualDevice* device = manager->device_list_.front();
+  benchmarkBlockDeviceReads(device, false);
+  benchmarkBlockDeviceReads(device, true);
+}
+
+void KernelBenchmark::benchmarkBlockDeviceReads(BDVirtualDevice* device, bool random)
+{
+  uint32 block_size = device->getBlockSize();
+  uint32 num_blocks = device->getNumBlocks();
+  if (!num_blocks)
+    return;
+  char* buffer = new char[block_size];
+  size_t state = 1;
+  size_t bytes = 0;
+  Result result;
+  begin(result);
+  for (size_t i = 0; i < BLOCKDEVICE_READS; ++i)
+  {
+    uint32 block = random ? (nextRandom(state) * 0x8000 + nextRandom(state)) % num_blocks : i % num_blocks;
+    uint64 start = ArchCommon::getTimestamp();
+    int32 read = device->readData(block * block_size, block_size, buffer);
+    add(result, ArchCommon::getTimestamp() - start);
+    if (read > 0)
+      bytes += read;
+  }
+  print(random ? "blockdevice_random_read" : "blockdevice_sequential_read", result, bytes);
+  delete[] buffer;
+}
@@ -13,19 +13,35 @@
 #include <umemory.h>
 #include "File.h"
 #include "FileDescriptor.h"
+#include "Inode.h"
+#include "Profiler.h"
+#include "mman-definitions.h"
 
-Loader::Loader(ssize_t fd) : fd_(fd), hdr_(0), phdrs_(), program_binary_lock_("Loader::program_binary_lock_"), userspace_debug_info_(0)
+Loader::Loader(ssize_t fd) : fd_(fd), hdr_(0), phdrs_(), program_binary_lock_("Loader::program_binary_lock_"), userspace_debug_info_(0),
+    vmas_lock_("Loader::vmas_lock_")
 {
 }
 
 Loader::~Loader()
 {
+  // the mapped pages are freed by arch_memory_
+  for (VirtualMemoryArea* vma : vmas_)
+  {
+    writeBack(vma, vma->start_page_, vma->endPage());
+    if (vma->file_)
+      vma->file_->getInode()->unlink(vma->file_);
+    delete vma;
+  }
+  Profiler::releaseDebugInfo(userspace_debug_info_);
   delete userspace_debug_info_;
   delete hdr_;
 }
 
 void Loader::loadPage(pointer virtual_address)
 {
+  if (loadMappedPage(virtual_address))
+    return;
+
   MutexLock lock(program_binary_lock_);
   debug(LOADER, "Loader:loadPage: Request to load the page for address %p.\n", (void*)virtual_address);
   if(arch_memory_.checkAddressValid(virtual_address))
@@ -79,10 +95,204 @@ void Loader::loadPage(pointer virtual_address)
   debug(LOADER, "Loader:loadPage: Load request for address %p has been successfully finished.\n", (void*)virtual_address);
 }
 
+bool Loader::loadMappedPage(pointer virtual_address)
+{
+  size_t page = virtual_address / PAGE_SIZE;
+  MutexLock lock(vmas_lock_);
+  VirtualMemoryArea* vma = 0;
+  for (VirtualMemoryArea* area : vmas_)
+  {
+    if (area->contains(page))
+    {
+      vma = area;
+      break;
+    }
+  }
+  if (!vma)
+    return false;
+  if (arch_memory_.checkAddressValid(virtual_address))
+    return true;
+  if (vma->prot_ == PROT_NONE)
+  {
+    debug(LOADER, "Loader::loadMappedPage: ERROR! Access to %p, which is mapped without access rights.\n",
+          (void*) virtual_address);
+    vmas_lock_.release();
+    Syscall::exit(9999);
+  }
+  bool writeable = vma->prot_ & PROT_WRITE;
+
+  if (!vma->file_)
+  {
+    arch_memory_.mapPage(page, PageManager::instance()->allocPPN(), true, PAGE_SIZE, writeable);
+    debug(LOADER, "Loader::loadMappedPage: mapped a zeroed page at %p\n", (void*) (page * PAGE_SIZE));
+    return true;
+  }
+
+  size_t file_page = vma->file_page_ + page - vma->start_page_;
+  Inode* inode = vma->file_->getInode();
+  if (file_page * PAGE_SIZE >= inode->getSize())
+  {
+    debug(LOADER, "Loader::loadMappedPage: ERROR! Page %zu of the file is behind its end.\n", file_page);
+    vmas_lock_.release();
+    Syscall::exit(9999);
+  }
+
+  // file systems keeping their files in pages share them, writes go straight to the file
+  size_t ppn = (vma->flags_ & MAP_SHARED) ? inode->getSharedPage(file_page) : 0;
+  if (!ppn)
+  {
+    // a copy of the file, shared mappings write it back on sync
+    ppn = PageManager::instance()->allocPPN();
+    size_t size = inode->getSize() - file_page * PAGE_SIZE;
+    if (size > PAGE_SIZE)
+      size = PAGE_SIZE;
+    if (inode->readData(file_page * PAGE_SIZE, size, (char*) ArchMemory::getIdentAddressOfPPN(ppn)) < 0)
+    {
+      PageManager::instance()->freePPN(ppn);
+      debug(LOADER, "Loader::loadMappedPage: ERROR! Page %zu of the file could not be read.\n", file_page);
+      vmas_lock_.release();
+      Syscall::exit(9999);
+    }
+    vma->write_back_ = (vma->flags_ & MAP_SHARED) && writeable;
+  }
+  arch_memory_.mapPage(page, ppn, true, PAGE_SIZE, writeable);
+  debug(LOADER, "Loader::loadMappedPage: mapped page %zu of the file at %p\n", file_page, (void*) (page * PAGE_SIZE));
+  return true;
+}
+
+void Loader::writeBack(VirtualMemoryArea* vma, size_t first, size_t end)
+{
+  if (!vma->write_back_)
+    return;
+  Inode* inode = vma->file_->getInode();
+  for (size_t page = first; page < end; ++page)
+  {
+    pointer data = arch_memory_.checkAddressValid(page * PAGE_SIZE);
+    if (!data || !arch_memory_.testAndClearDirty(page))
+      continue;
+    // a file truncated since keeps its size, the data behind its end is dropped
+    size_t offset = (vma->file_page_ + page - vma->start_page_) * PAGE_SIZE;
+    if (offset >= inode->getSize())
+      continue;
+    size_t size = inode->getSize() - offset;
+    if (size > PAGE_SIZE)
+      size = PAGE_SIZE;
+    if (inode->writeData(offset, size, (const char*) data) != (int32) size)
+      debug(LOADER, "Loader::writeBack: ERROR! The page at %p could not be written back.\n", (void*) (page * PAGE_SIZE));
+  }
+}
+
+size_t Loader::findFreeRange(size_t start_page, size_t num_pages)
+{
+  if (start_page >= MMAP_START_PAGE && start_page + num_pages <= MMAP_END_PAGE)
+  {
+    bool free = true;
+    for (VirtualMemoryArea* vma : vmas_)
+      free = free && (vma->endPage() <= start_page || vma->start_page_ >= start_page + num_pages);
+    if (free)
+      return start_page;
+  }
+
+  // first fit
+  size_t candidate = MMAP_START_PAGE;
+  for (VirtualMemoryArea* vma : vmas_)
+  {
+    if (candidate + num_pages <= vma->start_page_)
+      break;
+    candidate = ustl::max(candidate, vma->endPage());
+  }
+  return (candidate + num_pages <= MMAP_END_PAGE) ? candidate : 0;
+}
+
+pointer Loader::mapFile(pointer start, size_t length, uint32 prot, uint32 flags, File* file, size_t offset)
+{
+  assert(length > 0 && offset % PAGE_SIZE == 0);
+  // rounded up without the overflow of length + PAGE_SIZE - 1
+  size_t num_pages = length / PAGE_SIZE + (length % PAGE_SIZE != 0);
+  MutexLock lock(vmas_lock_);
+  size_t start_page = findFreeRange((start % PAGE_SIZE) ? 0 : start / PAGE_SIZE, num_pages);
+  if (!start_page)
+    return 0;
+
+  VirtualMemoryArea* vma = new VirtualMemoryArea(start_page, num_pages, prot, flags, file, offset / PAGE_SIZE);
+  ustl::list<VirtualMemoryArea*>::iterator it = vmas_.begin();
+  while (it != vmas_.end() && (*it)->start_page_ < start_page)
+    ++it;
+  vmas_.insert(it, vma);
+  debug(LOADER, "Loader::mapFile: %zu pages at %p\n", num_pages, (void*) (start_page * PAGE_SIZE));
+  return start_page * PAGE_SIZE;
+}
+
+int32 Loader::unmap(pointer start, size_t length)
+{
+  if (start % PAGE_SIZE)
+    return -1;
+  size_t first = start / PAGE_SIZE;
+  size_t end = first + length / PAGE_SIZE + (length % PAGE_SIZE != 0);
+
+  MutexLock lock(vmas_lock_);
+  for (size_t i = 0; i < vmas_.size(); ++i)
+  {
+    VirtualMemoryArea* vma = vmas_[i];
+    size_t unmap_start = ustl::max(first, vma->start_page_);
+    size_t unmap_end = ustl::min(end, vma->endPage());
+    if (unmap_start >= unmap_end)
+      continue;
+
+    writeBack(vma, unmap_start, unmap_end);
+    for (size_t page = unmap_start; page < unmap_end; ++page)
+    {
+      if (arch_memory_.checkAddressValid(page * PAGE_SIZE))
+        arch_memory_.unmapPage(page); // frees a copy, drops the reference to a shared page of the file
+    }
+
+    if (unmap_start > vma->start_page_ && unmap_end < vma->endPage())
+    {
+      // a hole in the middle, the part behind it gets its own open file
+      File* file = vma->file_ ? vma->file_->getInode()->link(vma->file_->getFlag()) : 0;
+      VirtualMemoryArea* tail = new VirtualMemoryArea(unmap_end, vma->endPage() - unmap_end, vma->prot_, vma->flags_,
+                                                      file, vma->file_page_ + unmap_end - vma->start_page_);
+      tail->write_back_ = vma->write_back_;
+      vma->num_pages_ = unmap_start - vma->start_page_;
+      vmas_.insert(vmas_.begin() + i + 1, tail);
+      ++i;
+    }
+    else if (unmap_start > vma->start_page_)
+      vma->num_pages_ = unmap_start - vma->start_page_;
+    else if (unmap_end < vma->endPage())
+    {
+      vma->file_page_ += unmap_end - vma->start_page_;
+      vma->num_pages_ = vma->endPage() - unmap_end;
+      vma->start_page_ = unmap_end;
+    }
+    else
+    {
+      if (vma->file_)
+        vma->file_->getInode()->unlink(vma->file_);
+      delete vma;
+      vmas_.erase(vmas_.begin() + i);
+      --i;
+    }
+  }
+  return 0;
+}
+
+int32 Loader::sync(pointer start, size_t length)
+{
+  if (start % PAGE_SIZE)
+    return -1;
+  size_t first = start / PAGE_SIZE;
+  size_t end = first + length / PAGE_SIZE + (length % PAGE_SIZE != 0);
+
+  MutexLock lock(vmas_lock_);
+  for (VirtualMemoryArea* vma : vmas_)
+    writeBack(vma, ustl::max(first, vma->start_page_), ustl::min(end, vma->endPage()));
+  return 0;
+}
+
 bool Loader::readFromBinary (char* buffer, l_off_t position, size_t length)
 {
-  VfsSyscall::lseek(fd_, position, SEEK_SET);
-  return VfsSyscall::read(fd_, buffer, length) - (ssize_t)length;
+  return VfsSyscall::pread(fd_, buffer, length, position) - (ssize_t)length;
 }
 
 bool Loader::readHeaders()
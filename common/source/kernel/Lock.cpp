@@ -4,22 +4,46 @@
 #include "Thread.h"
 #include "ArchThreads.h"
 #include "ArchInterrupts.h"
+#include "ArchCommon.h"
+#include "kstring.h"
 #include "Scheduler.h"
 #include "Stabs2DebugInfo.h"
 extern Stabs2DebugInfo const* kernel_debug_info;
 
+Lock* Lock::locks_ = 0;
+
 Lock::Lock(const char *name) :
   held_by_(0),
   next_lock_on_holding_list_(0),
   last_accessed_at_(0),
   name_(name ? name : ""),
   waiters_list_(0),
-  waiters_list_lock_(0)
+  waiters_list_lock_(0),
+  acquired_at_(0),
+  previous_lock_(0)
 {
+  memset(&statistics_, 0, sizeof(statistics_));
+  bool interrupts_enabled = ArchInterrupts::disableInterrupts();
+  next_lock_ = locks_;
+  if(next_lock_)
+    next_lock_->previous_lock_ = this;
+  locks_ = this;
+  if(interrupts_enabled)
+    ArchInterrupts::enableInterrupts();
 }
 
 Lock::~Lock()
 {
+  bool interrupts_enabled = ArchInterrupts::disableInterrupts();
+  if(previous_lock_)
+    previous_lock_->next_lock_ = next_lock_;
+  else
+    locks_ = next_lock_;
+  if(next_lock_)
+    next_lock_->previous_lock_ = previous_lock_;
+  if(interrupts_enabled)
+    ArchInterrupts::enableInterrupts();
+
   if(unlikely(system_state != RUNNING))
     return;
   // copy the pointers to the stack because it may be reseted before printing the element out.
@@ -62,6 +86,91 @@ void Lock::printHoldingList(Thread* thread)
   }
 }
 
+void Lock::acquired(uint64 waiting_since)
+{
+  uint64 now = ArchCommon::getTimestamp();
+  ++statistics_.acquisitions;
+  if(waiting_since)
+  {
+    uint64 waited = now - waiting_since;
+    ++statistics_.contended;
+    statistics_.wait_total += waited;
+    if(waited > statistics_.wait_max)
+      statistics_.wait_max = waited;
+  }
+  acquired_at_ = now;
+}
+
+void Lock::releasing()
+{
+  if(!acquired_at_)
+    return;
+  uint64 held = ArchCommon::getTimestamp() - acquired_at_;
+  statistics_.hold_total += held;
+  if(held > statistics_.hold_max)
+    statistics_.hold_max = held;
+  acquired_at_ = 0;
+}
+
+size_t Lock::collectStatistics(StatisticsEntry* top, bool by_wait)
+{
+  size_t count = 0;
+  for(Lock* lock = locks_; lock != 0; lock = lock->next_lock_)
+  {
+    const LockStatistics& statistics = lock->getStatistics();
+    uint64 value = by_wait ? statistics.wait_total : statistics.hold_total;
+    if(!value)
+      continue;
+    size_t position = count;
+    while(position > 0 && value > (by_wait ? top[position - 1].statistics.wait_total :
+                                             top[position - 1].statistics.hold_total))
+      --position;
+    if(position >= LOCKSTAT_TOP)
+      continue;
+    if(count < LOCKSTAT_TOP)
+      ++count;
+    for(size_t i = count - 1; i > position; --i)
+      top[i] = top[i - 1];
+    top[position].name = lock->getName();
+    top[position].statistics = statistics;
+  }
+  return count;
+}
+
+void Lock::printStatistics()
+{
+  StatisticsEntry top[LOCKSTAT_TOP];
+  for(size_t section = 0; section < 2; ++section)
+  {
+    bool by_wait = (section == 0);
+    bool interrupts_enabled = ArchInterrupts::disableInterrupts();
+    size_t count = collectStatistics(top, by_wait);
+    if(interrupts_enabled)
+      ArchInterrupts::enableInterrupts();
+
+    kprintfd("Lock statistics, top %u by total %s time (timestamp units):\n", LOCKSTAT_TOP, by_wait ? "wait" : "hold");
+    kprintfd("%-32s %10s %10s %14s %12s %14s %12s\n", "lock", "acquired", "contended",
+             "wait total", "wait max", "hold total", "hold max");
+    for(size_t i = 0; i < count; ++i)
+    {
+      const LockStatistics& statistics = top[i].statistics;
+      kprintfd("%-32.32s %10llu %10llu %14llu %12llu %14llu %12llu\n", top[i].name,
+               (unsigned long long)statistics.acquisitions, (unsigned long long)statistics.contended,
+               (unsigned long long)statistics.wait_total, (unsigned long long)statistics.wait_max,
+               (unsigned long long)statistics.hold_total, (unsigned long long)statistics.hold_max);
+    }
+  }
+}
+
+void Lock::resetStatistics()
+{
+  bool interrupts_enabled = ArchInterrupts::disableInterrupts();
+  for(Lock* lock = locks_; lock != 0; lock = lock->next_lock_)
+    memset(&lock->statistics_, 0, sizeof(lock->statistics_));
+  if(interrupts_enabled)
+    ArchInterrupts::enableInterrupts();
+}
+
 void Lock::pushFrontToCurrentThreadHoldingList()
 {
   if(!currentThread)
@@ -2,6 +2,7 @@
 #include "kprintf.h"
 #include "ArchThreads.h"
 #include "ArchInterrupts.h"
+#include "ArchCommon.h"
 #include "Scheduler.h"
 #include "Thread.h"
 #include "panic.h"
@@ -41,6 +42,7 @@ bool Mutex::acquireNonBlocking(pointer called_by)
     return false;
   }
   assert(held_by_ == 0);
+  acquired(0);
   last_accessed_at_ = called_by;
   held_by_ = currentThread;
   pushFrontToCurrentThreadHoldingList();
@@ -60,8 +62,11 @@ void Mutex::acquire(pointer called_by)
 //    debug(LOCK, "The acquire is called by: ");
 //    kernel_debug_info->printCallInformation(called_by);
 //  }
+  uint64 waiting_since = 0;
   while(ArchThreads::testSetLock(mutex_, 1))
   {
+    if(!waiting_since)
+      waiting_since = ArchCommon::getTimestamp();
     checkCurrentThreadStillWaitingOnAnotherLock();
     lockWaitersList();
     // Here we have to check for the lock again, in case some one released it in between, we might sleep forever.
@@ -78,6 +83,7 @@ void Mutex::acquire(pointer called_by)
   }
 
   assert(held_by_ == 0);
+  acquired(waiting_since);
   pushFrontToCurrentThreadHoldingList();
   last_accessed_at_ = called_by;
   held_by_ = currentThread;
@@ -97,6 +103,7 @@ void Mutex::release(pointer called_by)
 //    kernel_debug_info->printCallInformation(called_by);
 //  }
   checkInvalidRelease("Mutex::release");
+  releasing();
   removeFromCurrentThreadHoldingList();
   last_accessed_at_ = called_by;
   held_by_ = 0;
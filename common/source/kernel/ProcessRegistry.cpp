@@ -41,6 +41,11 @@ void ProcessRegistry::Run()
   vfs_syscall.mount("idea1", "/usr", "minixfs", 0);
   debug(PROCESS_REG, "mount idea1\n");
 
+  // temporary files stay in memory
+  vfs_syscall.mkdir("/tmp", 0);
+  vfs_syscall.mount("", "/tmp", "tmpfs", 0);
+  debug(PROCESS_REG, "mount tmpfs on /tmp\n");
+
   for (uint32 i = 0; progs_[i]; i++)
   {
     createProcess(progs_[i]);
@@ -55,6 +60,7 @@ void ProcessRegistry::Run()
 
   debug(PROCESS_REG, "unmounting userprog-partition because all processes terminated \n");
 
+  vfs_syscall.umount("/tmp", 0);
   vfs_syscall.umount("/usr", 0);
 
   Scheduler::instance()->printStackTraces();
@@ -0,0 +1,255 @@
+/**
+ * @file Profiler.cpp
+ */
+
+#include "Profiler.h"
+#include "Thread.h"
+#include "Loader.h"
+#include "ArchInterrupts.h"
+#include "ArchThreads.h"
+#include "Stabs2DebugInfo.h"
+#include "backtrace.h"
+#include "kprintf.h"
+#include "kstring.h"
+#include "umap.h"
+#include "uvector.h"
+
+extern Stabs2DebugInfo const *kernel_debug_info;
+
+Profiler* Profiler::instance_ = 0;
+
+Profiler* Profiler::instance()
+{
+  if (unlikely(!instance_))
+    instance_ = new Profiler();
+  return instance_;
+}
+
+Profiler::Profiler() :
+    period_(0), ticks_(0), samples_(0), dropped_(0), lock_("Profiler::lock_")
+{
+  memset(buckets_, 0, sizeof(buckets_));
+}
+
+void Profiler::timerTick(pointer instruction_pointer)
+{
+  Profiler* profiler = instance_;
+  if (!profiler || !profiler->period_ || ++profiler->ticks_ < profiler->period_)
+    return;
+  profiler->ticks_ = 0;
+  profiler->sample(instruction_pointer);
+}
+
+void Profiler::releaseDebugInfo(Stabs2DebugInfo const* debug_info)
+{
+  if (!instance_ || !debug_info)
+    return;
+  MutexLock lock(instance_->lock_);
+  bool interrupts_enabled = ArchInterrupts::disableInterrupts();
+  for (Bucket& bucket : instance_->buckets_)
+  {
+    if (bucket.count && bucket.debug_info == debug_info)
+      bucket.debug_info = 0;
+  }
+  if (interrupts_enabled)
+    ArchInterrupts::enableInterrupts();
+}
+
+void Profiler::start(size_t period)
+{
+  ticks_ = 0;
+  period_ = period ? period : 1;
+}
+
+void Profiler::stop()
+{
+  period_ = 0;
+}
+
+bool Profiler::isRunning() const
+{
+  return period_ != 0;
+}
+
+void Profiler::reset()
+{
+  MutexLock lock(lock_);
+  bool interrupts_enabled = ArchInterrupts::disableInterrupts();
+  memset(buckets_, 0, sizeof(buckets_));
+  samples_ = 0;
+  dropped_ = 0;
+  if (interrupts_enabled)
+    ArchInterrupts::enableInterrupts();
+}
+
+void Profiler::sample(pointer instruction_pointer)
+{
+  if (!currentThread)
+    return;
+
+  pointer frames[PROFILER_DEPTH];
+  Stabs2DebugInfo const* debug_info;
+  int depth;
+  if (currentThread->switch_to_userspace_)
+  {
+    debug_info = currentThread->loader_ ? currentThread->loader_->getDebugInfos() : 0;
+    depth = backtrace_user(frames, PROFILER_DEPTH, currentThread, true);
+  }
+  else
+  {
+    debug_info = kernel_debug_info;
+    depth = backtrace(frames, PROFILER_DEPTH, currentThread, true);
+  }
+  if (depth <= 0)
+  {
+    // no frame walking on this architecture, count the instruction only
+    frames[0] = instruction_pointer;
+    depth = 1;
+  }
+  record(debug_info, frames, depth);
+}
+
+void Profiler::record(Stabs2DebugInfo const* debug_info, pointer* frames, size_t depth)
+{
+  ++samples_;
+  size_t hash = (size_t) debug_info;
+  for (size_t i = 0; i < depth; ++i)
+    hash = hash * 31 + frames[i];
+  hash ^= hash >> 12;
+
+  for (size_t probe = 0; probe < PROFILER_BUCKETS; ++probe)
+  {
+    Bucket& bucket = buckets_[(hash + probe) & (PROFILER_BUCKETS - 1)];
+    if (bucket.count == 0)
+    {
+      bucket.debug_info = debug_info;
+      bucket.depth = depth;
+      memcpy(bucket.frames, frames, depth * sizeof(pointer));
+      bucket.count = 1;
+      return;
+    }
+    if (bucket.debug_info == debug_info && bucket.depth == depth &&
+        memcmp(bucket.frames, frames, depth * sizeof(pointer)) == 0)
+    {
+      ++bucket.count;
+      return;
+    }
+  }
+  ++dropped_;
+}
+
+pointer Profiler::functionStart(Stabs2DebugInfo const* debug_info, pointer address) const
+{
+  if (!debug_info)
+    return address;
+  pointer start = debug_info->getFunctionStart(address);
+  return start ? start : address;
+}
+
+void Profiler::printFunction(Stabs2DebugInfo const* debug_info, pointer function) const
+{
+  char name[CALL_FUNC_NAME_LIMIT];
+  if (debug_info && debug_info->getFunctionName(function, name, sizeof(name)))
+    kprintfd("%s", name);
+  else
+    kprintfd("%zx", function);
+}
+
+typedef ustl::pair<size_t, pointer> ProfiledFunction; // debug info, start of the function
+typedef ustl::pair<ProfiledFunction, ProfiledFunction> ProfiledCall; // caller, callee
+
+/**
+ * @return the index of the largest value not printed yet, -1 if all were printed
+ */
+static ssize_t nextLargest(ustl::vector<size_t>& values, ustl::vector<bool>& printed)
+{
+  ssize_t largest = -1;
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    if (!printed[i] && (largest < 0 || values[i] > values[largest]))
+      largest = i;
+  }
+  if (largest >= 0)
+    printed[largest] = true;
+  return largest;
+}
+
+void Profiler::printProfile()
+{
+  MutexLock lock(lock_);
+  size_t period = period_;
+  period_ = 0; // the histogram must not change while it is read
+
+  ustl::map<ProfiledFunction, size_t> self;
+  ustl::map<ProfiledFunction, size_t> total;
+  ustl::map<ProfiledCall, size_t> calls;
+  for (Bucket& bucket : buckets_)
+  {
+    if (!bucket.count)
+      continue;
+    ProfiledFunction functions[PROFILER_DEPTH];
+    for (size_t i = 0; i < bucket.depth; ++i)
+      functions[i] = ProfiledFunction((size_t) bucket.debug_info, functionStart(bucket.debug_info, bucket.frames[i]));
+
+    self[functions[0]] += bucket.count;
+    for (size_t i = 0; i < bucket.depth; ++i)
+    {
+      bool counted = false;
+      for (size_t j = 0; j < i; ++j)
+        counted = counted || (functions[j] == functions[i]);
+      if (!counted)
+        total[functions[i]] += bucket.count; // recursion counts once per sample
+      if (i + 1 < bucket.depth)
+        calls[ProfiledCall(functions[i + 1], functions[i])] += bucket.count;
+    }
+  }
+
+  size_t samples = samples_ ? samples_ : 1;
+  kprintfd("Profiler: %zu samples, %zu dropped, %s, period %zu ticks\n", samples_, dropped_,
+           period ? "running" : "stopped", period);
+
+  kprintfd("Flat profile:\n  self%%  total%%    self   total  function\n");
+  ustl::vector<ProfiledFunction> functions;
+  ustl::vector<size_t> counts;
+  for (auto entry : self)
+  {
+    functions.push_back(entry.first);
+    counts.push_back(entry.second);
+  }
+  ustl::vector<bool> printed(counts.size(), false);
+  for (size_t n = 0; n < PROFILER_TOP; ++n)
+  {
+    ssize_t i = nextLargest(counts, printed);
+    if (i < 0)
+      break;
+    size_t function_total = total[functions[i]];
+    kprintfd("%6zu %6zu %7zu %7zu  ", counts[i] * 100 / samples, function_total * 100 / samples, counts[i],
+             function_total);
+    printFunction((Stabs2DebugInfo const*) functions[i].first, functions[i].second);
+    kprintfd("\n");
+  }
+
+  kprintfd("Call graph:\n  count  caller -> callee\n");
+  ustl::vector<ProfiledCall> edges;
+  counts.clear();
+  for (auto entry : calls)
+  {
+    edges.push_back(entry.first);
+    counts.push_back(entry.second);
+  }
+  printed.assign(counts.size(), false);
+  for (size_t n = 0; n < PROFILER_TOP; ++n)
+  {
+    ssize_t i = nextLargest(counts, printed);
+    if (i < 0)
+      break;
+    kprintfd("%7zu  ", counts[i]);
+    printFunction((Stabs2DebugInfo const*) edges[i].first.first, edges[i].first.second);
+    kprintfd(" -> ");
+    printFunction((Stabs2DebugInfo const*) edges[i].second.first, edges[i].second.second);
+    kprintfd("\n");
+  }
+
+  ticks_ = 0;
+  period_ = period;
+}
@@ -13,6 +13,7 @@
 #include "umap.h"
 #include "ustring.h"
 #include "Lock.h"
+#include "kstring.h"
 
 ArchThreadRegisters *currentThreadRegisters;
 Thread *currentThread;
@@ -30,6 +31,7 @@ Scheduler::Scheduler()
 {
   block_scheduling_ = 0;
   ticks_ = 0;
+  usage_ticks_seen_ = 0;
   addNewThread(&cleanup_thread_);
   addNewThread(&idle_thread_);
 }
@@ -49,11 +51,30 @@ uint32 Scheduler::schedule()
 
     ustl::rotate(threads_.begin(), threads_.begin() + 1, threads_.end()); // no new/delete here - important because interrupts are disabled
 
+    if (currentThread->wakeup_tick_ && currentThread->state_ == Sleeping &&
+        (ssize_t) (ticks_ - currentThread->wakeup_tick_) >= 0)
+    {
+      currentThread->wakeup_tick_ = 0;
+      currentThread->state_ = Running;
+    }
+
     if ((currentThread == previousThread) && (currentThread->state_ != Running))
     {
       debug(SCHEDULER, "Scheduler::schedule: ERROR: currentThread == previousThread! Either no thread is in state Running or you added the same thread more than once.\n");
     }
   } while (!currentThread->schedulable());
+
+  if (previousThread)
+  {
+    if (currentThread != previousThread)
+    {
+      if (previousThread->yielding_ || previousThread->state_ != Running)
+        ++previousThread->usage_.voluntary_switches;
+      else
+        ++previousThread->usage_.involuntary_switches;
+    }
+    previousThread->yielding_ = false;
+  }
 //  debug ( SCHEDULER,"Scheduler::schedule: new currentThread is %p %s, switch_userspace:%d\n",currentThread,currentThread ? currentThread->getName() : 0,currentThread ? currentThread->switch_to_userspace_ : 0);
 
   uint32 ret = 1;
@@ -88,6 +109,14 @@ void Scheduler::sleep()
   yield();
 }
 
+void Scheduler::sleepTicks(size_t ticks)
+{
+  // 0 means no timed sleep, waking up a tick later does no harm
+  currentThread->wakeup_tick_ = (ticks_ + ticks) ? ticks_ + ticks : 1;
+  sleep();
+  currentThread->wakeup_tick_ = 0;
+}
+
 void Scheduler::wake(Thread* thread_to_wake)
 {
   thread_to_wake->state_ = Running;
@@ -103,6 +132,8 @@ void Scheduler::yield()
              currentThread, currentThread->name_.c_str());
     currentThread->printBacktrace();
   }
+  if (currentThread)
+    currentThread->yielding_ = true;
   ArchThreads::yield();
 }
 
@@ -179,6 +210,13 @@ uint32 Scheduler::getTicks()
 void Scheduler::incTicks()
 {
   ++ticks_;
+  if (currentThread)
+  {
+    if (currentThread->switch_to_userspace_)
+      ++currentThread->usage_.user_ticks;
+    else
+      ++currentThread->usage_.kernel_ticks;
+  }
 }
 
 void Scheduler::printStackTraces()
@@ -220,10 +258,103 @@ void Scheduler::printLockingInformation()
             thread->lock_waiting_on_ ->getName(), thread->lock_waiting_on_ );
     }
   }
+  unlockScheduling();
+  Lock::printStatistics();
   debug(LOCK, "Scheduler::printLockingInformation finished\n");
+}
+
+void Scheduler::getUsage(Thread* thread, bool whole_process, ResourceUsage& usage, uint32* syscall_counts)
+{
+  memset(&usage, 0, sizeof(usage));
+  if (syscall_counts)
+    memset(syscall_counts, 0, RUSAGE_SYSCALLS * sizeof(uint32));
+
+  lockScheduling();
+  for (size_t i = 0; i < threads_.size(); ++i)
+  {
+    Thread* t = threads_[i];
+    if (t != thread && !(whole_process && thread->loader_ && t->loader_ == thread->loader_))
+      continue;
+    usage.user_ticks += t->usage_.user_ticks;
+    usage.kernel_ticks += t->usage_.kernel_ticks;
+    usage.voluntary_switches += t->usage_.voluntary_switches;
+    usage.involuntary_switches += t->usage_.involuntary_switches;
+    usage.page_faults += t->usage_.page_faults;
+    usage.syscalls += t->usage_.syscalls;
+    usage.bytes_read += t->usage_.bytes_read;
+    usage.bytes_written += t->usage_.bytes_written;
+    if (syscall_counts)
+    {
+      for (size_t n = 0; n < RUSAGE_SYSCALLS; ++n)
+        syscall_counts[n] += t->syscall_counts_[n];
+    }
+  }
   unlockScheduling();
 }
 
+struct ThreadUsageLine
+{
+  size_t tid;
+  char state;
+  char name[16];
+  uint64 ticks; // since the last view
+  ResourceUsage usage;
+};
+
+void Scheduler::printUsage()
+{
+  ThreadUsageLine lines[USAGE_TOP];
+  size_t count = 0;
+  size_t num_threads;
+
+  // copy the counters while no thread can be created or destroyed, print afterwards
+  lockScheduling();
+  size_t elapsed = ticks_ - usage_ticks_seen_;
+  usage_ticks_seen_ = ticks_;
+  num_threads = threads_.size();
+  for (size_t i = 0; i < threads_.size(); ++i)
+  {
+    Thread* thread = threads_[i];
+    uint64 ticks = thread->usage_.user_ticks + thread->usage_.kernel_ticks;
+    uint64 recent = ticks - thread->ticks_seen_;
+    thread->ticks_seen_ = ticks;
+
+    size_t position = count;
+    while (position > 0 && recent > lines[position - 1].ticks)
+      --position;
+    if (position >= USAGE_TOP)
+      continue;
+    if (count < USAGE_TOP)
+      ++count;
+    for (size_t j = count - 1; j > position; --j)
+      lines[j] = lines[j - 1];
+    ThreadUsageLine& line = lines[position];
+    line.tid = thread->getTID();
+    line.state = Thread::threadStatePrintable[thread->state_][0];
+    strncpy(line.name, thread->getName(), sizeof(line.name) - 1);
+    line.name[sizeof(line.name) - 1] = 0;
+    line.ticks = recent;
+    line.usage = thread->usage_;
+  }
+  unlockScheduling();
+
+  if (!elapsed)
+    elapsed = 1;
+  kprintf("%zu threads, %zu ticks since the last view, ticks and KiB are totals\n", num_threads, elapsed);
+  kprintf("  TID CPU%% S  user  kern   vol invol fault  sysc  rd KiB  wr KiB name\n");
+  for (size_t i = 0; i < count; ++i)
+  {
+    ResourceUsage& usage = lines[i].usage;
+    kprintf("%5zu %4zu %c %5llu %5llu %5llu %5llu %5llu %5llu %7llu %7llu %.14s\n", lines[i].tid,
+            (size_t) (lines[i].ticks * 100 / elapsed), lines[i].state,
+            (unsigned long long) usage.user_ticks, (unsigned long long) usage.kernel_ticks,
+            (unsigned long long) usage.voluntary_switches, (unsigned long long) usage.involuntary_switches,
+            (unsigned long long) usage.page_faults, (unsigned long long) usage.syscalls,
+            (unsigned long long) (usage.bytes_read / 1024), (unsigned long long) (usage.bytes_written / 1024),
+            lines[i].name);
+  }
+}
+
 void Scheduler::sleepAndRelease(Lock &lock)
 {
   assert(lock.waitersListIsLocked());
@@ -2,6 +2,7 @@
 #include "kprintf.h"
 #include "ArchThreads.h"
 #include "ArchInterrupts.h"
+#include "ArchCommon.h"
 #include "panic.h"
 #include "Scheduler.h"
 #include "Thread.h"
@@ -41,6 +42,7 @@ bool SpinLock::acquireNonBlocking(pointer called_by)
   }
   // The spinlock is now held by the current thread.
   assert(held_by_ == 0);
+  acquired(0);
   last_accessed_at_ = called_by;
   held_by_ = currentThread;
   pushFrontToCurrentThreadHoldingList();
@@ -60,10 +62,12 @@ void SpinLock::acquire(pointer called_by)
 //    debug(LOCK, "The acquire is called by: ");
 //    kernel_debug_info->printCallInformation(called_by);
 //  }
+  uint64 waiting_since = 0;
   if(ArchThreads::testSetLock(lock_, 1))
   {
     // We did not directly managed to acquire the spinlock, need to check for deadlocks and
     // to push the current thread to the waiters list.
+    waiting_since = ArchCommon::getTimestamp();
     doChecksBeforeWaiting();
 
     currentThread->lock_waiting_on_ = this;
@@ -84,6 +88,7 @@ void SpinLock::acquire(pointer called_by)
     currentThread->lock_waiting_on_ = 0;
   }
   // The current thread is now holding the spinlock
+  acquired(waiting_since);
   last_accessed_at_ = called_by;
   held_by_ = currentThread;
   pushFrontToCurrentThreadHoldingList();
@@ -113,6 +118,7 @@ void SpinLock::release(pointer called_by)
 //    kernel_debug_info->printCallInformation(called_by);
 //  }
   checkInvalidRelease("SpinLock::release");
+  releasing();
   removeFromCurrentThreadHoldingList();
   last_accessed_at_ = called_by;
   held_by_ = 0;
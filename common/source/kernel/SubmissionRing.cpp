@@ -0,0 +1,172 @@
+#include "SubmissionRing.h"
+#include "SubmissionRingThread.h"
+#include "Scheduler.h"
+#include "Syscall.h"
+#include "Loader.h"
+#include "FileSystemInfo.h"
+#include "PageManager.h"
+#include "ArchMemory.h"
+#include "kprintf.h"
+#include "kstring.h"
+
+SubmissionRing::SubmissionRing(Loader* loader, FileSystemInfo* working_dir, Terminal* terminal) :
+    lock_("SubmissionRing::lock_"), work_available_(&lock_, "SubmissionRing::work_available_"),
+    work_done_(&lock_, "SubmissionRing::work_done_"), stop_(false), busy_(false), worker_active_(true),
+    process_attached_(true), worker_attached_(true), loader_(0), working_dir_(0)
+{
+  for (uint32 page = 0; page < RING_PAGES; ++page)
+  {
+    ppns_[page] = PageManager::instance()->allocPPN();
+    // the pages are freed by the ArchMemory of the process
+    loader->arch_memory_.mapPage(USER_PAGE + page, ppns_[page], 1);
+  }
+  header()->sq_entries = RING_SQ_ENTRIES;
+  header()->cq_entries = RING_CQ_ENTRIES;
+  debug(RING, "ctor: ring mapped at %zx\n", getUserAddress());
+  Scheduler::instance()->addNewThread(new SubmissionRingThread(this, loader, working_dir, terminal));
+}
+
+SubmissionRing::~SubmissionRing()
+{
+  delete loader_;
+  delete working_dir_;
+}
+
+bool SubmissionRing::detachProcess(Loader* loader, FileSystemInfo* working_dir)
+{
+  assert(Scheduler::instance()->isCurrentlyCleaningUp());
+  process_attached_ = false;
+  if (!worker_attached_)
+  {
+    delete this;
+    return false;
+  }
+  // a worker blocked in a request stops after it, until then it keeps using the address space
+  loader_ = loader;
+  working_dir_ = working_dir;
+  lock_.acquire();
+  stop_ = true;
+  work_available_.signal();
+  lock_.release();
+  debug(RING, "detachProcess: worker takes over the address space\n");
+  return true;
+}
+
+void SubmissionRing::detachWorker()
+{
+  assert(Scheduler::instance()->isCurrentlyCleaningUp());
+  worker_attached_ = false;
+  worker_active_ = false;
+  if (!process_attached_)
+    delete this;
+}
+
+pointer SubmissionRing::getUserAddress()
+{
+  return USER_PAGE * PAGE_SIZE;
+}
+
+RingHeader* SubmissionRing::header()
+{
+  return (RingHeader*) ArchMemory::getIdentAddressOfPPN(ppns_[0]);
+}
+
+RingSubmission* SubmissionRing::submission(uint32 index)
+{
+  size_t offset = RING_SQ_OFFSET + (index % RING_SQ_ENTRIES) * sizeof(RingSubmission);
+  return (RingSubmission*) (ArchMemory::getIdentAddressOfPPN(ppns_[offset / PAGE_SIZE]) + offset % PAGE_SIZE);
+}
+
+RingCompletion* SubmissionRing::completion(uint32 index)
+{
+  size_t offset = RING_CQ_OFFSET + (index % RING_CQ_ENTRIES) * sizeof(RingCompletion);
+  return (RingCompletion*) (ArchMemory::getIdentAddressOfPPN(ppns_[offset / PAGE_SIZE]) + offset % PAGE_SIZE);
+}
+
+size_t SubmissionRing::enter(size_t to_submit, size_t min_complete)
+{
+  RingHeader* ring = header();
+  MutexLock mlock(lock_);
+  uint32 published = ring->sq_tail - ring->sq_head;
+  if (published > RING_SQ_ENTRIES || !worker_active_)
+    return -1U;
+
+  work_available_.signal();
+  if (min_complete > RING_CQ_ENTRIES)
+    min_complete = RING_CQ_ENTRIES;
+  // only wait as long as there is something left that could complete
+  while (worker_active_ && (uint32) (ring->cq_tail - ring->cq_head) < min_complete &&
+         (busy_ || ring->sq_head != ring->sq_tail))
+    work_done_.wait();
+
+  return to_submit < published ? to_submit : published;
+}
+
+void SubmissionRing::run()
+{
+  RingHeader* ring = header();
+  lock_.acquire();
+  while (!stop_)
+  {
+    uint32 head = ring->sq_head;
+    if (head == ring->sq_tail || (uint32) (ring->cq_tail - ring->cq_head) >= RING_CQ_ENTRIES)
+    {
+      work_done_.broadcast();
+      work_available_.wait();
+      continue;
+    }
+    asm volatile ("" : : : "memory"); // read the entry only after the tail
+    // copy the entry, the process may reuse the slot as soon as sq_head moved on
+    RingSubmission request = *submission(head);
+    ring->sq_head = head + 1;
+    busy_ = true;
+    lock_.release();
+
+    int32 result = execute(request);
+
+    lock_.acquire();
+    busy_ = false;
+    RingCompletion* done = completion(ring->cq_tail);
+    done->user_data = request.user_data;
+    done->res = result;
+    done->flags = 0;
+    asm volatile ("" : : : "memory"); // publish the entry before the tail
+    ring->cq_tail = ring->cq_tail + 1;
+    work_done_.broadcast();
+  }
+  worker_active_ = false;
+  work_done_.broadcast();
+  lock_.release();
+}
+
+void SubmissionRing::workerDied()
+{
+  worker_active_ = false;
+}
+
+int32 SubmissionRing::execute(const RingSubmission& request)
+{
+  debug(RING, "execute: opcode %d, fd %d, addr %x, len %d, offset %d\n", request.opcode, request.fd, request.addr,
+        request.len, request.offset);
+  switch (request.opcode)
+  {
+    case RING_OP_NOP:
+      return 0;
+    case RING_OP_READ:
+      if (request.flags & RING_F_OFFSET)
+        return Syscall::pread(request.fd, request.addr, request.len, request.offset);
+      return Syscall::read(request.fd, request.addr, request.len);
+    case RING_OP_WRITE:
+      if (request.flags & RING_F_OFFSET)
+        return Syscall::pwrite(request.fd, request.addr, request.len, request.offset);
+      return Syscall::write(request.fd, request.addr, request.len);
+    case RING_OP_OPEN:
+      return Syscall::open(request.addr, request.len);
+    case RING_OP_CLOSE:
+      return Syscall::close(request.fd);
+    case RING_OP_LSEEK:
+      return Syscall::lseek(request.fd, (ssize_t) (int32) request.offset, request.len);
+    default:
+      return -1;
+  }
+}
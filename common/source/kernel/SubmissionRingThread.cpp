@@ -0,0 +1,34 @@
+#include "SubmissionRingThread.h"
+#include "SubmissionRing.h"
+#include "Loader.h"
+#include "ArchThreads.h"
+
+SubmissionRingThread::SubmissionRingThread(SubmissionRing* ring, Loader* loader, FileSystemInfo* working_dir,
+                                           Terminal* terminal) :
+    Thread(working_dir, "SubmissionRingThread", Thread::KERNEL_THREAD), ring_(ring), terminal_(terminal)
+{
+  // borrowed from the owning process, so user buffers are accessible and page faults get resolved
+  loader_ = loader;
+  ArchThreads::setAddressSpace(this, loader_->arch_memory_);
+}
+
+SubmissionRingThread::~SubmissionRingThread()
+{
+  // loader_ and working_dir_ belong to the owning process, or to the ring once the process is gone
+  loader_ = 0;
+  working_dir_ = 0;
+  ring_->detachWorker();
+}
+
+void SubmissionRingThread::kill()
+{
+  // killed while working (e.g. by a bad user buffer), the ring must not wait for us
+  ring_->workerDied();
+  Thread::kill();
+}
+
+void SubmissionRingThread::Run()
+{
+  setTerminal(terminal_);
+  ring_->run();
+}
@@ -0,0 +1,18 @@
+#include "SyncThread.h"
+#include "Scheduler.h"
+#include "VfsSyscall.h"
+#include "kprintf.h"
+
+SyncThread::SyncThread() : Thread(0, "SyncThread", Thread::KERNEL_THREAD)
+{
+}
+
+void SyncThread::Run()
+{
+  while (1)
+  {
+    Scheduler::instance()->sleepTicks(SYNC_INTERVAL_TICKS);
+    debug(VFSSYSCALL, "SyncThread: syncing the file systems\n");
+    VfsSyscall::sync();
+  }
+}
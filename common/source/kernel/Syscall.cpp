@@ -11,11 +11,46 @@
 #include "UserProcess.h"
 #include "ProcessRegistry.h"
 #include "File.h"
+#include "SubmissionRing.h"
+#include "Profiler.h"
+#include "Scheduler.h"
+#include "rusage-definitions.h"
+#include "mman-definitions.h"
+#include "Loader.h"
+#include "Inode.h"
+#include "FileDescriptor.h"
+#include "kstring.h"
+
+/**
+ * adds the bytes transferred by a successful read to the counters of the current thread
+ * @return result
+ */
+static size_t accountRead(size_t result)
+{
+  if ((ssize_t) result > 0)
+    currentThread->usage_.bytes_read += result;
+  return result;
+}
+
+/**
+ * adds the bytes transferred by a successful write to the counters of the current thread
+ * @return result
+ */
+static size_t accountWritten(size_t result)
+{
+  if ((ssize_t) result > 0)
+    currentThread->usage_.bytes_written += result;
+  return result;
+}
 
 size_t Syscall::syscallException(size_t syscall_number, size_t arg1, size_t arg2, size_t arg3, size_t arg4, size_t arg5)
 {
   size_t return_value = 0;
 
+  ++currentThread->usage_.syscalls;
+  if (syscall_number < RUSAGE_SYSCALLS)
+    ++currentThread->syscall_counts_[syscall_number];
+
   if (syscall_number != sc_sched_yield || syscall_number == sc_outline) // no debug print because these might occur very often
     debug(SYSCALL, "Syscall %zd called with arguments %zd(=%zx) %zd(=%zx) %zd(=%zx) %zd(=%zx) %zd(=%zx)\n",
           syscall_number, arg1, arg1, arg2, arg2, arg3, arg3, arg4, arg4, arg5, arg5);
@@ -37,18 +72,72 @@ size_t Syscall::syscallException(size_t syscall_number, size_t arg1, size_t arg2
     case sc_read:
       return_value = read(arg1, arg2, arg3);
       break;
+    case sc_pread:
+      return_value = pread(arg1, arg2, arg3, arg4);
+      break;
+    case sc_pwrite:
+      return_value = pwrite(arg1, arg2, arg3, arg4);
+      break;
+    case sc_readv:
+      return_value = readv(arg1, arg2, arg3);
+      break;
+    case sc_writev:
+      return_value = writev(arg1, arg2, arg3);
+      break;
+    case sc_lseek:
+      return_value = lseek(arg1, arg2, arg3);
+      break;
+    case sc_sendfile:
+      return_value = sendfile(arg1, arg2, arg3, arg4);
+      break;
+    case sc_copy_file_range:
+      return_value = copy_file_range(arg1, arg2, arg3, arg4, arg5);
+      break;
+    case sc_ring_setup:
+      return_value = ring_setup();
+      break;
+    case sc_mmap:
+      return_value = mmap(arg1);
+      break;
+    case sc_munmap:
+      return_value = munmap(arg1, arg2);
+      break;
+    case sc_msync:
+      return_value = msync(arg1, arg2, arg3);
+      break;
+    case sc_ring_enter:
+      return_value = ring_enter(arg1, arg2);
+      break;
     case sc_open:
       return_value = open(arg1, arg2);
       break;
     case sc_close:
       return_value = close(arg1);
       break;
+    case sc_fsync:
+      return_value = fsync(arg1);
+      break;
+    case sc_sync:
+      return_value = sync();
+      break;
+    case sc_ftruncate:
+      return_value = ftruncate(arg1, arg2);
+      break;
+    case sc_unlink:
+      return_value = unlink(arg1);
+      break;
     case sc_outline:
       outline(arg1, arg2);
       break;
     case sc_trace:
       trace();
       break;
+    case sc_profile:
+      return_value = profile(arg1, arg2);
+      break;
+    case sc_getrusage:
+      return_value = getrusage(arg1, arg2, arg3, arg4);
+      break;
     case sc_pseudols:
       VfsSyscall::readdir((const char*) arg1);
       break;
@@ -80,7 +169,7 @@ size_t Syscall::write(size_t fd, pointer buffer, size_t size)
   {
     VfsSyscall::write(fd, (char*) buffer, size);
   }
-  return size;
+  return accountWritten(size);
 }
 
 size_t Syscall::read(size_t fd, pointer buffer, size_t count)
@@ -100,7 +189,182 @@ size_t Syscall::read(size_t fd, pointer buffer, size_t count)
   {
     num_read = VfsSyscall::read(fd, (char*) buffer, count);
   }
-  return num_read;
+  return accountRead(num_read);
+}
+
+size_t Syscall::pread(size_t fd, pointer buffer, size_t count, size_t position)
+{
+  if ((buffer >= 2U * 1024U * 1024U * 1024U) || (buffer + count > 2U * 1024U * 1024U * 1024U))
+  {
+    return -1U;
+  }
+  return accountRead(VfsSyscall::pread(fd, (char*) buffer, count, position));
+}
+
+size_t Syscall::pwrite(size_t fd, pointer buffer, size_t size, size_t position)
+{
+  if ((buffer >= 2U * 1024U * 1024U * 1024U) || (buffer + size > 2U * 1024U * 1024U * 1024U))
+  {
+    return -1U;
+  }
+  return accountWritten(VfsSyscall::pwrite(fd, (const char*) buffer, size, position));
+}
+
+/**
+ * checks that the iovec array and every buffer it points to lie in userspace
+ */
+static bool checkIOVec(pointer iov, size_t iovcnt)
+{
+  if ((iovcnt > IOV_MAX) || (iov >= 2U * 1024U * 1024U * 1024U) ||
+      (iov + iovcnt * sizeof(struct iovec) > 2U * 1024U * 1024U * 1024U))
+  {
+    return false;
+  }
+  struct iovec* vec = (struct iovec*) iov;
+  for (size_t i = 0; i < iovcnt; ++i)
+  {
+    pointer buffer = (pointer) vec[i].iov_base;
+    if ((buffer >= 2U * 1024U * 1024U * 1024U) || (buffer + vec[i].iov_len > 2U * 1024U * 1024U * 1024U))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t Syscall::readv(size_t fd, pointer iov, size_t iovcnt)
+{
+  if (!checkIOVec(iov, iovcnt))
+  {
+    return -1U;
+  }
+  if (fd == fd_stdin)
+  {
+    struct iovec* vec = (struct iovec*) iov;
+    size_t num_read = 0;
+    for (size_t i = 0; i < iovcnt; ++i)
+    {
+      size_t count = read(fd, (pointer) vec[i].iov_base, vec[i].iov_len);
+      num_read += count;
+      if (count < vec[i].iov_len)
+        break;
+    }
+    return num_read;
+  }
+  return accountRead(VfsSyscall::readv(fd, (const struct iovec*) iov, iovcnt));
+}
+
+size_t Syscall::writev(size_t fd, pointer iov, size_t iovcnt)
+{
+  if (!checkIOVec(iov, iovcnt))
+  {
+    return -1U;
+  }
+  if (fd == fd_stdout)
+  {
+    struct iovec* vec = (struct iovec*) iov;
+    size_t written = 0;
+    for (size_t i = 0; i < iovcnt; ++i)
+      written += write(fd, (pointer) vec[i].iov_base, vec[i].iov_len);
+    return written;
+  }
+  return accountWritten(VfsSyscall::writev(fd, (const struct iovec*) iov, iovcnt));
+}
+
+size_t Syscall::lseek(size_t fd, size_t offset, size_t origin)
+{
+  return VfsSyscall::lseek(fd, offset, origin);
+}
+
+size_t Syscall::sendfile(size_t out_fd, size_t in_fd, pointer offset, size_t count)
+{
+  if (offset && ((offset >= 2U * 1024U * 1024U * 1024U) || (offset + sizeof(l_off_t) > 2U * 1024U * 1024U * 1024U)))
+  {
+    return -1U;
+  }
+  return accountWritten(accountRead(VfsSyscall::sendfile(out_fd, in_fd, (l_off_t*) offset, count)));
+}
+
+size_t Syscall::copy_file_range(size_t fd_in, pointer off_in, size_t fd_out, pointer off_out, size_t count)
+{
+  if ((off_in && ((off_in >= 2U * 1024U * 1024U * 1024U) || (off_in + sizeof(l_off_t) > 2U * 1024U * 1024U * 1024U))) ||
+      (off_out && ((off_out >= 2U * 1024U * 1024U * 1024U) || (off_out + sizeof(l_off_t) > 2U * 1024U * 1024U * 1024U))))
+  {
+    return -1U;
+  }
+  return accountWritten(accountRead(VfsSyscall::copyFileRange(fd_in, (l_off_t*) off_in, fd_out, (l_off_t*) off_out, count)));
+}
+
+size_t Syscall::ring_setup()
+{
+  return ((UserProcess*) currentThread)->getSubmissionRing()->getUserAddress();
+}
+
+size_t Syscall::ring_enter(size_t to_submit, size_t min_complete)
+{
+  return ((UserProcess*) currentThread)->getSubmissionRing()->enter(to_submit, min_complete);
+}
+
+size_t Syscall::mmap(pointer args)
+{
+  if ((args >= 2U * 1024U * 1024U * 1024U) || (args + sizeof(MmapArgs) > 2U * 1024U * 1024U * 1024U))
+  {
+    return (size_t) -1;
+  }
+  MmapArgs mmap_args;
+  memcpy(&mmap_args, (void*) args, sizeof(mmap_args));
+  if (mmap_args.length == 0 || mmap_args.offset % PAGE_SIZE)
+  {
+    debug(SYSCALL, "mmap: only mappings at page aligned offsets are supported\n");
+    return (size_t) -1;
+  }
+
+  File* mapped_file = 0;
+  if (!(mmap_args.flags & MAP_ANONYMOUS))
+  {
+    FileDescriptor* file_descriptor = VfsSyscall::getFileDescriptor(mmap_args.fd);
+    if (!file_descriptor)
+      return (size_t) -1;
+    File* file = file_descriptor->getFile();
+    // writes to a private mapping never reach the file
+    if (file->getFlag() == O_WRONLY ||
+        ((mmap_args.flags & MAP_SHARED) && (mmap_args.prot & PROT_WRITE) && file->getFlag() == O_RDONLY))
+    {
+      debug(SYSCALL, "mmap: the file is not opened for the access requested\n");
+      return (size_t) -1;
+    }
+    mapped_file = file->getInode()->link(file->getFlag());
+  }
+
+  pointer address = currentThread->loader_->mapFile(mmap_args.start, mmap_args.length, mmap_args.prot,
+                                                    mmap_args.flags, mapped_file, mmap_args.offset);
+  if (!address)
+  {
+    if (mapped_file)
+      mapped_file->getInode()->unlink(mapped_file);
+    return (size_t) -1;
+  }
+  return address;
+}
+
+size_t Syscall::munmap(pointer start, size_t length)
+{
+  if ((start >= 2U * 1024U * 1024U * 1024U) || (length > 2U * 1024U * 1024U * 1024U - start))
+  {
+    return -1U;
+  }
+  return currentThread->loader_->unmap(start, length);
+}
+
+size_t Syscall::msync(pointer start, size_t length, size_t flags)
+{
+  if ((start >= 2U * 1024U * 1024U * 1024U) || (length > 2U * 1024U * 1024U * 1024U - start) ||
+      (flags & ~(MS_ASYNC | MS_SYNC | MS_INVALIDATE)) || ((flags & MS_ASYNC) && (flags & MS_SYNC)))
+  {
+    return -1U;
+  }
+  // the pages are always written back right away, MS_ASYNC does not defer it
+  return currentThread->loader_->sync(start, length);
 }
 
 size_t Syscall::close(size_t fd)
@@ -108,6 +372,21 @@ size_t Syscall::close(size_t fd)
   return VfsSyscall::close(fd);
 }
 
+size_t Syscall::fsync(size_t fd)
+{
+  return VfsSyscall::flush(fd);
+}
+
+size_t Syscall::sync()
+{
+  return VfsSyscall::sync();
+}
+
+size_t Syscall::ftruncate(size_t fd, size_t length)
+{
+  return VfsSyscall::ftruncate(fd, length);
+}
+
 size_t Syscall::open(size_t path, size_t flags)
 {
   if (path >= 2U * 1024U * 1024U * 1024U)
@@ -117,6 +396,15 @@ size_t Syscall::open(size_t path, size_t flags)
   return VfsSyscall::open((char*) path, flags);
 }
 
+size_t Syscall::unlink(size_t path)
+{
+  if (path >= 2U * 1024U * 1024U * 1024U)
+  {
+    return -1U;
+  }
+  return VfsSyscall::rm((char*) path);
+}
+
 void Syscall::outline(size_t port, pointer text)
 {
   //WARNING: this might fail if Kernel PageFaults are not handled
@@ -166,3 +454,52 @@ void Syscall::trace()
   currentThread->printBacktrace();
 }
 
+size_t Syscall::profile(size_t command, size_t period)
+{
+  Profiler* profiler = Profiler::instance();
+  switch (command)
+  {
+    case PROFILE_STOP:
+      profiler->stop();
+      break;
+    case PROFILE_START:
+      profiler->start(period);
+      break;
+    case PROFILE_PRINT:
+      profiler->printProfile();
+      break;
+    case PROFILE_RESET:
+      profiler->reset();
+      break;
+    default:
+      return -1U;
+  }
+  return 0;
+}
+
+size_t Syscall::getrusage(size_t who, pointer usage, pointer syscall_counts, size_t num_counts)
+{
+  if ((who != RUSAGE_SELF && who != RUSAGE_THREAD) ||
+      (usage >= 2U * 1024U * 1024U * 1024U) || (usage + sizeof(ResourceUsage) > 2U * 1024U * 1024U * 1024U))
+  {
+    return -1U;
+  }
+  if (num_counts > RUSAGE_SYSCALLS)
+    num_counts = RUSAGE_SYSCALLS;
+  if (syscall_counts && ((syscall_counts >= 2U * 1024U * 1024U * 1024U) ||
+                         (syscall_counts + num_counts * sizeof(uint32) > 2U * 1024U * 1024U * 1024U)))
+  {
+    return -1U;
+  }
+
+  ResourceUsage sum;
+  uint32* counts = syscall_counts ? new uint32[RUSAGE_SYSCALLS] : 0;
+  Scheduler::instance()->getUsage(currentThread, who == RUSAGE_SELF, sum, counts);
+  memcpy((void*) usage, &sum, sizeof(sum));
+  if (counts)
+  {
+    memcpy((void*) syscall_counts, counts, num_counts * sizeof(uint32));
+    delete[] counts;
+  }
+  return 0;
+}
@@ -10,6 +10,7 @@
 #include "backtrace.h"
 #include "KernelMemoryManager.h"
 #include "Stabs2DebugInfo.h"
+#include "kstring.h"
 
 #define MAX_STACK_FRAMES 20
 
@@ -32,8 +33,10 @@ extern "C" void threadStartHack()
 Thread::Thread(FileSystemInfo *working_dir, ustl::string name, Thread::TYPE type) :
     kernel_registers_(0), user_registers_(0), switch_to_userspace_(type == Thread::USER_THREAD ? 1 : 0), loader_(0), state_(Running),
     next_thread_in_lock_waiters_list_(0), lock_waiting_on_(0), holding_lock_list_(0), tid_(0),
-    my_terminal_(0), working_dir_(working_dir), name_(name)
+    my_terminal_(0), yielding_(false), ticks_seen_(0), wakeup_tick_(0), working_dir_(working_dir), name_(name)
 {
+  memset(&usage_, 0, sizeof(usage_));
+  memset(syscall_counts_, 0, sizeof(syscall_counts_));
   debug(THREAD, "Thread ctor, this is %p, stack is %p, fs_info ptr: %p\n", this, kernel_stack_, working_dir_);
   ArchThreads::createKernelRegisters(kernel_registers_, (void*) (type == Thread::USER_THREAD ? 0 : threadStartHack), getStackStartPointer());
   kernel_stack_[2047] = STACK_CANARY;
@@ -43,10 +46,8 @@ Thread::Thread(FileSystemInfo *working_dir, ustl::string name, Thread::TYPE type
 Thread::~Thread()
 {
   debug(THREAD, "~Thread: freeing ThreadInfos\n");
-  delete user_registers_;
-  user_registers_ = 0;
-  delete kernel_registers_;
-  kernel_registers_ = 0;
+  ArchThreads::deleteThreadRegisters(user_registers_);
+  ArchThreads::deleteThreadRegisters(kernel_registers_);
   if(unlikely(holding_lock_list_ != 0))
   {
     debug(THREAD, "~Thread: ERROR: Thread <%s (%p)> is going to be destroyed, but still holds some locks!\n",
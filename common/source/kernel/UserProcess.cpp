@@ -8,10 +8,12 @@
 #include "ArchMemory.h"
 #include "PageManager.h"
 #include "ArchThreads.h"
+#include "SubmissionRing.h"
 
 UserProcess::UserProcess(ustl::string filename, FileSystemInfo *fs_info, ProcessRegistry *process_registry,
                          uint32 terminal_number) :
-    Thread(fs_info, filename, Thread::USER_THREAD), fd_(VfsSyscall::open(filename, O_RDONLY)), process_registry_(process_registry)
+    Thread(fs_info, filename, Thread::USER_THREAD), fd_(VfsSyscall::open(filename, O_RDONLY)), process_registry_(process_registry),
+    submission_ring_(0)
 {
   process_registry_->processStart(); //should also be called if you fork a process
 
@@ -46,6 +48,14 @@ UserProcess::UserProcess(ustl::string filename, FileSystemInfo *fs_info, Process
 UserProcess::~UserProcess()
 {
   assert(Scheduler::instance()->isCurrentlyCleaningUp());
+  // the ring worker runs in our address space, it keeps it until it has stopped
+  if (submission_ring_ && submission_ring_->detachProcess(loader_, working_dir_))
+  {
+    loader_ = 0;
+    working_dir_ = 0;
+  }
+  submission_ring_ = 0;
+
   delete loader_;
   loader_ = 0;
 
@@ -58,6 +68,13 @@ UserProcess::~UserProcess()
   process_registry_->processExit();
 }
 
+SubmissionRing* UserProcess::getSubmissionRing()
+{
+  if (!submission_ring_)
+    submission_ring_ = new SubmissionRing(loader_, working_dir_, getTerminal());
+  return submission_ring_;
+}
+
 void UserProcess::Run()
 {
   debug(USERPROCESS, "Run: Fail-safe kernel panic - you probably have forgotten to set switch_to_userspace_ = 1\n");
@@ -29,6 +29,9 @@
 #include "Terminal.h"
 #include "outerrstream.h"
 #include "user_progs.h"
+#include "kernel_benchmarks.h"
+#include "KernelBenchmark.h"
+#include "SyncThread.h"
 
 extern void* kernel_end_address;
 extern Console* main_console;
@@ -115,7 +118,12 @@ extern "C" void startup()
 
   debug(MAIN, "Adding Kernel threads\n");
   Scheduler::instance()->addNewThread(main_console);
-  Scheduler::instance()->addNewThread(new ProcessRegistry(new FileSystemInfo(*default_working_dir), user_progs /*see user_progs.h*/));
+  Scheduler::instance()->addNewThread(new SyncThread());
+  if (kernel_benchmarks[0]) // see kernel_benchmarks.h, starts the ProcessRegistry when done
+    Scheduler::instance()->addNewThread(new KernelBenchmark(new FileSystemInfo(*default_working_dir), kernel_benchmarks,
+                                                            user_progs));
+  else
+    Scheduler::instance()->addNewThread(new ProcessRegistry(new FileSystemInfo(*default_working_dir), user_progs /*see user_progs.h*/));
   Scheduler::instance()->printThreadList();
 
   kprintf("Now enabling Interrupts...\n");
@@ -29,6 +29,7 @@ PageManager::PageManager() : lock_("PageManager::lock_")
   assert(KernelMemoryManager::instance_ == 0);
   number_of_pages_ = 0;
   lowest_unreserved_page_ = 0;
+  page_refs_ = 0;
 
   size_t num_mmaps = ArchCommon::getNumUseableMemoryRegions();
 
@@ -125,21 +126,10 @@ PageManager::PageManager() : lock_("PageManager::lock_")
   new (&kmm) KernelMemoryManager(num_reserved_heap_pages,HEAP_PAGES);
   page_usage_table_ = new Bitmap(number_of_pages_);
 
-  for (size_t i = 0; i < boot_bitmap_size; ++i)
-  {
-    if (Bitmap::getBit(page_usage_table,i))
-      page_usage_table_->setBit(i);
-  }
+  page_usage_table_->setBytes(page_usage_table, boot_bitmap_size);
 
   debug(PM, "Ctor: find lowest unreserved page\n");
-  for (size_t p = 0; p < number_of_pages_; ++p)
-  {
-    if (!page_usage_table_->getBit(p))
-    {
-      lowest_unreserved_page_ = p;
-      break;
-    }
-  }
+  lowest_unreserved_page_ = page_usage_table_->findFirstZero();
   debug(PM, "Ctor: Physical pages - free: %zu used: %zu total: %u\n", page_usage_table_->getNumFreeBits(),
         page_usage_table_->getNumBitsSet(), number_of_pages_);
   assert(lowest_unreserved_page_ < number_of_pages_);
@@ -151,37 +141,22 @@ uint32 PageManager::getTotalNumPages() const
   return number_of_pages_;
 }
 
-bool PageManager::reservePages(uint32 ppn, uint32 num)
-{
-  assert(lock_.heldBy() == currentThread);
-  if (ppn < number_of_pages_ && !page_usage_table_->getBit(ppn))
-  {
-    if (num == 1 || reservePages(ppn + 1, num - 1))
-    {
-      page_usage_table_->setBit(ppn);
-      return true;
-    }
-  }
-  return false;
-}
-
 uint32 PageManager::allocPPN(uint32 page_size)
 {
   assert((page_size % PAGE_SIZE) == 0);
   while (1)
   {
     lock_.acquire();
-    uint32 p;
+    uint32 num_pages = page_size / PAGE_SIZE;
     uint32 found = 0;
-    for (p = lowest_unreserved_page_; !found && p < number_of_pages_; ++p)
+    size_t p = page_usage_table_->findZeroRun(num_pages, num_pages, lowest_unreserved_page_);
+    if (p != (size_t) -1)
     {
-      if ((p % (page_size / PAGE_SIZE)) != 0)
-        continue;
-      if (reservePages(p, page_size / PAGE_SIZE))
-        found = p;
+      page_usage_table_->setRange(p, num_pages);
+      found = p;
     }
-    while (lowest_unreserved_page_ < number_of_pages_ && page_usage_table_->getBit(lowest_unreserved_page_))
-      ++lowest_unreserved_page_;
+    p = page_usage_table_->findFirstZero(lowest_unreserved_page_);
+    lowest_unreserved_page_ = (p == (size_t) -1) ? number_of_pages_ : p;
     lock_.release();
 
     if (found == 0)
@@ -203,8 +178,36 @@ void PageManager::freePPN(uint32 page_number, uint32 page_size)
   for (uint32 p = page_number; p < (page_number + page_size / PAGE_SIZE); ++p)
   {
     assert(page_usage_table_->getBit(p) && "Double free PPN")
+    if (page_refs_ && page_refs_[p])
+    {
+      --page_refs_[p]; // still in use somewhere else
+      continue;
+    }
     page_usage_table_->unsetBit(p);
   }
   lock_.release();
 }
 
+void PageManager::refPPN(uint32 page_number)
+{
+  if (unlikely(!page_refs_))
+  {
+    // allocated outside of the spinlock, the loser of a race frees its table again
+    uint16* page_refs = new uint16[number_of_pages_];
+    memset(page_refs, 0, number_of_pages_ * sizeof(uint16));
+    lock_.acquire();
+    if (!page_refs_)
+    {
+      page_refs_ = page_refs;
+      page_refs = 0;
+    }
+    lock_.release();
+    delete[] page_refs;
+  }
+  lock_.acquire();
+  assert(page_usage_table_->getBit(page_number) && "Reference to a free PPN");
+  assert(page_refs_[page_number] < 0xFFFF);
+  ++page_refs_[page_number];
+  lock_.release();
+}
+
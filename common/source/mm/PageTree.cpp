@@ -0,0 +1,137 @@
+#include "PageTree.h"
+#include "PageManager.h"
+#include "ArchMemory.h"
+#include "assert.h"
+
+PageTree::PageTree() :
+    root_(0), height_(0), num_pages_(0), num_nodes_(0)
+{
+}
+
+PageTree::~PageTree()
+{
+  freePages(0);
+  assert(num_pages_ == 0 && num_nodes_ == 0);
+}
+
+size_t PageTree::capacity(uint32 height)
+{
+  size_t num_indices = 1;
+  for (uint32 level = 0; level < height; ++level)
+    num_indices *= PAGE_TREE_FANOUT;
+  return num_indices;
+}
+
+size_t PageTree::getPage(size_t index, bool create)
+{
+  if (!root_)
+  {
+    if (!create)
+      return 0;
+    root_ = PageManager::instance()->allocPPN();
+    height_ = 1;
+    ++num_nodes_;
+  }
+  while (index >= capacity(height_))
+  {
+    if (!create)
+      return 0;
+    // the old tree becomes the first subtree of a new root
+    size_t new_root = PageManager::instance()->allocPPN();
+    ((size_t*) ArchMemory::getIdentAddressOfPPN(new_root))[0] = root_;
+    root_ = new_root;
+    ++height_;
+    ++num_nodes_;
+  }
+
+  size_t page = root_;
+  for (uint32 height = height_; height > 0; --height)
+  {
+    size_t* entries = (size_t*) ArchMemory::getIdentAddressOfPPN(page);
+    size_t& entry = entries[(index / capacity(height - 1)) % PAGE_TREE_FANOUT];
+    if (!entry)
+    {
+      if (!create)
+        return 0;
+      entry = PageManager::instance()->allocPPN();
+      if (height == 1)
+        ++num_pages_;
+      else
+        ++num_nodes_;
+    }
+    page = entry;
+  }
+  return page;
+}
+
+size_t PageTree::getNumMissingPages(size_t index) const
+{
+  size_t missing = 0;
+  uint32 height = height_;
+  if (!root_)
+  {
+    ++missing;
+    height = 1;
+  }
+  while (index >= capacity(height))
+  {
+    ++missing;
+    ++height;
+  }
+  // a new root has the index behind its first entry, the whole path below it is new
+  if (missing)
+    return missing + height;
+
+  size_t page = root_;
+  for (; height > 0; --height)
+  {
+    page = ((size_t*) ArchMemory::getIdentAddressOfPPN(page))[(index / capacity(height - 1)) % PAGE_TREE_FANOUT];
+    if (!page)
+      return height;
+  }
+  return 0;
+}
+
+void PageTree::freePages(size_t first)
+{
+  if (root_ && freeRange(root_, height_, 0, first))
+  {
+    PageManager::instance()->freePPN(root_);
+    root_ = 0;
+    height_ = 0;
+    --num_nodes_;
+  }
+}
+
+bool PageTree::freeRange(size_t node, uint32 height, size_t start, size_t first)
+{
+  size_t* entries = (size_t*) ArchMemory::getIdentAddressOfPPN(node);
+  size_t span = capacity(height - 1);
+  bool empty = true;
+  for (size_t i = 0; i < PAGE_TREE_FANOUT; ++i)
+  {
+    if (!entries[i])
+      continue;
+    size_t child_start = start + i * span;
+    if (child_start + span <= first)
+    {
+      empty = false;
+      continue;
+    }
+    if (height == 1)
+    {
+      PageManager::instance()->freePPN(entries[i]);
+      entries[i] = 0;
+      --num_pages_;
+    }
+    else if (freeRange(entries[i], height - 1, child_start, first))
+    {
+      PageManager::instance()->freePPN(entries[i]);
+      entries[i] = 0;
+      --num_nodes_;
+    }
+    else
+      empty = false;
+  }
+  return empty;
+}
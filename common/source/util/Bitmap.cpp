@@ -4,24 +4,78 @@
 
 uint8 const Bitmap::bits_per_bitmap_atom_ = 8;
 
-static const uint8 BIT_COUNT[] =
+#define WORD_BITS (sizeof(size_t) * 8)
+#define ALL_ONES ((size_t) -1)
+#define ONES ((size_t) -1 / 0xFF) // 0x01 in every byte
+
+// exe2minixfs runs on the host and counts in software
+#if (__i386__ || __x86_64__) && !defined(EXE2MINIXFS)
+#define USE_POPCNT
+#include "cpuid.h"
+
+#define CPUID_1_ECX_POPCNT (1 << 23)
+
+static uint8 popcnt_available = 0; // 0 not detected yet, 1 no, 2 yes
+
+static bool hasPopcnt()
 {
-0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 1, 2, 2, 3, 2, 3, 3, 4,
-2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
-2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6,
-4, 5, 5, 6, 5, 6, 6, 7, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
-2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 2, 3, 3, 4, 3, 4, 4, 5,
-3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
-4, 5, 5, 6, 5, 6, 6, 7, 5, 6, 6, 7, 6, 7, 7, 8
-};
+  if (!popcnt_available)
+  {
+    uint32 eax, ebx, ecx, edx;
+    cpuid(1, 0, eax, ebx, ecx, edx);
+    popcnt_available = (ecx & CPUID_1_ECX_POPCNT) ? 2 : 1;
+  }
+  return popcnt_available == 2;
+}
+#endif
+
+/**
+ * @return the number of set bits in word
+ */
+static inline size_t countBits(size_t word)
+{
+#ifdef USE_POPCNT
+  if (hasPopcnt())
+  {
+    size_t count;
+    asm("popcnt %1, %0" : "=r"(count) : "rm"(word));
+    return count;
+  }
+#endif
+  word = word - ((word >> 1) & (ONES * 0x55));
+  word = (word & (ONES * 0x33)) + ((word >> 2) & (ONES * 0x33));
+  word = (word + (word >> 4)) & (ONES * 0x0F);
+  return (word * ONES) >> (WORD_BITS - 8);
+}
+
+/**
+ * @pre word != 0
+ * @return the number of the lowest set bit in word
+ */
+static inline size_t lowestSetBit(size_t word)
+{
+#if __i386__ || __x86_64__
+  size_t bit;
+  asm("bsf %1, %0" : "=r"(bit) : "rm"(word));
+  return bit;
+#else
+  return __builtin_ctzl(word);
+#endif
+}
+
+static inline size_t roundUp(size_t value, size_t align)
+{
+  return (value + align - 1) / align * align;
+}
 
 Bitmap::Bitmap(size_t number_of_bits)
 {
   size_ = number_of_bits;
   num_bits_set_ = 0;
-  bitmap_ = new uint8[BITMAP_BYTE_COUNT(number_of_bits)];
-  for (size_t byte = 0; byte < BITMAP_BYTE_COUNT(number_of_bits); ++byte)
-    bitmap_[byte] = static_cast<uint8>(0);
+  num_words_ = (number_of_bits + WORD_BITS - 1) / WORD_BITS;
+  bitmap_ = new size_t[num_words_];
+  for (size_t word = 0; word < num_words_; ++word)
+    bitmap_[word] = 0;
 }
 
 Bitmap::~Bitmap()
@@ -32,10 +86,19 @@ Bitmap::~Bitmap()
 #define BYTE (b[bit_number / bits_per_bitmap_atom_])
 #define MASK (1 << (bit_number % bits_per_bitmap_atom_))
 
+#define WORD (bitmap_[bit_number / WORD_BITS])
+#define WORD_MASK ((size_t) 1 << (bit_number % WORD_BITS))
+
 bool Bitmap::setBit(size_t bit_number)
 {
   assert(bit_number < size_);
-  return setBit(bitmap_, num_bits_set_, bit_number);
+  if (!(WORD & WORD_MASK))
+  {
+    WORD |= WORD_MASK;
+    ++num_bits_set_;
+    return true;
+  }
+  return false;
 }
 
 bool Bitmap::setBit(uint8* b, size_t& num_bits_set, size_t bit_number)
@@ -53,7 +116,7 @@ bool Bitmap::setBit(uint8* b, size_t& num_bits_set, size_t bit_number)
 bool Bitmap::getBit(size_t bit_number)
 {
   assert(bit_number < size_);
-  return getBit(bitmap_, bit_number);
+  return WORD & WORD_MASK;
 }
 
 bool Bitmap::getBit(uint8* b, size_t bit_number)
@@ -64,7 +127,13 @@ bool Bitmap::getBit(uint8* b, size_t bit_number)
 bool Bitmap::unsetBit(size_t bit_number)
 {
   assert(bit_number < size_);
-  return unsetBit(bitmap_, num_bits_set_, bit_number);
+  if (WORD & WORD_MASK)
+  {
+    WORD &= ~WORD_MASK;
+    --num_bits_set_;
+    return true;
+  }
+  return false;
 }
 
 bool Bitmap::unsetBit(uint8* b, size_t& num_bits_set, size_t bit_number)
@@ -78,25 +147,144 @@ bool Bitmap::unsetBit(uint8* b, size_t& num_bits_set, size_t bit_number)
   return false;
 }
 
+void Bitmap::setWordBits(size_t word_number, size_t mask, bool value)
+{
+  size_t& word = bitmap_[word_number];
+  size_t changed = (value ? ~word : word) & mask;
+  if (value)
+    num_bits_set_ += countBits(changed);
+  else
+    num_bits_set_ -= countBits(changed);
+  word ^= changed;
+}
+
+void Bitmap::changeRange(size_t first_bit, size_t num_bits, bool value)
+{
+  assert(first_bit + num_bits <= size_ && first_bit + num_bits >= first_bit);
+  size_t end = first_bit + num_bits;
+  for (size_t bit = first_bit; bit < end;)
+  {
+    size_t offset = bit % WORD_BITS;
+    size_t count = WORD_BITS - offset < end - bit ? WORD_BITS - offset : end - bit;
+    size_t mask = count == WORD_BITS ? ALL_ONES : (((size_t) 1 << count) - 1) << offset;
+    setWordBits(bit / WORD_BITS, mask, value);
+    bit += count;
+  }
+}
+
+void Bitmap::setRange(size_t first_bit, size_t num_bits)
+{
+  changeRange(first_bit, num_bits, true);
+}
+
+void Bitmap::clearRange(size_t first_bit, size_t num_bits)
+{
+  changeRange(first_bit, num_bits, false);
+}
+
+size_t Bitmap::findFirstZero(size_t from)
+{
+  if (from >= size_)
+    return -1;
+  size_t word_number = from / WORD_BITS;
+  // the bits after the last one of the bitmap are always unset and have to be checked against size_
+  size_t word = ~bitmap_[word_number] & (ALL_ONES << (from % WORD_BITS));
+  while (!word)
+  {
+    if (++word_number >= num_words_)
+      return -1;
+    word = ~bitmap_[word_number];
+  }
+  size_t bit = word_number * WORD_BITS + lowestSetBit(word);
+  return bit < size_ ? bit : -1;
+}
+
+size_t Bitmap::findFirstOne(size_t from, size_t to)
+{
+  if (from >= to)
+    return to;
+  size_t word_number = from / WORD_BITS;
+  size_t word = bitmap_[word_number] & (ALL_ONES << (from % WORD_BITS));
+  while (!word)
+  {
+    if (++word_number * WORD_BITS >= to)
+      return to;
+    word = bitmap_[word_number];
+  }
+  size_t bit = word_number * WORD_BITS + lowestSetBit(word);
+  return bit < to ? bit : to;
+}
+
+size_t Bitmap::findZeroRun(size_t num_bits, size_t align, size_t from)
+{
+  assert(num_bits > 0 && align > 0);
+  size_t start = from;
+  while (1)
+  {
+    start = findFirstZero(start);
+    if (start == (size_t) -1)
+      return -1;
+    start = roundUp(start, align);
+    if (start >= size_ || num_bits > size_ - start)
+      return -1;
+    size_t used = findFirstOne(start, start + num_bits);
+    if (used == start + num_bits)
+      return start;
+    start = used + 1;
+  }
+}
+
 void Bitmap::setByte(size_t byte_number, uint8 byte)
 {
   assert(byte_number * bits_per_bitmap_atom_ < size_);
-  uint8& b = bitmap_[byte_number];
+  size_t shift = (byte_number % sizeof(size_t)) * bits_per_bitmap_atom_;
+  size_t& word = bitmap_[byte_number / sizeof(size_t)];
 
-  num_bits_set_ -= BIT_COUNT[b];
-  num_bits_set_ += BIT_COUNT[byte];
-  b = byte;
+  num_bits_set_ -= countBits(word & ((size_t) 0xFF << shift));
+  num_bits_set_ += countBits(byte);
+  word = (word & ~((size_t) 0xFF << shift)) | ((size_t) byte << shift);
 }
 
 uint8 Bitmap::getByte(size_t byte_number)
 {
   assert(byte_number * bits_per_bitmap_atom_ < size_);
-  return bitmap_[byte_number];
+  return bitmap_[byte_number / sizeof(size_t)] >> ((byte_number % sizeof(size_t)) * bits_per_bitmap_atom_);
+}
+
+void Bitmap::setBytes(const uint8* bytes, size_t num_bits)
+{
+  assert(num_bits <= size_);
+  size_t word_number = 0;
+  for (; (word_number + 1) * WORD_BITS <= num_bits; ++word_number)
+  {
+    size_t word = 0;
+    for (size_t i = 0; i < sizeof(size_t); ++i)
+      word |= (size_t) bytes[word_number * sizeof(size_t) + i] << (i * bits_per_bitmap_atom_);
+    num_bits_set_ -= countBits(bitmap_[word_number]);
+    num_bits_set_ += countBits(word);
+    bitmap_[word_number] = word;
+  }
+  for (size_t bit_number = word_number * WORD_BITS; bit_number < num_bits; ++bit_number)
+  {
+    if (getBit((uint8*) bytes, bit_number))
+      setBit(bit_number);
+    else
+      unsetBit(bit_number);
+  }
+}
+
+void Bitmap::getBytes(uint8* bytes)
+{
+  for (size_t byte_number = 0; byte_number < BITMAP_BYTE_COUNT(size_); ++byte_number)
+    bytes[byte_number] = getByte(byte_number);
 }
 
 void Bitmap::bmprint()
 {
-  bmprint(bitmap_, size_, num_bits_set_);
+  uint8* bytes = new uint8[BITMAP_BYTE_COUNT(size_)];
+  getBytes(bytes);
+  bmprint(bytes, size_, num_bits_set_);
+  delete[] bytes;
 }
 
 void Bitmap::bmprint(uint8* b, size_t n, size_t num_bits_set)
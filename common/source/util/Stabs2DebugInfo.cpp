@@ -2,6 +2,7 @@
 #include "Stabs2DebugInfo.h"
 #include "ArchCommon.h"
 #include "ArchMemory.h"
+#include "umap.h"
 
 #define ADDRESS_BETWEEN(Value, LowerBound, UpperBound) \
   ((((void*)Value) >= ((void*)LowerBound)) && (((void*)Value) < ((void*)UpperBound)))
@@ -37,27 +38,95 @@ Stabs2DebugInfo::~Stabs2DebugInfo()
 
 void Stabs2DebugInfo::initialiseSymbolTable()
 {
-  function_symbols_.reserve(256);
+  ustl::map<size_t, StabEntry const*> functions;
+  functions.reserve(256);
 
   // debug output for userspace symols
   for (StabEntry const *current_stab = stab_start_; current_stab < stab_end_; ++current_stab)
   {
     if (ArchMemory::get_PPN_Of_VPN_In_KernelMapping((size_t)current_stab / PAGE_SIZE,0,0) && (current_stab->n_type == N_FUN || current_stab->n_type == N_FNAME))
     {
-      function_symbols_[current_stab->n_value] = current_stab;
+      functions[current_stab->n_value] = current_stab;
     }
   }
-  debug(MAIN, "found %zd functions\n", function_symbols_.size());
 
+  function_symbols_.reserve(functions.size());
+  for (auto symbol : functions)
+  {
+    FunctionSymbol function;
+    function.start = symbol.first;
+    function.stab = symbol.second;
+    function.lines_begin = line_symbols_.size();
+
+    StabEntry const *se;
+    for (se = symbol.second + 1; se < stab_end_ && se->n_type == N_PSYM; ++se)
+      ;
+    // lookups stop at the first entry beyond the offset, keeping the maximum
+    // makes the offsets ascending without changing the result
+    size_t max_offset = 0;
+    for (; se < stab_end_ && se->n_type == N_SLINE; ++se)
+    {
+      if (se->n_value > max_offset)
+        max_offset = se->n_value;
+      LineSymbol line = { max_offset, se->n_desc };
+      line_symbols_.push_back(line);
+    }
+
+    function.lines_end = line_symbols_.size();
+    function_symbols_.push_back(function);
+  }
+  debug(MAIN, "found %zd functions, %zd lines\n", function_symbols_.size(), line_symbols_.size());
+
+}
+
+Stabs2DebugInfo::FunctionSymbol const *Stabs2DebugInfo::findFunction(pointer address) const
+{
+  if (function_symbols_.size() == 0 ||
+      !(ADDRESS_BETWEEN(address, function_symbols_.begin()->start, ArchCommon::getKernelEndAddress())))
+    return 0;
+
+  // first function starting behind the address
+  size_t low = 0, high = function_symbols_.size();
+  while (low < high)
+  {
+    size_t middle = low + (high - low) / 2;
+    if (function_symbols_[middle].start <= address)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+
+  // low > 0 since the address is not below the first function, the last function ends at the kernel end
+  return &function_symbols_[low - 1];
+}
+
+bool Stabs2DebugInfo::findLine(FunctionSymbol const *function, size_t offset, ssize_t &line) const
+{
+  // first line entry behind the offset
+  size_t low = function->lines_begin, high = function->lines_end;
+  while (low < high)
+  {
+    size_t middle = low + (high - low) / 2;
+    if (line_symbols_[middle].offset <= offset)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+
+  if (low == function->lines_begin)
+    return false;
+
+  line = line_symbols_[low - 1].line;
+  return true;
 }
 
 void Stabs2DebugInfo::printAllFunctions() const
 {
   char buffer[512];
   debug(MAIN, "Known symbols:\n");
-  for (auto symbol : function_symbols_)
+  for (FunctionSymbol const &symbol : function_symbols_)
   {
-    demangleName(stabstr_buffer_ + symbol.second->n_strx, buffer, 512);
+    demangleName(stabstr_buffer_ + symbol.stab->n_strx, buffer, 512);
     debug(MAIN, "\t%s\n", buffer);
   }
 }
@@ -108,21 +177,9 @@ bool Stabs2DebugInfo::tryPasteOoperator(const char *& input, char *& buffer, siz
 ssize_t Stabs2DebugInfo::getFunctionLine(pointer start, pointer offset) const
 {
   ssize_t line = -1;
-  ustl::map<size_t, StabEntry const *>::const_iterator it = function_symbols_.find(start);
-  if (it != function_symbols_.end())
-  {
-    StabEntry const *se = it->second + 1;
-    while (se->n_type == N_PSYM)
-      ++se;
-    while (se->n_type == N_SLINE)
-    {
-      if (offset < se->n_value)
-        return line;
-      else
-        line = se->n_desc;
-      ++se;
-    }
-  }
+  FunctionSymbol const *function = findFunction(start);
+  if (function && function->start == start)
+    findLine(function, offset, line);
   return line;
 }
 
@@ -132,30 +189,17 @@ void Stabs2DebugInfo::getCallNameAndLine(pointer address, const char*& mangled_n
   mangled_name = 0;
   line = 0;
 
-  if (!this || function_symbols_.size() == 0 ||
-      !(ADDRESS_BETWEEN(address, function_symbols_.begin()->first, ArchCommon::getKernelEndAddress())))
+  if (!this)
     return;
 
-  ustl::map<size_t, StabEntry const *>::const_iterator it;
-  for(it = function_symbols_.begin(); it != function_symbols_.end() && it->first <= address; ++it);
-
-  if (it == function_symbols_.end())
+  FunctionSymbol const *function = findFunction(address);
+  if (!function)
     return;
 
-  --it;
-  mangled_name = stabstr_buffer_ + it->second->n_strx;
-  size_t offset = address - it->first;
-  line = -offset;
-
-  StabEntry const *se;
-  // run the iterator until it finds line informations
-  for(se = it->second + 1; se->n_type == N_PSYM; ++se)
-    ;
-
-  for(; se->n_type == N_SLINE && offset >= se->n_value; ++se)
-  {
-    line = se->n_desc;
-  }
+  mangled_name = stabstr_buffer_ + function->stab->n_strx;
+  size_t offset = address - function->start;
+  if (!findLine(function, offset, line))
+    line = -offset;
 }
 
 
@@ -182,22 +226,18 @@ void Stabs2DebugInfo::printCallInformation(pointer address) const
 
 pointer Stabs2DebugInfo::getFunctionName(pointer address, char function_name[], size_t size) const
 {
-  if (function_symbols_.size() == 0 || !(ADDRESS_BETWEEN(address, function_symbols_.begin()->first, ArchCommon::getKernelEndAddress())))
+  FunctionSymbol const *function = findFunction(address);
+  if (!function)
     return 0;
 
-  ustl::map<size_t, StabEntry const *>::const_iterator it;
-  for(it = function_symbols_.begin(); it != function_symbols_.end() && it->first <= address; ++it)
-  {
-  }
-
-  if (it != function_symbols_.end())
-  {
-    --it;
-    demangleName(stabstr_buffer_ + it->second->n_strx, function_name, size);
-    return it->first;
-  }
+  demangleName(stabstr_buffer_ + function->stab->n_strx, function_name, size);
+  return function->start;
+}
 
-  return 0;
+pointer Stabs2DebugInfo::getFunctionStart(pointer address) const
+{
+  FunctionSymbol const *function = findFunction(address);
+  return function ? function->start : 0;
 }
 
 int Stabs2DebugInfo::readNumber(const char *& input) const
@@ -2,11 +2,193 @@
 #include "kmalloc.h"
 #include "assert.h"
 #include "ArchMemory.h"
+#if __i386__ || __x86_64__
+#include "ArchFpu.h"
+#include "cpuid.h"
+#endif
+
+#define WORD_MASK (sizeof(size_t) - 1)
+#define ONES ((size_t) -1 / 0xFF) // 0x01 in every byte
+#define HIGHS (ONES * 0x80)       // 0x80 in every byte
+
+/**
+ * @return whether one of the bytes of word is zero
+ */
+static inline bool hasZeroByte(size_t word)
+{
+  return ((word - ONES) & ~word & HIGHS) != 0;
+}
+
+#if __i386__ || __x86_64__
+
+#define STRING_FEATURES_DETECTED 0x1
+#define STRING_FEATURE_ERMS      0x2 // enhanced rep movsb/stosb
+#define STRING_FEATURE_SSE2      0x4
+
+#define CPUID_1_EDX_SSE2 (1 << 26)
+#define CPUID_7_EBX_ERMS (1 << 9)
+
+#define SSE_COPY_MINIMUM 8192 // saving and restoring the FPU state has to pay off
+#define USER_SPACE_END (2U * 1024U * 1024U * 1024U)
+
+#if __x86_64__
+#define REP_MOVS_WORDS "rep movsq"
+#define REP_STOS_WORDS "rep stosq"
+#else
+#define REP_MOVS_WORDS "rep movsl"
+#define REP_STOS_WORDS "rep stosl"
+#endif
+
+static uint32 string_features = 0;
+
+/**
+ * the copy strategy is chosen on the first copy during boot
+ */
+static uint32 stringFeatures()
+{
+  if (unlikely(!string_features))
+  {
+    uint32 eax, ebx, ecx, edx;
+    uint32 features = STRING_FEATURES_DETECTED;
+    cpuid(0, 0, eax, ebx, ecx, edx);
+    uint32 max_leaf = eax;
+    cpuid(1, 0, eax, ebx, ecx, edx);
+    if (edx & CPUID_1_EDX_SSE2)
+      features |= STRING_FEATURE_SSE2;
+    if (max_leaf >= 7)
+    {
+      cpuid(7, 0, eax, ebx, ecx, edx);
+      if (ebx & CPUID_7_EBX_ERMS)
+        features |= STRING_FEATURE_ERMS;
+    }
+    string_features = features;
+  }
+  return string_features;
+}
+
+// the direction flag is not cleared on interrupt entry, so every forward string instruction clears it itself
+static inline void repMovsb(uint8*& dest, const uint8*& src, size_t count)
+{
+  asm volatile("cld\n\trep movsb" : "+D"(dest), "+S"(src), "+c"(count) : : "memory");
+}
+
+static inline void repMovsWords(uint8*& dest, const uint8*& src, size_t words)
+{
+  asm volatile("cld\n\t" REP_MOVS_WORDS : "+D"(dest), "+S"(src), "+c"(words) : : "memory");
+}
+
+/**
+ * 64 bytes per iteration through the xmm registers, dest has to be 16 byte aligned,
+ * both ranges have to be kernel memory, interrupts are off and a page fault would
+ * leave the FPU to the fault handler in the middle of the copy
+ */
+static void copySSE(uint8*& dest, const uint8*& src, size_t blocks)
+{
+  bool interrupts_enabled = ArchFpu::kernelBegin();
+  asm volatile("1:\n\t"
+               "movdqu (%1), %%xmm0\n\t"
+               "movdqu 16(%1), %%xmm1\n\t"
+               "movdqu 32(%1), %%xmm2\n\t"
+               "movdqu 48(%1), %%xmm3\n\t"
+               "movdqa %%xmm0, (%0)\n\t"
+               "movdqa %%xmm1, 16(%0)\n\t"
+               "movdqa %%xmm2, 32(%0)\n\t"
+               "movdqa %%xmm3, 48(%0)\n\t"
+               "add $64, %1\n\t"
+               "add $64, %0\n\t"
+               "dec %2\n\t"
+               "jnz 1b"
+               : "+r"(dest), "+r"(src), "+r"(blocks) : : "memory");
+  ArchFpu::kernelEnd(interrupts_enabled);
+}
+
+static void copyForward(uint8* dest, const uint8* src, size_t length)
+{
+  uint32 features = stringFeatures();
+  if (length >= SSE_COPY_MINIMUM && !(features & STRING_FEATURE_ERMS) && (features & STRING_FEATURE_SSE2)
+      && (size_t) dest >= USER_SPACE_END && (size_t) src >= USER_SPACE_END && ArchFpu::kernelSSEAvailable())
+  {
+    size_t head = -(size_t) dest & 15;
+    repMovsb(dest, src, head);
+    length -= head;
+    copySSE(dest, src, length / 64);
+    repMovsb(dest, src, length % 64);
+    return;
+  }
+  if ((features & STRING_FEATURE_ERMS) || length < 4 * sizeof(size_t))
+  {
+    repMovsb(dest, src, length);
+    return;
+  }
+  size_t head = -(size_t) dest & WORD_MASK;
+  repMovsb(dest, src, head);
+  length -= head;
+  repMovsWords(dest, src, length / sizeof(size_t));
+  repMovsb(dest, src, length & WORD_MASK);
+}
+
+#else
+
+static void copyForward(uint8* dest, const uint8* src, size_t length)
+{
+  if ((((size_t) dest ^ (size_t) src) & WORD_MASK) == 0)
+  {
+    // both can be word aligned, unaligned word accesses are not allowed everywhere
+    for (; length && ((size_t) dest & WORD_MASK); --length)
+      *dest++ = *src++;
+    size_t* d = (size_t*) dest;
+    const size_t* s = (const size_t*) src;
+    for (; length >= sizeof(size_t); length -= sizeof(size_t))
+      *d++ = *s++;
+    dest = (uint8*) d;
+    src = (const uint8*) s;
+  }
+  while (length--)
+    *dest++ = *src++;
+}
+
+#endif
+
+/**
+ * copies from the end to the beginning, for overlapping regions with dest behind src
+ */
+static void copyBackward(uint8* dest, const uint8* src, size_t length)
+{
+  dest += length;
+  src += length;
+  if ((((size_t) dest ^ (size_t) src) & WORD_MASK) == 0)
+  {
+    for (; length && ((size_t) dest & WORD_MASK); --length)
+      *--dest = *--src;
+    size_t* d = (size_t*) dest;
+    const size_t* s = (const size_t*) src;
+    for (; length >= sizeof(size_t); length -= sizeof(size_t))
+      *--d = *--s;
+    dest = (uint8*) d;
+    src = (const uint8*) s;
+  }
+  while (length--)
+    *--dest = *--src;
+}
 
 extern "C" size_t strlen(const char *str)
 {
   const char *pos = str;
 
+  for (; (size_t) pos & WORD_MASK; ++pos)
+  {
+    if (!*pos)
+      return (pos - str);
+  }
+
+  // aligned words never cross a page boundary, reading past the end is safe
+  const size_t* word = (const size_t*) pos;
+  while (!hasZeroByte(*word))
+  {
+    ++word;
+  }
+
+  pos = (const char*) word;
   while (*pos)
   {
     ++pos;
@@ -17,52 +199,25 @@ extern "C" size_t strlen(const char *str)
 
 extern "C" void *memcpy(void *dest, const void *src, size_t length)
 {
-  size_t i;
-  size_t* s = (size_t*) src;
-  size_t* d = (size_t*) dest;
-  size_t num_large_copies = length / sizeof(size_t);
-  size_t num_rest_copies = length % sizeof(size_t);
-  for (size_t i = 0; i < num_large_copies; ++i)
-  {
-    *d++ = *s++;
-  }
-  uint8* s8 = (uint8*) s;
-  uint8* d8 = (uint8*) d;
-  for (i = 0; i < num_rest_copies; ++i)
-  {
-    *d8++ = *s8++;
-  }
+  copyForward((uint8*) dest, (const uint8*) src, length);
   return dest;
 }
 
 extern "C" void *memmove(void *dest, const void *src, size_t length)
 {
-  uint8* dest8 = (uint8*) dest;
-  const uint8* src8 = (const uint8*) src;
-
   if (length == 0 || src == dest)
   {
     return dest;
   }
 
-  if (src < dest)
+  if (dest < src || (const uint8*) dest >= (const uint8*) src + length)
   {
-    // if src is before dest we can do a forward copy
-    while (length--)
-    {
-      *dest8++ = *src8++;
-    }
+    // dest does not overlap the part of src that is still to be read
+    copyForward((uint8*) dest, (const uint8*) src, length);
   }
   else
   {
-    // if src is _not_ before dest we have to do a backward copy
-    src8 += length;
-    dest8 += length;
-
-    while (length--)
-    {
-      *dest8-- = *src8--;
-    }
+    copyBackward((uint8*) dest, (const uint8*) src, length);
   }
 
   return dest;
@@ -91,27 +246,35 @@ void *memccpy(void *dest, const void *src, uint8 c, size_t length)
 
 extern "C" void *memset(void *block, uint8 c, size_t size)
 {
-  if (size)
+  uint8* d8 = (uint8*) block;
+  size_t large_c = c * ONES;
+#if __i386__ || __x86_64__
+  // called by the x86/32 boot code before paging is enabled, so no globals and no feature dispatch
+  size_t head = -(size_t) d8 & WORD_MASK;
+  if (head > size)
+    head = size;
+  size -= head;
+  size_t words = size / sizeof(size_t);
+  size_t tail = size & WORD_MASK;
+  asm volatile("cld\n\trep stosb" : "+D"(d8), "+c"(head) : "a"(large_c) : "memory");
+  asm volatile(REP_STOS_WORDS : "+D"(d8), "+c"(words) : "a"(large_c) : "memory");
+  asm volatile("rep stosb" : "+D"(d8), "+c"(tail) : "a"(large_c) : "memory");
+#else
+  for (; size && ((size_t) d8 & WORD_MASK); --size)
+  {
+    *d8++ = c;
+  }
+  size_t* d = (size_t*) d8;
+  for (; size >= sizeof(size_t); size -= sizeof(size_t))
+  {
+    *d++ = large_c;
+  }
+  d8 = (uint8*) d;
+  while (size--)
   {
-    size_t i;
-    size_t* d = (size_t*) block;
-    size_t large_c = c;
-    for (i = 0; i < sizeof(size_t); i++)
-    {
-      large_c = (large_c << 8) | c;
-    }
-    size_t num_large_copies = size / sizeof(size_t);
-    size_t num_rest_copies = size % sizeof(size_t);
-    for (i = 0; i < num_large_copies; ++i)
-    {
-      *d++ = large_c;
-    }
-    uint8* d8 = (uint8*) d;
-    for (i = 0; i < num_rest_copies; ++i)
-    {
-      *d8++ = c;
-    }
+    *d8++ = c;
   }
+#endif
   return block;
 }
 
@@ -229,34 +392,7 @@ extern "C" size_t strlcat(char *dest, const char*append, size_t size)
 
 extern "C" void bcopy(void *src, void* dest, size_t length)
 {
-  uint8* dest8 = (uint8*) dest;
-  const uint8* src8 = (const uint8*) src;
-
-  if (length == 0 || src == dest)
-  {
-    return;
-  }
-
-  if (src < dest)
-  {
-    // if src is before dest we can do a forward copy
-    while (length--)
-    {
-      *dest8++ = *src8++;
-    }
-  }
-  else
-  {
-    // if src is _not_ before dest we can do a forward copy
-    src8 += length;
-    dest8 += length;
-
-    while (length--)
-    {
-      *dest8-- = *src8--;
-    }
-  }
-
+  memmove(dest, src, length);
 }
 
 extern "C" int32 memcmp(const void *region1, const void *region2, size_t size)
@@ -290,6 +426,25 @@ extern "C" int32 strcmp(const char *str1, const char *str2)
     return 0;
   }
 
+  if ((((size_t) str1 ^ (size_t) str2) & WORD_MASK) == 0)
+  {
+    for (; (size_t) str1 & WORD_MASK; ++str1, ++str2)
+    {
+      if (!*str1 || *str1 != *str2)
+        return (*(uint8 *) str1 - *(uint8 *) str2);
+    }
+    // compare whole words until they differ or contain the terminating zero
+    const size_t* word1 = (const size_t*) str1;
+    const size_t* word2 = (const size_t*) str2;
+    while (*word1 == *word2 && !hasZeroByte(*word1))
+    {
+      ++word1;
+      ++word2;
+    }
+    str1 = (const char*) word1;
+    str2 = (const char*) word2;
+  }
+
   while ((*str1) && (*str2))
   {
     if (*str1 != *str2)
@@ -0,0 +1,32 @@
+#include "nonstd.h"
+#include "stdio.h"
+#include "bench.h"
+
+/*
+ * runs all userspace benchmarks one after another, start it from user_progs.h:
+ * "/usr/bench.sweb"
+ * the output is framed by BENCH_BEGIN and BENCH_END like the kernel benchmarks
+ */
+
+const char* benchmarks[] = {
+  "/usr/bench_syscall.sweb",
+  "/usr/bench_process.sweb",
+  "/usr/bench_pagefault.sweb",
+  "/usr/bench_file.sweb",
+  "/usr/bench_compute.sweb",
+  0
+};
+
+int main()
+{
+  bench_line("BENCH_BEGIN\n");
+  for (int i = 0; benchmarks[i]; ++i)
+  {
+    printf("bench: %s\n", benchmarks[i]);
+    if (createprocess(benchmarks[i], 1) != 0)
+      bench_skip(benchmarks[i], "not found");
+  }
+  bench_line("BENCH_END\n");
+  printf("bench: done\n");
+  return 0;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "sys/syscall.h"
+#include "../../common/include/kernel/syscall-definitions.h"
+
+/*
+ * helpers shared by the benchmark programs
+ *
+ * results are written to the debug port (qemu -debugcon stdio) in the same format as the
+ * kernel benchmarks, utils/bench/run_bench.py collects them and compares against a baseline:
+ * BENCH <name> iterations=N cycles=T per_iteration=A min=X max=Y
+ */
+
+typedef unsigned long long cycles_t;
+
+typedef struct
+{
+  const char* name;
+  unsigned int iterations;
+  cycles_t total;
+  cycles_t min;
+  cycles_t max;
+  cycles_t started;
+} bench_t;
+
+static inline cycles_t bench_timestamp()
+{
+#if defined(__i386__) || defined(__x86_64__)
+  unsigned int low, high;
+  __asm__ __volatile__("rdtsc" : "=a"(low), "=d"(high));
+  return ((cycles_t) high << 32) | low;
+#else
+  return 0; // no cycle counter that is readable from user mode
+#endif
+}
+
+static inline void bench_begin(bench_t* bench, const char* name)
+{
+  bench->name = name;
+  bench->iterations = 0;
+  bench->total = 0;
+  bench->min = -1ULL;
+  bench->max = 0;
+}
+
+static inline void bench_start(bench_t* bench)
+{
+  bench->started = bench_timestamp();
+}
+
+static inline void bench_stop(bench_t* bench)
+{
+  cycles_t cycles = bench_timestamp() - bench->started;
+  ++bench->iterations;
+  bench->total += cycles;
+  if (cycles < bench->min)
+    bench->min = cycles;
+  if (cycles > bench->max)
+    bench->max = cycles;
+}
+
+/*
+ * libc printf can not print 64 bit numbers
+ */
+static inline char* bench_append(char* position, char* end, const char* string)
+{
+  while (*string && position < end)
+    *position++ = *string++;
+  return position;
+}
+
+static inline char* bench_append_number(char* position, char* end, cycles_t value)
+{
+  char digits[24];
+  int count = 0;
+  do
+  {
+    digits[count++] = '0' + value % 10;
+    value /= 10;
+  } while (value);
+  while (count && position < end)
+    *position++ = digits[--count];
+  return position;
+}
+
+static inline void bench_line(const char* line)
+{
+  __syscall(sc_outline, 0xe9, (size_t) line, 0x00, 0x00, 0x00);
+}
+
+/*
+ * prints the result, bytes (the total amount of data moved) is added to the line if it is not 0
+ */
+static inline void bench_print(bench_t* bench, unsigned int bytes)
+{
+  if (!bench->iterations)
+    return;
+  char line[200];
+  char* end = line + sizeof(line) - 1;
+  char* position = bench_append(line, end, "BENCH ");
+  position = bench_append(position, end, bench->name);
+  position = bench_append(position, end, " iterations=");
+  position = bench_append_number(position, end, bench->iterations);
+  position = bench_append(position, end, " cycles=");
+  position = bench_append_number(position, end, bench->total);
+  position = bench_append(position, end, " per_iteration=");
+  position = bench_append_number(position, end, bench->total / bench->iterations);
+  position = bench_append(position, end, " min=");
+  position = bench_append_number(position, end, bench->min);
+  position = bench_append(position, end, " max=");
+  position = bench_append_number(position, end, bench->max);
+  if (bytes)
+  {
+    position = bench_append(position, end, " bytes=");
+    position = bench_append_number(position, end, bytes);
+  }
+  position = bench_append(position, end, "\n");
+  *position = 0;
+  bench_line(line);
+}
+
+static inline void bench_skip(const char* name, const char* reason)
+{
+  char line[200];
+  char* end = line + sizeof(line) - 1;
+  char* position = bench_append(line, end, "BENCH_SKIP ");
+  position = bench_append(position, end, name);
+  position = bench_append(position, end, " ");
+  position = bench_append(position, end, reason);
+  position = bench_append(position, end, "\n");
+  *position = 0;
+  bench_line(line);
+}
@@ -0,0 +1,66 @@
+#include "string.h"
+#include "bench.h"
+
+/*
+ * pure userspace work, the kernel only shows up through timer interrupts and page faults:
+ * a matrix multiplication and copying a buffer that fits into the cache
+ */
+
+#define MATRIX_SIZE 64
+#define MATRIX_ITERATIONS 5
+#define COPY_SIZE 16384
+#define COPY_ITERATIONS 100
+
+typedef unsigned int uint32;
+
+uint32 a[MATRIX_SIZE][MATRIX_SIZE];
+uint32 b[MATRIX_SIZE][MATRIX_SIZE];
+uint32 c[MATRIX_SIZE][MATRIX_SIZE];
+
+char source[COPY_SIZE];
+char destination[COPY_SIZE];
+
+int main()
+{
+  bench_t bench;
+  uint32 random = 31337;
+  for (int x = 0; x < MATRIX_SIZE; ++x)
+  {
+    for (int y = 0; y < MATRIX_SIZE; ++y)
+    {
+      random = random * 1103515245 + 12345;
+      a[x][y] = random >> 16;
+      random = random * 1103515245 + 12345;
+      b[x][y] = random >> 16;
+    }
+  }
+
+  bench_begin(&bench, "user_matrix");
+  for (int i = 0; i < MATRIX_ITERATIONS; ++i)
+  {
+    bench_start(&bench);
+    for (int x = 0; x < MATRIX_SIZE; ++x)
+    {
+      for (int y = 0; y < MATRIX_SIZE; ++y)
+      {
+        uint32 sum = 0;
+        for (int k = 0; k < MATRIX_SIZE; ++k)
+          sum += a[x][k] * b[k][y];
+        c[x][y] = sum;
+      }
+    }
+    bench_stop(&bench);
+  }
+  bench_print(&bench, 0);
+
+  memset(source, 0x5a, COPY_SIZE);
+  bench_begin(&bench, "user_memcpy");
+  for (int i = 0; i < COPY_ITERATIONS; ++i)
+  {
+    bench_start(&bench);
+    memcpy(destination, source, COPY_SIZE);
+    bench_stop(&bench);
+  }
+  bench_print(&bench, COPY_ITERATIONS * COPY_SIZE);
+  return c[1][2] + destination[3];
+}
@@ -0,0 +1,66 @@
+#include "unistd.h"
+#include "fcntl.h"
+#include "bench.h"
+
+/*
+ * file lifecycle on the minixfs mount: create, write, read back and unlink
+ */
+
+#define ITERATIONS 20
+#define FILE_SIZE 4096
+#define FILE_NAME "/usr/bench.tmp"
+
+char buffer[FILE_SIZE];
+
+int main()
+{
+  bench_t create, write_file, read_file, unlink_file;
+  bench_begin(&create, "user_file_create");
+  bench_begin(&write_file, "user_file_write");
+  bench_begin(&read_file, "user_file_read");
+  bench_begin(&unlink_file, "user_file_unlink");
+
+  for (int i = 0; i < FILE_SIZE; ++i)
+    buffer[i] = (char) i;
+
+  for (int i = 0; i < ITERATIONS; ++i)
+  {
+    bench_start(&create);
+    int fd = open(FILE_NAME, O_CREAT | O_WRONLY);
+    close(fd);
+    bench_stop(&create);
+    if (fd < 0)
+    {
+      bench_skip("user_file", "could not create " FILE_NAME);
+      return -1;
+    }
+
+    // files created by open are only writable after reopening them
+    bench_start(&write_file);
+    fd = open(FILE_NAME, O_WRONLY);
+    write(fd, buffer, FILE_SIZE);
+    close(fd);
+    bench_stop(&write_file);
+
+    bench_start(&read_file);
+    fd = open(FILE_NAME, O_RDONLY);
+    read(fd, buffer, FILE_SIZE);
+    close(fd);
+    bench_stop(&read_file);
+
+    bench_start(&unlink_file);
+    int removed = unlink(FILE_NAME);
+    bench_stop(&unlink_file);
+    if (removed != 0)
+    {
+      bench_skip("user_file_unlink", "could not unlink_file " FILE_NAME);
+      return -1;
+    }
+  }
+
+  bench_print(&create, 0);
+  bench_print(&write_file, ITERATIONS * FILE_SIZE);
+  bench_print(&read_file, ITERATIONS * FILE_SIZE);
+  bench_print(&unlink_file, 0);
+  return 0;
+}
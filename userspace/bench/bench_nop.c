@@ -0,0 +1,8 @@
+/*
+ * does nothing, started by bench_process to measure process creation and teardown
+ */
+
+int main()
+{
+  return 0;
+}
@@ -0,0 +1,36 @@
+#include "bench.h"
+
+/*
+ * page fault cost: every page of the array is mapped on its first access,
+ * the second pass over the same pages measures the access without a fault
+ */
+
+#define PAGE_SIZE 4096
+#define PAGES 64
+
+char pages[PAGES * PAGE_SIZE];
+
+int main()
+{
+  bench_t bench;
+  volatile char* page = pages;
+
+  bench_begin(&bench, "user_pagefault");
+  for (int i = 0; i < PAGES; ++i)
+  {
+    bench_start(&bench);
+    page[i * PAGE_SIZE] = 1;
+    bench_stop(&bench);
+  }
+  bench_print(&bench, 0);
+
+  bench_begin(&bench, "user_page_touch");
+  for (int i = 0; i < PAGES; ++i)
+  {
+    bench_start(&bench);
+    page[i * PAGE_SIZE] = 2;
+    bench_stop(&bench);
+  }
+  bench_print(&bench, 0);
+  return 0;
+}
@@ -0,0 +1,26 @@
+#include "nonstd.h"
+#include "bench.h"
+
+/*
+ * process creation: loading, running and tearing down a program that returns immediately
+ */
+
+#define ITERATIONS 20
+
+int main()
+{
+  bench_t bench;
+  bench_begin(&bench, "user_createprocess");
+  for (int i = 0; i < ITERATIONS; ++i)
+  {
+    bench_start(&bench);
+    if (createprocess("/usr/bench_nop.sweb", 1) != 0)
+    {
+      bench_skip("user_createprocess", "bench_nop.sweb not found");
+      return -1;
+    }
+    bench_stop(&bench);
+  }
+  bench_print(&bench, 0);
+  return 0;
+}
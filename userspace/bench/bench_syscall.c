@@ -0,0 +1,53 @@
+#include "sched.h"
+#include "unistd.h"
+#include "fcntl.h"
+#include "bench.h"
+
+/*
+ * syscall round trips: a syscall that does no work, a write to stdout that prints nothing
+ * and a one byte read from a file on the minixfs mount
+ */
+
+#define ITERATIONS 1000
+
+int main()
+{
+  bench_t bench;
+
+  bench_begin(&bench, "user_sched_yield");
+  for (int i = 0; i < ITERATIONS; ++i)
+  {
+    bench_start(&bench);
+    sched_yield();
+    bench_stop(&bench);
+  }
+  bench_print(&bench, 0);
+
+  bench_begin(&bench, "user_write_stdout");
+  for (int i = 0; i < ITERATIONS; ++i)
+  {
+    bench_start(&bench);
+    write(STDOUT_FILENO, "", 0);
+    bench_stop(&bench);
+  }
+  bench_print(&bench, 0);
+
+  int fd = open("/usr/bench_syscall.sweb", O_RDONLY);
+  if (fd < 0)
+  {
+    bench_skip("user_read_file", "no file to read");
+    return -1;
+  }
+  char byte;
+  bench_begin(&bench, "user_read_file");
+  for (int i = 0; i < ITERATIONS; ++i)
+  {
+    lseek(fd, 0, SEEK_SET);
+    bench_start(&bench);
+    read(fd, &byte, 1);
+    bench_stop(&bench);
+  }
+  bench_print(&bench, ITERATIONS);
+  close(fd);
+  return 0;
+}
@@ -16,6 +16,16 @@ extern "C" {
  */ 
 extern int createprocess(const char* path, int sleep);
 
+/**
+ * Controls the kernel's sampling profiler, the profile is printed to the debug output.
+ *
+ * @param command one of PROFILE_STOP, PROFILE_START, PROFILE_PRINT and PROFILE_RESET
+ * @param period for PROFILE_START: take a sample every period timer ticks
+ * @return 0 on success, -1 for an unknown command
+ *
+ */
+extern int profile(int command, unsigned int period);
+
 #ifdef __cplusplus
 }
 #endif
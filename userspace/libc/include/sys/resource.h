@@ -0,0 +1,28 @@
+#pragma once
+
+#include "types.h"
+#include "../../../../common/include/kernel/rusage-definitions.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Reads the resource usage counters of the calling process or thread.
+ * Optionally the number of calls of every syscall is stored as well,
+ * syscall_counts[n] is the number of calls of syscall n.
+ *
+ * @param who RUSAGE_SELF for the whole process, RUSAGE_THREAD for the calling thread
+ * @param usage the counters are stored here
+ * @param syscall_counts array receiving the calls per syscall number or NULL
+ * @param num_counts the number of entries of syscall_counts
+ * @return 0 on success, -1 if an error occured
+ *
+ */
+extern int getrusage(int who, struct ResourceUsage *usage, unsigned int *syscall_counts,
+                     unsigned int num_counts);
+
+#ifdef __cplusplus
+}
+#endif
+
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "types.h"
+#include "../../../../common/include/kernel/ring-definitions.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * the submission entries of a ring returned by ring_setup
+ */
+#define RING_SQ(ring) ((struct RingSubmission*) ((char*) (ring) + RING_SQ_OFFSET))
+
+/**
+ * the completion entries of a ring returned by ring_setup
+ */
+#define RING_CQ(ring) ((struct RingCompletion*) ((char*) (ring) + RING_CQ_OFFSET))
+
+/**
+ * Maps the submission/completion ring of the process and starts the kernel
+ * worker executing its requests. Calling it again returns the same ring.
+ *
+ * A request is submitted by filling in RING_SQ(ring)[sq_tail % sq_entries]
+ * and incrementing sq_tail. The result shows up in
+ * RING_CQ(ring)[cq_head % cq_entries] once cq_tail moved past cq_head,
+ * after reading it cq_head is incremented.
+ *
+ * @return the ring, or (struct RingHeader*) -1 if an error occured
+ *
+ */
+extern struct RingHeader* ring_setup(void);
+
+/**
+ * Hands the submissions published in the ring to the kernel and optionally
+ * waits until the given number of completions is available.
+ *
+ * @param to_submit the number of submissions published since the last call
+ * @param min_complete the number of completions to wait for
+ * @return the number of submissions handed to the kernel, -1 if an error\
+ occured
+ *
+ */
+extern int ring_enter(unsigned int to_submit, unsigned int min_complete);
+
+#ifdef __cplusplus
+}
+#endif
+
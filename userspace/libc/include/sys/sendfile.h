@@ -0,0 +1,29 @@
+#pragma once
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Copies data from one file descriptor to another.
+ * The data is copied inside the kernel and never passes through userspace.
+ * If offset is NULL the data is read at the file position of in_fd and the
+ * file position is advanced, otherwise it is read at *offset which is
+ * advanced instead. The data is always written at the file position of
+ * out_fd.
+ *
+ * @param out_fd file descriptor referencing the file to write
+ * @param in_fd file descriptor referencing the file to read
+ * @param offset pointer to the read offset or NULL
+ * @param count the number of bytes to copy
+ * @return the number of bytes copied, and -1 if an error occured
+ *
+ */
+extern ssize_t sendfile(int out_fd, int in_fd, off_t *offset, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * maximum number of elements in an iovec array
+ */
+#define IOV_MAX 1024
+
+/**
+ * describes one buffer of a vectored read or write
+ */
+struct iovec
+{
+  void* iov_base;
+  size_t iov_len;
+};
+
+/**
+ * Reads from a file descriptor into several buffers.
+ * The buffers are filled in array order, each one completely before the
+ * next one is used.
+ *
+ * @param file_descriptor file descriptor referencing the file to read
+ * @param iov array of buffers where the read data will be placed
+ * @param iovcnt the number of elements in iov
+ * @return the number of bytes read on success, -1 if an error occured
+ *
+ */
+extern ssize_t readv(int file_descriptor, const struct iovec *iov, int iovcnt);
+
+/**
+ * Writes the contents of several buffers to a file descriptor.
+ * The buffers are written in array order with a single system call.
+ *
+ * @param file_descriptor file descriptor referencing the file to write
+ * @param iov array of buffers holding the data to write
+ * @param iovcnt the number of elements in iov
+ * @return the number of bytes written on success, -1 if an error occured
+ *
+ */
+extern ssize_t writev(int file_descriptor, const struct iovec *iov, int iovcnt);
+
+#ifdef __cplusplus
+}
+#endif
+
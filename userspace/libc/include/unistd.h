@@ -264,6 +264,21 @@ extern off_t lseek(int file_descriptor, off_t offset, int whence);
  */
 extern ssize_t read(int file_descriptor, void *buffer, size_t count);
 
+/**
+ * Reads from a file descriptor at the given offset.
+ * Works like read, but starts reading at the given absolute offset and
+ * neither uses nor changes the file position associated with the descriptor.
+ *
+ * @param file_descriptor file descriptor referencing the file to read
+ * @param buffer the buffer where the read data will be placed
+ * @param count the number of bytes to read
+ * @param offset the absolute offset where the read operation starts
+ * @return the number of bytes read on success, 0 if count is zero or the \
+ offset for reading is after the end-of-file, and -1 if an error occured
+ *
+ */
+extern ssize_t pread(int file_descriptor, void *buffer, size_t count, off_t offset);
+
 /**
  * Writes to a file descriptor.
  * Up to count bytes from the provided buffer are written to the given file.
@@ -282,6 +297,70 @@ extern ssize_t read(int file_descriptor, void *buffer, size_t count);
  */
 extern ssize_t write(int file_descriptor, const void *buffer, size_t count);
 
+/**
+ * Writes to a file descriptor at the given offset.
+ * Works like write, but starts writing at the given absolute offset and
+ * neither uses nor changes the file position associated with the descriptor.
+ *
+ * @param file_descriptor file descriptor referencing the file to write
+ * @param buffer the buffer holding the data to write
+ * @param count the number of bytes to write
+ * @param offset the absolute offset where the write operation starts
+ * @return the number of bytes written on success, 0 if count is zero or\
+ nothing was written, and -1 if an error occured
+ *
+ */
+extern ssize_t pwrite(int file_descriptor, const void *buffer, size_t count, off_t offset);
+
+/**
+ * Transfers all modified data and metadata of the given file to the disk.
+ * The call blocks until the disk reports that the transfer has completed.
+ *
+ * @param file_descriptor file descriptor referencing the file to synchronize
+ * @return 0 on success, -1 if an error occured
+ *
+ */
+extern int fsync(int file_descriptor);
+
+/**
+ * Writes the metadata of all mounted file systems, which the kernel keeps in
+ * memory for a while, to the disk.
+ *
+ */
+extern void sync(void);
+
+/**
+ * Sets the size of the given file to length bytes. Data beyond the new end
+ * is discarded, growing the file adds a region that reads as zeros.
+ * Only supported by file systems keeping their files in memory.
+ *
+ * @param file_descriptor file descriptor of a file opened for writing
+ * @param length the new size of the file
+ * @return 0 on success, -1 if an error occured
+ *
+ */
+extern int ftruncate(int file_descriptor, off_t length);
+
+/**
+ * Copies a range of data from one file to another.
+ * The data is copied inside the kernel and never passes through userspace.
+ * If off_in is NULL the data is read at the file position of fd_in and the
+ * file position is advanced, otherwise it is read at *off_in which is
+ * advanced instead (likewise for off_out and fd_out).
+ *
+ * @param fd_in file descriptor referencing the file to read
+ * @param off_in pointer to the read offset or NULL
+ * @param fd_out file descriptor referencing the file to write
+ * @param off_out pointer to the write offset or NULL
+ * @param len the number of bytes to copy
+ * @param flags has to be 0
+ * @return the number of bytes copied, 0 at end-of-file of fd_in, and -1 if\
+ an error occured
+ *
+ */
+extern ssize_t copy_file_range(int fd_in, off_t *off_in, int fd_out, off_t *off_out, size_t len,
+                               unsigned int flags);
+
 extern int brk(void *end_data_segment);
 
 extern void* sbrk(intptr_t increment);
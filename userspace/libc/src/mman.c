@@ -1,22 +1,63 @@
 #include "sys/mman.h"
+#include "sys/syscall.h"
+#include "../../../common/include/kernel/syscall-definitions.h"
 
 /**
- * function stub
+ * Maps length bytes of the file fd starting at offset into the address space.
+ * The pages are mapped on the first access. Changes to a shared mapping reach
+ * the file, at the latest with msync or munmap, changes to a private mapping
+ * stay in the process. An anonymous mapping has no file and starts out zeroed.
  * posix compatible signature - do not change the signature!
+ *
+ * @param start the address wished for, another one is taken if it is not free
+ * @param length the number of bytes to map
+ * @param prot PROT_READ and/or PROT_WRITE
+ * @param flags MAP_SHARED or MAP_PRIVATE, optionally with MAP_ANONYMOUS
+ * @param fd the file descriptor of the file to map, ignored for MAP_ANONYMOUS
+ * @param offset the page aligned offset in the file
+ * @return the address of the mapping, MAP_FAILED if an error occured
+ *
  */
 void* mmap(void* start, size_t length, int prot, int flags, int fd,
            off_t offset)
 {
-  return 0;
+  struct MmapArgs args;
+  args.start = (unsigned long) start;
+  args.length = length;
+  args.prot = prot;
+  args.flags = flags;
+  args.fd = fd;
+  args.offset = offset;
+  return (void*) __syscall(sc_mmap, (long) &args, 0x00, 0x00, 0x00, 0x00);
 }
 
 /**
- * function stub
+ * Removes the mappings in the given range.
  * posix compatible signature - do not change the signature!
+ *
+ * @param start the page aligned start of the range
+ * @param length the length of the range in bytes
+ * @return 0 on success, -1 if an error occured
+ *
  */
 int munmap(void* start, size_t length)
 {
-  return -1;
+  return __syscall(sc_munmap, (long) start, length, 0x00, 0x00, 0x00);
+}
+
+/**
+ * Writes the changes to the shared mappings in the given range back to their files.
+ * posix compatible signature - do not change the signature!
+ *
+ * @param start the page aligned start of the range
+ * @param length the length of the range in bytes
+ * @param flags MS_ASYNC or MS_SYNC, optionally with MS_INVALIDATE
+ * @return 0 on success, -1 if an error occured
+ *
+ */
+int msync(void* start, size_t length, int flags)
+{
+  return __syscall(sc_msync, (long) start, length, flags, 0x00, 0x00);
 }
 
 /**
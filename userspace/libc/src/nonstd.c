@@ -8,6 +8,11 @@ int createprocess(const char* path, int sleep)
   return __syscall(sc_createprocess, (long) path, sleep, 0x00, 0x00, 0x00);
 }
 
+int profile(int command, unsigned int period)
+{
+  return __syscall(sc_profile, command, period, 0x00, 0x00, 0x00);
+}
+
 extern int main();
 
 void _start()
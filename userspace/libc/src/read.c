@@ -68,3 +68,21 @@ ssize_t read(int file_descriptor, void *buffer, size_t count)
 }
 
 
+/**
+ * Reads from a file descriptor at the given offset.
+ * Works like read, but starts reading at the given absolute offset and
+ * neither uses nor changes the file position associated with the descriptor.
+ *
+ * @param file_descriptor file descriptor referencing the file to read
+ * @param buffer the buffer where the read data will be placed
+ * @param count the number of bytes to read
+ * @param offset the absolute offset where the read operation starts
+ * @return the number of bytes read on success, 0 if count is zero or the \
+ offset for reading is after the end-of-file, and -1 if an error occured
+ *
+ */
+ssize_t pread(int file_descriptor, void *buffer, size_t count, off_t offset)
+{
+  return __syscall(sc_pread, file_descriptor, (long) buffer, count, offset, 0x00);
+}
+
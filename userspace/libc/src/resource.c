@@ -0,0 +1,40 @@
+// Projectname: SWEB
+// Simple operating system for educational purposes
+//
+// Copyright (C) 2005  Andreas Niederl
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#include "sys/resource.h"
+#include "sys/syscall.h"
+#include "../../../common/include/kernel/syscall-definitions.h"
+
+/**
+ * Reads the resource usage counters of the calling process or thread.
+ * Optionally the number of calls of every syscall is stored as well,
+ * syscall_counts[n] is the number of calls of syscall n.
+ *
+ * @param who RUSAGE_SELF for the whole process, RUSAGE_THREAD for the calling thread
+ * @param usage the counters are stored here
+ * @param syscall_counts array receiving the calls per syscall number or NULL
+ * @param num_counts the number of entries of syscall_counts
+ * @return 0 on success, -1 if an error occured
+ *
+ */
+int getrusage(int who, struct ResourceUsage *usage, unsigned int *syscall_counts, unsigned int num_counts)
+{
+  return __syscall(sc_getrusage, who, (long) usage, (long) syscall_counts, num_counts, 0x00);
+}
@@ -0,0 +1,50 @@
+// Projectname: SWEB
+// Simple operating system for educational purposes
+//
+// Copyright (C) 2005  Andreas Niederl
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#include "sys/ring.h"
+#include "sys/syscall.h"
+#include "../../../common/include/kernel/syscall-definitions.h"
+
+/**
+ * Maps the submission/completion ring of the process and starts the kernel
+ * worker executing its requests. Calling it again returns the same ring.
+ *
+ * @return the ring, or (struct RingHeader*) -1 if an error occured
+ *
+ */
+struct RingHeader* ring_setup(void)
+{
+  return (struct RingHeader*) __syscall(sc_ring_setup, 0x00, 0x00, 0x00, 0x00, 0x00);
+}
+
+/**
+ * Hands the submissions published in the ring to the kernel and optionally
+ * waits until the given number of completions is available.
+ *
+ * @param to_submit the number of submissions published since the last call
+ * @param min_complete the number of completions to wait for
+ * @return the number of submissions handed to the kernel, -1 if an error\
+ occured
+ *
+ */
+int ring_enter(unsigned int to_submit, unsigned int min_complete)
+{
+  return __syscall(sc_ring_enter, to_submit, min_complete, 0x00, 0x00, 0x00);
+}
@@ -0,0 +1,69 @@
+// Projectname: SWEB
+// Simple operating system for educational purposes
+//
+// Copyright (C) 2005  Andreas Niederl
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#include "sys/sendfile.h"
+#include "unistd.h"
+#include "sys/syscall.h"
+#include "../../../common/include/kernel/syscall-definitions.h"
+
+/**
+ * Copies data from one file descriptor to another.
+ * The data is copied inside the kernel and never passes through userspace.
+ * If offset is NULL the data is read at the file position of in_fd and the
+ * file position is advanced, otherwise it is read at *offset which is
+ * advanced instead. The data is always written at the file position of
+ * out_fd.
+ *
+ * @param out_fd file descriptor referencing the file to write
+ * @param in_fd file descriptor referencing the file to read
+ * @param offset pointer to the read offset or NULL
+ * @param count the number of bytes to copy
+ * @return the number of bytes copied, and -1 if an error occured
+ *
+ */
+ssize_t sendfile(int out_fd, int in_fd, off_t *offset, size_t count)
+{
+  return __syscall(sc_sendfile, out_fd, in_fd, (long) offset, count, 0x00);
+}
+
+/**
+ * Copies a range of data from one file to another.
+ * The data is copied inside the kernel and never passes through userspace.
+ * If off_in is NULL the data is read at the file position of fd_in and the
+ * file position is advanced, otherwise it is read at *off_in which is
+ * advanced instead (likewise for off_out and fd_out).
+ *
+ * @param fd_in file descriptor referencing the file to read
+ * @param off_in pointer to the read offset or NULL
+ * @param fd_out file descriptor referencing the file to write
+ * @param off_out pointer to the write offset or NULL
+ * @param len the number of bytes to copy
+ * @param flags has to be 0
+ * @return the number of bytes copied, 0 at end-of-file of fd_in, and -1 if\
+ an error occured
+ *
+ */
+ssize_t copy_file_range(int fd_in, off_t *off_in, int fd_out, off_t *off_out, size_t len,
+                        unsigned int flags)
+{
+  if (flags != 0)
+    return -1;
+  return __syscall(sc_copy_file_range, fd_in, (long) off_in, fd_out, (long) off_out, len);
+}
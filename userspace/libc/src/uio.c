@@ -0,0 +1,54 @@
+// Projectname: SWEB
+// Simple operating system for educational purposes
+//
+// Copyright (C) 2005  Andreas Niederl
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#include "sys/uio.h"
+#include "sys/syscall.h"
+#include "../../../common/include/kernel/syscall-definitions.h"
+
+/**
+ * Reads from a file descriptor into several buffers.
+ * The buffers are filled in array order, each one completely before the
+ * next one is used.
+ *
+ * @param file_descriptor file descriptor referencing the file to read
+ * @param iov array of buffers where the read data will be placed
+ * @param iovcnt the number of elements in iov
+ * @return the number of bytes read on success, -1 if an error occured
+ *
+ */
+ssize_t readv(int file_descriptor, const struct iovec *iov, int iovcnt)
+{
+  return __syscall(sc_readv, file_descriptor, (long) iov, iovcnt, 0x00, 0x00);
+}
+
+/**
+ * Writes the contents of several buffers to a file descriptor.
+ * The buffers are written in array order with a single system call.
+ *
+ * @param file_descriptor file descriptor referencing the file to write
+ * @param iov array of buffers holding the data to write
+ * @param iovcnt the number of elements in iov
+ * @return the number of bytes written on success, -1 if an error occured
+ *
+ */
+ssize_t writev(int file_descriptor, const struct iovec *iov, int iovcnt)
+{
+  return __syscall(sc_writev, file_descriptor, (long) iov, iovcnt, 0x00, 0x00);
+}
@@ -42,3 +42,60 @@ ssize_t write(int file_descriptor, const void *buffer, size_t count)
   return __syscall(sc_write, file_descriptor, (long) buffer, count, 0x00,
                    0x00);
 }
+
+/**
+ * Writes to a file descriptor at the given offset.
+ * Works like write, but starts writing at the given absolute offset and
+ * neither uses nor changes the file position associated with the descriptor.
+ *
+ * @param file_descriptor file descriptor referencing the file to write
+ * @param buffer the buffer holding the data to write
+ * @param count the number of bytes to write
+ * @param offset the absolute offset where the write operation starts
+ * @return the number of bytes written on success, 0 if count is zero or\
+ nothing was written, and -1 if an error occured
+ *
+ */
+ssize_t pwrite(int file_descriptor, const void *buffer, size_t count, off_t offset)
+{
+  return __syscall(sc_pwrite, file_descriptor, (long) buffer, count, offset,
+                   0x00);
+}
+
+/**
+ * Transfers all modified data and metadata of the given file to the disk.
+ * The call blocks until the disk reports that the transfer has completed.
+ *
+ * @param file_descriptor file descriptor referencing the file to synchronize
+ * @return 0 on success, -1 if an error occured
+ *
+ */
+int fsync(int file_descriptor)
+{
+  return __syscall(sc_fsync, file_descriptor, 0x00, 0x00, 0x00, 0x00);
+}
+
+/**
+ * Writes the metadata of all mounted file systems, which the kernel keeps in
+ * memory for a while, to the disk.
+ *
+ */
+void sync(void)
+{
+  __syscall(sc_sync, 0x00, 0x00, 0x00, 0x00, 0x00);
+}
+
+/**
+ * Sets the size of the given file to length bytes. Data beyond the new end
+ * is discarded, growing the file adds a region that reads as zeros.
+ * Only supported by file systems keeping their files in memory.
+ *
+ * @param file_descriptor file descriptor of a file opened for writing
+ * @param length the new size of the file
+ * @return 0 on success, -1 if an error occured
+ *
+ */
+int ftruncate(int file_descriptor, off_t length)
+{
+  return __syscall(sc_ftruncate, file_descriptor, length, 0x00, 0x00, 0x00);
+}
@@ -0,0 +1,166 @@
+#include "unistd.h"
+#include "stdio.h"
+#include "string.h"
+#include "fcntl.h"
+#include "sys/mman.h"
+
+/*
+ * checks writes across holes and ftruncate on /tmp and the mmap variants,
+ * every check prints its result, the exit code is the number of failed checks
+ */
+
+#define PAGE_SIZE 4096
+
+char buffer[3 * PAGE_SIZE];
+char zeros[PAGE_SIZE];
+int failed = 0;
+
+void check(int ok, const char* what)
+{
+  printf("filetest: %s %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok)
+    ++failed;
+}
+
+int create(const char* path)
+{
+  // files created by open are only writable after reopening them
+  close(open(path, O_CREAT | O_WRONLY));
+  return open(path, O_RDWR);
+}
+
+void testHoles()
+{
+  int fd = create("/tmp/holes");
+  check(fd >= 0, "create /tmp/holes");
+  if (fd < 0)
+    return;
+
+  memset(buffer, 'a', 1000);
+  check(write(fd, buffer, 1000) == 1000, "write more than 256 bytes to /tmp");
+
+  // leaves the second page as a hole
+  memset(buffer, 'b', 100);
+  check(lseek(fd, 2 * PAGE_SIZE + 50, SEEK_SET) == 2 * PAGE_SIZE + 50, "seek behind the end");
+  check(write(fd, buffer, 100) == 100, "write behind a hole");
+
+  memset(buffer, 0xff, sizeof(buffer));
+  lseek(fd, 0, SEEK_SET);
+  check(read(fd, buffer, sizeof(buffer)) == 2 * PAGE_SIZE + 150, "read the whole file");
+  int i;
+  int ok = 1;
+  for (i = 0; i < 1000; ++i)
+    ok = ok && buffer[i] == 'a';
+  for (; i < 2 * PAGE_SIZE + 50; ++i)
+    ok = ok && buffer[i] == 0;
+  for (; i < 2 * PAGE_SIZE + 150; ++i)
+    ok = ok && buffer[i] == 'b';
+  check(ok, "read the data and zeros for the hole");
+
+  check(ftruncate(fd, 500) == 0, "shrink with ftruncate");
+  check(ftruncate(fd, PAGE_SIZE + 10) == 0, "grow with ftruncate");
+  memset(buffer, 0xff, sizeof(buffer));
+  lseek(fd, 0, SEEK_SET);
+  check(read(fd, buffer, sizeof(buffer)) == PAGE_SIZE + 10, "read the grown file");
+  ok = 1;
+  for (i = 0; i < 500; ++i)
+    ok = ok && buffer[i] == 'a';
+  for (; i < PAGE_SIZE + 10; ++i)
+    ok = ok && buffer[i] == 0;
+  check(ok, "read zeros behind the old end");
+
+  close(fd);
+  unlink("/tmp/holes");
+}
+
+void testSharedTmp()
+{
+  int fd = create("/tmp/shared");
+  check(fd >= 0, "create /tmp/shared");
+  if (fd < 0)
+    return;
+
+  check(write(fd, zeros, PAGE_SIZE) == PAGE_SIZE, "fill /tmp/shared");
+  char* map = mmap(0, PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  check(map != MAP_FAILED, "mmap MAP_SHARED on /tmp");
+  if (map != MAP_FAILED)
+  {
+    memcpy(map + 100, "shared", 7);
+    memset(buffer, 0, 16);
+    check(pread(fd, buffer, 16, 100) == 16 && strcmp(buffer, "shared") == 0, "read sees the store to the mapping");
+    check(munmap(map, PAGE_SIZE) == 0, "munmap /tmp/shared");
+  }
+
+  close(fd);
+  unlink("/tmp/shared");
+}
+
+void testPrivate()
+{
+  int fd = create("/tmp/private");
+  check(fd >= 0, "create /tmp/private");
+  if (fd < 0)
+    return;
+
+  memset(buffer, 'p', PAGE_SIZE);
+  check(write(fd, buffer, PAGE_SIZE) == PAGE_SIZE, "fill /tmp/private");
+  char* map = mmap(0, PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  check(map != MAP_FAILED, "mmap MAP_PRIVATE");
+  if (map != MAP_FAILED)
+  {
+    check(map[0] == 'p' && map[PAGE_SIZE - 1] == 'p', "the private mapping holds the file data");
+    map[0] = 'q';
+    buffer[0] = 0;
+    check(pread(fd, buffer, 1, 0) == 1 && buffer[0] == 'p', "the store to the private mapping stays private");
+    check(munmap(map, PAGE_SIZE) == 0, "munmap the private mapping");
+  }
+
+  close(fd);
+  unlink("/tmp/private");
+
+  map = mmap(0, 2 * PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  check(map != MAP_FAILED, "mmap MAP_ANONYMOUS");
+  if (map != MAP_FAILED)
+  {
+    check(map[0] == 0 && map[2 * PAGE_SIZE - 1] == 0, "the anonymous mapping starts zeroed");
+    map[PAGE_SIZE] = 'x';
+    check(map[PAGE_SIZE] == 'x', "the anonymous mapping is writable");
+    check(munmap(map, 2 * PAGE_SIZE) == 0, "munmap the anonymous mapping");
+  }
+}
+
+void testMsync()
+{
+  int fd = create("/usr/msync.dat");
+  check(fd >= 0, "create /usr/msync.dat");
+  if (fd < 0)
+    return;
+
+  check(write(fd, zeros, PAGE_SIZE) == PAGE_SIZE, "fill /usr/msync.dat");
+  char* map = mmap(0, PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  check(map != MAP_FAILED, "mmap MAP_SHARED on minix");
+  if (map != MAP_FAILED)
+  {
+    memcpy(map + 200, "synced", 7);
+    check(msync(map, PAGE_SIZE, MS_SYNC) == 0, "msync");
+    check(munmap(map, PAGE_SIZE) == 0, "munmap /usr/msync.dat");
+  }
+  close(fd);
+
+  fd = open("/usr/msync.dat", O_RDONLY);
+  memset(buffer, 0, 16);
+  check(fd >= 0 && pread(fd, buffer, 16, 200) == 16 && strcmp(buffer, "synced") == 0,
+        "read sees the data written back by msync");
+  close(fd);
+  unlink("/usr/msync.dat");
+}
+
+int main()
+{
+  testHoles();
+  testSharedTmp();
+  testPrivate();
+  testMsync();
+  printf("filetest: %d checks failed\n", failed);
+  return failed;
+}
@@ -55,7 +55,8 @@ void handle_command(char* buffer, int buffer_size)
   else if (buffer[0] == 'h' && buffer[1] == 'e' && buffer[2] == 'l' && buffer[3] == 'p')
   {
     printf(
-        "Command Help:\nhelp                  yes, here we are\nexit [exit_code]      is really the only command that does something right now\nls                    pseudo ls\n\n");
+        "Command Help:\nhelp                  yes, here we are\nexit [exit_code]      is really the only command that does something right now\nls                    pseudo ls\n"
+        "profile start [period]|stop|print|reset   sampling profiler, print goes to the debug output\n\n");
   }
   else if (strcmp(command, "exit") == 0)
   {
@@ -66,6 +67,20 @@ void handle_command(char* buffer, int buffer_size)
     printf("Exiting Shell with exit_code %d\n", exit_code);
     running = 0;
   }
+  else if (strcmp(command, "profile") == 0)
+  {
+    int result = -1;
+    if (argsCount > 0 && strcmp(args[0], "start") == 0)
+      result = profile(PROFILE_START, argsCount > 1 ? atoi(args[1]) : 1);
+    else if (argsCount > 0 && strcmp(args[0], "stop") == 0)
+      result = profile(PROFILE_STOP, 0);
+    else if (argsCount > 0 && strcmp(args[0], "print") == 0)
+      result = profile(PROFILE_PRINT, 0);
+    else if (argsCount > 0 && strcmp(args[0], "reset") == 0)
+      result = profile(PROFILE_RESET, 0);
+    if (result == -1)
+      printf("usage: profile start [period]|stop|print|reset\n");
+  }
   else if (FORK_ENABLED)
   {
     pid = fork();
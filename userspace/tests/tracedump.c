@@ -0,0 +1,45 @@
+#include "unistd.h"
+#include "stdio.h"
+#include "fcntl.h"
+
+/*
+ * copies the binary trace records from /dev/trace to /usr/trace.bin, decode them on the host with
+ * utils/tracedecode/tracedecode <kernel.x> trace.bin
+ */
+
+#define RECORD_SIZE 128
+
+char buffer[32 * RECORD_SIZE];
+
+int main()
+{
+  int in = open("/dev/trace", O_RDONLY);
+  if (in < 0)
+  {
+    printf("tracedump: could not open /dev/trace\n");
+    return -1;
+  }
+
+  // files created by open are only writable after reopening them
+  close(open("/usr/trace.bin", O_CREAT | O_WRONLY));
+  int out = open("/usr/trace.bin", O_WRONLY);
+  if (out < 0)
+  {
+    printf("tracedump: could not open /usr/trace.bin\n");
+    close(in);
+    return -1;
+  }
+
+  int total = 0;
+  int n;
+  while ((n = read(in, buffer, sizeof(buffer))) > 0)
+  {
+    write(out, buffer, n);
+    total += n;
+  }
+
+  printf("tracedump: %d records written to /usr/trace.bin\n", total / RECORD_SIZE);
+  close(out);
+  close(in);
+  return 0;
+}
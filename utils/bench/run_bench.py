@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+#
+# run_bench.py
+# boots the SWEB image headless in qemu, collects the BENCH lines printed to the
+# debug port and compares them against a stored baseline
+#
+# select what runs before building the image:
+#   kernel benchmarks:    common/include/kernel/kernel_benchmarks.h
+#   userspace benchmarks: "/usr/bench.sweb" in common/include/kernel/user_progs.h
+#
+# usage, from the build directory:
+#   run_bench.py                      run and compare with the baseline
+#   run_bench.py --save-baseline      run and store the results as the new baseline
+#   run_bench.py --sections 2         kernel and userspace benchmarks, wait for both BENCH_END
+#
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import time
+
+BENCH_LINE = re.compile(r"^BENCH (\S+)((?: \w+=\d+)*)\s*$")
+
+QEMU = {
+  "x86/32": ["qemu-system-i386", "-cpu", "qemu32"],
+  "x86/32/pae": ["qemu-system-i386", "-cpu", "qemu32"],
+  "x86/64": ["qemu-system-x86_64", "-cpu", "qemu64"],
+}
+
+
+def build_arch(build_dir):
+  try:
+    with open(os.path.join(build_dir, "CMakeCache.txt")) as cache:
+      for line in cache:
+        if line.startswith("ARCH:"):
+          return line.split("=", 1)[1].strip()
+  except IOError:
+    pass
+  return "x86/32"
+
+
+def run_qemu(build_dir, arch, timeout, sections, log):
+  if arch not in QEMU:
+    sys.exit("run_bench: no qemu command for %s" % arch)
+  image = os.path.join(build_dir, "SWEB-flat.vmdk")
+  if not os.path.exists(image):
+    sys.exit("run_bench: %s not found, build the image first" % image)
+
+  command = QEMU[arch] + ["-m", "8M", "-drive", "file=%s,index=0,media=disk,format=raw" % image,
+                          "-debugcon", "stdio", "-display", "none", "-snapshot", "-no-reboot"]
+  qemu = subprocess.Popen(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, stdin=subprocess.DEVNULL)
+  os.set_blocking(qemu.stdout.fileno(), False)
+
+  lines = []
+  pending = b""
+  ended = 0
+  deadline = time.time() + timeout
+  try:
+    while ended < sections and time.time() < deadline and qemu.poll() is None:
+      chunk = qemu.stdout.read()
+      if not chunk:
+        time.sleep(0.05)
+        continue
+      pending += chunk
+      *complete, pending = pending.split(b"\n")
+      for line in complete:
+        line = line.decode("ascii", "replace").rstrip("\r")
+        if log:
+          log.write(line + "\n")
+        lines.append(line)
+        if line == "BENCH_END":
+          ended += 1
+  finally:
+    qemu.kill()
+    qemu.wait()
+
+  if ended < sections:
+    print("run_bench: only %d of %d BENCH_END markers seen, results are incomplete" % (ended, sections),
+          file=sys.stderr)
+  return lines
+
+
+def parse(lines):
+  results = {}
+  for line in lines:
+    match = BENCH_LINE.match(line.strip())
+    if not match:
+      continue
+    values = dict((key, int(value)) for key, value in re.findall(r"(\w+)=(\d+)", match.group(2)))
+    if "per_iteration" in values:
+      results[match.group(1)] = values
+  return results
+
+
+def read_results(path):
+  with open(path) as results:
+    return parse(results.readlines())
+
+
+def write_results(path, results):
+  with open(path, "w") as output:
+    for name in sorted(results):
+      values = results[name]
+      output.write("BENCH %s %s\n" % (name, " ".join("%s=%d" % (key, values[key]) for key in values)))
+
+
+def compare(baseline, current, threshold):
+  regressions = 0
+  print("%-32s %14s %14s %9s" % ("benchmark", "baseline", "current", "change"))
+  for name in sorted(set(baseline) | set(current)):
+    old = baseline.get(name, {}).get("per_iteration")
+    new = current.get(name, {}).get("per_iteration")
+    if old is None or new is None:
+      print("%-32s %14s %14s %9s" % (name, old if old is not None else "-", new if new is not None else "-",
+                                    "new" if old is None else "missing"))
+      continue
+    change = (new - old) * 100.0 / old if old else 0.0
+    marker = ""
+    if change > threshold:
+      marker = "  slower"
+      regressions += 1
+    elif change < -threshold:
+      marker = "  faster"
+    print("%-32s %14d %14d %+8.1f%%%s" % (name, old, new, change, marker))
+  return regressions
+
+
+def main():
+  here = os.path.dirname(os.path.abspath(__file__))
+  parser = argparse.ArgumentParser(description="run the SWEB benchmarks in qemu and compare against a baseline")
+  parser.add_argument("--build-dir", default=".", help="directory containing SWEB-flat.vmdk (default: .)")
+  parser.add_argument("--arch", help="qemu to use, default: ARCH from the CMakeCache of the build directory")
+  parser.add_argument("--baseline", help="baseline file (default: utils/bench/baseline-<arch>.txt)")
+  parser.add_argument("--save-baseline", action="store_true", help="store the results as the new baseline")
+  parser.add_argument("--input", help="parse an existing debug log instead of booting qemu")
+  parser.add_argument("--output", help="also write the results to this file")
+  parser.add_argument("--log", help="write the whole debug output to this file")
+  parser.add_argument("--sections", type=int, default=1, help="number of BENCH_END markers to wait for (default: 1)")
+  parser.add_argument("--timeout", type=int, default=600, help="seconds until qemu is killed (default: 600)")
+  parser.add_argument("--threshold", type=float, default=10.0,
+                      help="percentage from which a change is reported as slower/faster (default: 10)")
+  args = parser.parse_args()
+
+  arch = args.arch or build_arch(args.build_dir)
+  baseline_path = args.baseline or os.path.join(here, "baseline-%s.txt" % arch.replace("/", "-"))
+
+  if args.input:
+    current = read_results(args.input)
+  else:
+    log = open(args.log, "w") if args.log else None
+    try:
+      current = parse(run_qemu(args.build_dir, arch, args.timeout, args.sections, log))
+    finally:
+      if log:
+        log.close()
+
+  if not current:
+    sys.exit("run_bench: no benchmark results, are benchmarks selected in kernel_benchmarks.h or user_progs.h?")
+  if args.output:
+    write_results(args.output, current)
+  if args.save_baseline:
+    write_results(baseline_path, current)
+    print("run_bench: %d results stored in %s" % (len(current), baseline_path))
+    return 0
+
+  if not os.path.exists(baseline_path):
+    write_results(baseline_path, current)
+    print("run_bench: no baseline yet, %d results stored in %s" % (len(current), baseline_path))
+    return 0
+
+  regressions = compare(read_results(baseline_path), current, args.threshold)
+  return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+  sys.exit(main())
@@ -0,0 +1,279 @@
+/**
+ * @file tracedecode.cpp
+ *
+ * formats the binary records read from /dev/trace (see common/include/console/Trace.h)
+ * on the host, the format strings and flag names are looked up in the kernel binary
+ */
+
+#include <elf.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#define TRACE_MAX_ARGS 10
+
+// has to match TraceRecord in common/include/console/Trace.h
+struct TraceRecord
+{
+  uint64_t sequence;
+  uint64_t timestamp;
+  uint64_t format;
+  uint64_t flag_name;
+  uint64_t thread;
+  uint32_t flag;
+  uint32_t num_args;
+  uint64_t args[TRACE_MAX_ARGS];
+};
+
+static_assert(sizeof(TraceRecord) == 128, "TraceRecord layout differs from the kernel");
+
+struct Section
+{
+  uint64_t address;
+  std::vector<char> data;
+};
+
+static std::vector<Section> sections;
+static bool kernel_64bit;
+
+static bool readFile(const char* path, std::vector<char>& content)
+{
+  FILE* file = fopen(path, "rb");
+  if (!file)
+    return false;
+  char buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    content.insert(content.end(), buffer, buffer + n);
+  fclose(file);
+  return true;
+}
+
+template<typename Ehdr, typename Shdr>
+static bool loadSections(const std::vector<char>& elf)
+{
+  if (elf.size() < sizeof(Ehdr))
+    return false;
+  const Ehdr* header = (const Ehdr*) elf.data();
+  for (size_t i = 0; i < header->e_shnum; ++i)
+  {
+    size_t offset = header->e_shoff + i * header->e_shentsize;
+    if (offset + sizeof(Shdr) > elf.size())
+      return false;
+    const Shdr* section = (const Shdr*) (elf.data() + offset);
+    if (!(section->sh_flags & SHF_ALLOC) || section->sh_type != SHT_PROGBITS)
+      continue;
+    if (section->sh_offset + section->sh_size > elf.size())
+      return false;
+    Section s;
+    s.address = section->sh_addr;
+    s.data.assign(elf.data() + section->sh_offset, elf.data() + section->sh_offset + section->sh_size);
+    sections.push_back(s);
+  }
+  return true;
+}
+
+static bool loadKernel(const char* path)
+{
+  std::vector<char> elf;
+  if (!readFile(path, elf) || elf.size() < EI_NIDENT || memcmp(elf.data(), ELFMAG, SELFMAG) != 0)
+    return false;
+  kernel_64bit = (elf[EI_CLASS] == ELFCLASS64);
+  if (kernel_64bit)
+    return loadSections<Elf64_Ehdr, Elf64_Shdr>(elf);
+  return loadSections<Elf32_Ehdr, Elf32_Shdr>(elf);
+}
+
+/**
+ * @return the string at the kernel address, 0 if it is not part of the kernel binary
+ */
+static const char* kernelString(uint64_t address)
+{
+  for (const Section& s : sections)
+  {
+    if (address < s.address || address >= s.address + s.data.size())
+      continue;
+    const char* string = s.data.data() + (address - s.address);
+    if (!memchr(string, 0, s.data.size() - (address - s.address)))
+      return 0;
+    return string;
+  }
+  return 0;
+}
+
+/**
+ * converts an argument according to the length modifier of the conversion
+ */
+static uint64_t argumentValue(uint64_t value, const std::string& length, bool is_signed)
+{
+  size_t bits = 32;
+  if (length == "ll" || length == "j" || length == "q")
+    bits = 64;
+  else if (length == "l" || length == "z" || length == "t")
+    bits = kernel_64bit ? 64 : 32;
+  else if (length == "h")
+    bits = 16;
+  else if (length == "hh")
+    bits = 8;
+  if (bits == 64)
+    return value;
+  uint64_t mask = (1ULL << bits) - 1;
+  value &= mask;
+  if (is_signed && (value >> (bits - 1)))
+    value |= ~mask;
+  return value;
+}
+
+static std::string format(const TraceRecord& record)
+{
+  const char* fmt = kernelString(record.format);
+  char buffer[512];
+  if (!fmt)
+  {
+    snprintf(buffer, sizeof(buffer), "<format at 0x%llx>\n", (unsigned long long) record.format);
+    return buffer;
+  }
+
+  size_t stored = record.num_args < TRACE_MAX_ARGS ? record.num_args : TRACE_MAX_ARGS;
+  size_t next_arg = 0;
+  std::string result;
+  for (const char* c = fmt; *c; ++c)
+  {
+    if (*c != '%')
+    {
+      result += *c;
+      continue;
+    }
+    const char* start = c++;
+    std::string spec = "%";
+    while (*c && strchr("-+ #0", *c))
+      spec += *c++;
+    while (*c == '*' || (*c >= '0' && *c <= '9') || *c == '.')
+    {
+      if (*c == '*')
+      {
+        spec += std::to_string((int) (next_arg < stored ? record.args[next_arg] : 0));
+        ++next_arg;
+        ++c;
+      }
+      else
+        spec += *c++;
+    }
+    std::string length;
+    while (*c && strchr("hlqjzt", *c))
+      length += *c++;
+    if (!*c)
+    {
+      result += start;
+      break;
+    }
+    char conversion = *c;
+    if (conversion == '%')
+    {
+      result += '%';
+      continue;
+    }
+    if (!strchr("diouxXcsp", conversion))
+    {
+      result.append(start, c + 1);
+      continue;
+    }
+    if (next_arg >= stored)
+    {
+      result += "<?>";
+      ++next_arg;
+      continue;
+    }
+    uint64_t value = record.args[next_arg++];
+    switch (conversion)
+    {
+      case 'd':
+      case 'i':
+        spec += "lld";
+        snprintf(buffer, sizeof(buffer), spec.c_str(), (long long) argumentValue(value, length, true));
+        break;
+      case 'o':
+      case 'u':
+      case 'x':
+      case 'X':
+        spec += "ll";
+        spec += conversion;
+        snprintf(buffer, sizeof(buffer), spec.c_str(), (unsigned long long) argumentValue(value, length, false));
+        break;
+      case 'c':
+        spec += 'c';
+        snprintf(buffer, sizeof(buffer), spec.c_str(), (int) (value & 0xFF));
+        break;
+      case 'p':
+        snprintf(buffer, sizeof(buffer), "0x%llx", (unsigned long long) value);
+        break;
+      default:
+      {
+        const char* string = kernelString(value);
+        std::string unresolved;
+        if (!string)
+        {
+          char address[32];
+          snprintf(address, sizeof(address), "<0x%llx>", (unsigned long long) value);
+          unresolved = address;
+          string = unresolved.c_str();
+        }
+        spec += 's';
+        snprintf(buffer, sizeof(buffer), spec.c_str(), string);
+        break;
+      }
+    }
+    result += buffer;
+  }
+  if (record.num_args > TRACE_MAX_ARGS)
+    result += " <arguments truncated>";
+  if (result.empty() || result[result.size() - 1] != '\n')
+    result += '\n';
+  return result;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc != 3)
+  {
+    printf("Syntax: %s <kernel binary> <trace file read from /dev/trace>\n", argv[0]);
+    return -1;
+  }
+
+  if (!loadKernel(argv[1]))
+  {
+    printf("Error reading the kernel binary %s\n", argv[1]);
+    return -1;
+  }
+
+  std::vector<char> trace;
+  if (!readFile(argv[2], trace))
+  {
+    printf("Error opening %s\n", argv[2]);
+    return -1;
+  }
+
+  size_t count = trace.size() / sizeof(TraceRecord);
+  uint64_t first_timestamp = 0;
+  uint64_t last_sequence = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    TraceRecord record;
+    memcpy(&record, trace.data() + i * sizeof(TraceRecord), sizeof(TraceRecord));
+    if (i == 0)
+      first_timestamp = record.timestamp;
+    else if (record.sequence != last_sequence + 1)
+      printf("--- %llu records lost ---\n", (unsigned long long) (record.sequence - last_sequence - 1));
+    last_sequence = record.sequence;
+
+    const char* flag_name = kernelString(record.flag_name);
+    printf("%12llu %18llx [%-11s] %s", (unsigned long long) (record.timestamp - first_timestamp),
+           (unsigned long long) record.thread, flag_name ? flag_name : "?", format(record).c_str());
+  }
+  if (trace.size() % sizeof(TraceRecord))
+    printf("--- %zu trailing bytes ignored ---\n", trace.size() % sizeof(TraceRecord));
+  return 0;
+}